@@ -117,6 +117,62 @@ macro(integration_benchmark name)
   set_property(GLOBAL APPEND PROPERTY COUCHBASE_BENCHMARKS "benchmark_integration_${name}")
 endmacro()
 
+macro(unit_benchmark name)
+  add_executable(benchmark_unit_${name} "${PROJECT_SOURCE_DIR}/test/benchmark_unit_${name}.cxx")
+  target_include_directories(benchmark_unit_${name} PRIVATE ${PROJECT_BINARY_DIR}/generated)
+  target_link_libraries(
+    benchmark_unit_${name}
+    project_options
+    project_warnings
+    Catch2::Catch2WithMain
+    Threads::Threads
+    snappy
+    couchbase_cxx_client
+    test_utils)
+  catch_discover_tests(
+    benchmark_unit_${name}
+    PROPERTIES
+    SKIP_REGULAR_EXPRESSION
+    "SKIP"
+    LABELS
+    "benchmark")
+  set_property(GLOBAL APPEND PROPERTY COUCHBASE_BENCHMARKS "benchmark_unit_${name}")
+endmacro()
+
+option(COUCHBASE_CXX_CLIENT_REQUIRE_CXX20_TESTS "Fail if the tests of the C++20 awaitable API cannot be built" FALSE)
+
+# The library is built as C++17, but the awaitable overloads of the public API are only declared for C++20 with coroutines,
+# so they are tested by the separate target test_unit_awaitable.
+try_compile(
+  COUCHBASE_CXX_CLIENT_CXX20_COROUTINES ${CMAKE_CURRENT_BINARY_DIR}
+  ${PROJECT_SOURCE_DIR}/cmake/test_coroutines.cxx
+  CXX_STANDARD 20)
+set(COUCHBASE_CXX_CLIENT_CXX20_COROUTINES_FLAGS "")
+if(NOT COUCHBASE_CXX_CLIENT_CXX20_COROUTINES AND CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+  # GCC 10 needs the coroutines to be enabled explicitly
+  try_compile(
+    COUCHBASE_CXX_CLIENT_CXX20_FCOROUTINES ${CMAKE_CURRENT_BINARY_DIR}
+    ${PROJECT_SOURCE_DIR}/cmake/test_coroutines.cxx
+    COMPILE_DEFINITIONS -fcoroutines CXX_STANDARD 20)
+  if(COUCHBASE_CXX_CLIENT_CXX20_FCOROUTINES)
+    set(COUCHBASE_CXX_CLIENT_CXX20_COROUTINES TRUE)
+    set(COUCHBASE_CXX_CLIENT_CXX20_COROUTINES_FLAGS "-fcoroutines")
+  endif()
+endif()
+if(COUCHBASE_CXX_CLIENT_CXX20_COROUTINES)
+  message(STATUS "C++20 coroutines are supported, will build test_unit_awaitable")
+elseif(COUCHBASE_CXX_CLIENT_REQUIRE_CXX20_TESTS)
+  message(FATAL_ERROR "The compiler does not support C++20 coroutines, cannot build test_unit_awaitable")
+else()
+  message(STATUS "The compiler does not support C++20 coroutines, will not build test_unit_awaitable")
+endif()
+
+macro(unit_test_cxx20 name)
+  unit_test(${name})
+  set_target_properties(test_unit_${name} PROPERTIES CXX_STANDARD 20)
+  target_compile_options(test_unit_${name} PRIVATE ${COUCHBASE_CXX_CLIENT_CXX20_COROUTINES_FLAGS})
+endmacro()
+
 add_subdirectory(${PROJECT_SOURCE_DIR}/test)
 
 get_property(integration_targets GLOBAL PROPERTY COUCHBASE_INTEGRATION_TESTS)
@@ -0,0 +1,45 @@
+#include <coroutine>
+
+#ifndef __cpp_impl_coroutine
+#error "the compiler does not implement C++20 coroutines"
+#endif
+
+struct task {
+    struct promise_type {
+        task get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+        }
+    };
+};
+
+task
+run()
+{
+    co_await std::suspend_never{};
+}
+
+int
+main()
+{
+    run();
+    return 0;
+}
@@ -22,6 +22,7 @@
 #include "core/mcbp/codec.hxx"
 #include "dispatcher.hxx"
 #include "impl/bootstrap_state_listener.hxx"
+#include "io/parallel_bootstrap.hxx"
 #include "mcbp/operation_queue.hxx"
 #include "mcbp/queue_request.hxx"
 #include "mcbp/queue_response.hxx"
@@ -392,30 +393,56 @@ class bucket_impl
         if (state_listener_) {
             state_listener_->register_config_listener(shared_from_this());
         }
-        io::mcbp_session new_session = origin_.options().enable_tls
-                                         ? io::mcbp_session(client_id_, ctx_, tls_, origin_, state_listener_, name_, known_features_)
-                                         : io::mcbp_session(client_id_, ctx_, origin_, state_listener_, name_, known_features_);
+        if (origin_.options().enable_parallel_bootstrap && origin_.get_node_list().size() > 1) {
+            return io::parallel_bootstrap(
+              origin_,
+              [self = shared_from_this()](origin node_origin) { return self->make_session(std::move(node_origin)); },
+              [self = shared_from_this(), h = std::move(handler)](
+                std::error_code ec, topology::configuration cfg, std::optional<io::mcbp_session> session) mutable {
+                  if (ec) {
+                      CB_LOG_WARNING(
+                        R"({} failed to bootstrap sessions in parallel ec={}, bucket="{}")", self->log_prefix_, ec.message(), self->name_);
+                  } else {
+                      self->add_bootstrapped_session(std::move(session.value()), cfg);
+                  }
+                  asio::post(asio::bind_executor(self->ctx_, [h = std::move(h), ec, cfg = std::move(cfg)]() mutable { h(ec, cfg); }));
+              });
+        }
+        io::mcbp_session new_session = make_session(origin_);
         new_session.bootstrap([self = shared_from_this(), new_session, h = std::move(handler)](std::error_code ec,
                                                                                                topology::configuration cfg) mutable {
             if (ec) {
                 CB_LOG_WARNING(R"({} failed to bootstrap session ec={}, bucket="{}")", new_session.log_prefix(), ec.message(), self->name_);
                 self->remove_session(new_session.id());
             } else {
-                const std::size_t this_index = new_session.index();
-                new_session.on_configuration_update(self);
-                new_session.on_stop([id = new_session.id(), self]() { self->remove_session(id); });
-
-                {
-                    std::scoped_lock lock(self->sessions_mutex_);
-                    self->sessions_.insert_or_assign(this_index, std::move(new_session));
-                }
-                self->update_config(cfg);
-                self->drain_deferred_queue();
+                self->add_bootstrapped_session(std::move(new_session), cfg);
             }
             asio::post(asio::bind_executor(self->ctx_, [h = std::move(h), ec, cfg = std::move(cfg)]() mutable { h(ec, cfg); }));
         });
     }
 
+    io::mcbp_session make_session(origin session_origin)
+    {
+        if (origin_.options().enable_tls) {
+            return io::mcbp_session(client_id_, ctx_, tls_, std::move(session_origin), state_listener_, name_, known_features_);
+        }
+        return io::mcbp_session(client_id_, ctx_, std::move(session_origin), state_listener_, name_, known_features_);
+    }
+
+    void add_bootstrapped_session(io::mcbp_session new_session, const topology::configuration& cfg)
+    {
+        const std::size_t this_index = new_session.index();
+        new_session.on_configuration_update(shared_from_this());
+        new_session.on_stop([id = new_session.id(), self = shared_from_this()]() { self->remove_session(id); });
+
+        {
+            std::scoped_lock lock(sessions_mutex_);
+            sessions_.insert_or_assign(this_index, std::move(new_session));
+        }
+        update_config(cfg);
+        drain_deferred_queue();
+    }
+
     void with_configuration(utils::movable_function<void(std::error_code, topology::configuration)>&& handler)
     {
         if (closed_) {
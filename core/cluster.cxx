@@ -101,6 +101,8 @@ cluster::configure_tls_options(bool has_capella_host)
             tls_.set_verify_mode(asio::ssl::verify_peer);
             break;
     }
+    // KV and HTTP connections share the context, so they all resume sessions negotiated by any of them
+    tls_sessions_.attach(tls_.native_handle());
 
 #ifdef COUCHBASE_CXX_CLIENT_TLS_KEY_LOG_FILE
     SSL_CTX_set_keylog_callback(tls_.native_handle(), [](const SSL* /* ssl */, const char* line) {
@@ -18,11 +18,12 @@
 #pragma once
 
 #include "bucket.hxx"
-#include "capella_ca.hxx"
 #include "core/io/http_command.hxx"
 #include "core/io/http_session_manager.hxx"
 #include "core/io/mcbp_command.hxx"
 #include "core/io/mcbp_session.hxx"
+#include "core/io/parallel_bootstrap.hxx"
+#include "core/io/tls_session_cache.hxx"
 #include "core/metrics/logging_meter.hxx"
 #include "core/metrics/noop_meter.hxx"
 #include "core/operations/management/bucket_create.hxx"
@@ -30,10 +31,10 @@
 #include "core/tracing/threshold_logging_tracer.hxx"
 #include "core/utils/join_strings.hxx"
 #include "crud_component.hxx"
+#include "default_trust_store.hxx"
 #include "diagnostics.hxx"
 #include "dispatcher.hxx"
 #include "impl/dns_srv_tracker.hxx"
-#include "mozilla_ca_bundle.hxx"
 #include "operations.hxx"
 #include "origin.hxx"
 
@@ -53,6 +54,10 @@ class cluster : public std::enable_shared_from_this<cluster>
     {
         return ctx_;
     }
+    [[nodiscard]] auto meter() const -> std::shared_ptr<couchbase::metrics::meter>
+    {
+        return meter_;
+    }
     [[nodiscard]] static std::shared_ptr<cluster> create(asio::io_context& ctx)
     {
         return std::shared_ptr<cluster>(new cluster(ctx));
@@ -182,7 +187,7 @@ class cluster : public std::enable_shared_from_this<cluster>
                 std::scoped_lock lock(self->buckets_mutex_);
                 self->buckets_.erase(bucket_name);
             } else if (self->session_ && !self->session_->supports_gcccp()) {
-                self->session_manager_->set_configuration(config, self->origin_.options());
+                self->session_manager_->set_configuration(config, self->origin_.options(), self->origin_.credentials());
             }
             handler(ec);
         });
@@ -285,6 +290,10 @@ class cluster : public std::enable_shared_from_this<cluster>
             }
             self->for_each_bucket([&res](const auto& bucket) { bucket->export_diag_info(res); });
             self->session_manager_->export_diag_info(res);
+            if (self->origin_.options().enable_tls) {
+                auto stats = self->tls_sessions_.statistics();
+                res.tls_sessions = diag::tls_session_info{ stats.hits, stats.misses };
+            }
             handler(std::move(res));
         }));
     }
@@ -381,35 +390,11 @@ class cluster : public std::enable_shared_from_this<cluster>
             if (origin_.options().trust_certificate.empty() &&
                 origin_.options().trust_certificate_value.empty()) { // trust certificate is not explicitly specified
                 CB_LOG_DEBUG(R"([{}]: use default CA for TLS verify)", id_);
-                std::error_code ec{};
-
-                // load system certificates
-                tls_.set_default_verify_paths(ec);
-                if (ec) {
-                    CB_LOG_WARNING(R"([{}]: failed to load system CAs: {})", id_, ec.message());
-                }
-
-                // add the Capella Root CA in addition to system CAs
-                tls_.add_certificate_authority(
-                  asio::const_buffer(couchbase::core::default_ca::capellaCaCert, strlen(couchbase::core::default_ca::capellaCaCert)), ec);
-                if (ec) {
-                    CB_LOG_WARNING("[{}]: unable to load default CAs: {}", id_, ec.message());
-                    // we don't consider this fatal and try to continue without it
-                }
-
-                if (const auto certificates = default_ca::mozilla_ca_certs();
-                    !origin_.options().disable_mozilla_ca_certificates && !certificates.empty()) {
-                    CB_LOG_DEBUG("[{}]: loading {} CA certificates from Mozilla bundle. Update date: \"{}\", SHA256: \"{}\"",
-                                 id_,
-                                 certificates.size(),
-                                 default_ca::mozilla_ca_certs_date(),
-                                 default_ca::mozilla_ca_certs_sha256());
-                    for (const auto& cert : certificates) {
-                        tls_.add_certificate_authority(asio::const_buffer(cert.body.data(), cert.body.size()), ec);
-                        if (ec) {
-                            CB_LOG_WARNING("[{}]: unable to load CA \"{}\" from Mozilla bundle: {}", id_, cert.authority, ec.message());
-                        }
-                    }
+                // system CAs, Capella Root CA and Mozilla bundle are parsed once, and shared by all clusters of the process
+                if (auto* store = default_ca::default_trust_store(!origin_.options().disable_mozilla_ca_certificates); store != nullptr) {
+                    SSL_CTX_set_cert_store(tls_.native_handle(), store);
+                } else {
+                    CB_LOG_WARNING("[{}]: unable to load default CAs", id_);
                 }
             } else { // trust certificate is explicitly specified
                 std::error_code ec{};
@@ -448,59 +433,82 @@ class cluster : public std::enable_shared_from_this<cluster>
                     return close([ec, handler = std::forward<Handler>(handler)]() mutable { return handler(ec); });
                 }
             }
-            session_ = io::mcbp_session(id_, ctx_, tls_, origin_, dns_srv_tracker_);
-        } else {
-            session_ = io::mcbp_session(id_, ctx_, origin_, dns_srv_tracker_);
         }
+        if (origin_.options().enable_parallel_bootstrap && origin_.get_node_list().size() > 1) {
+            return io::parallel_bootstrap(
+              origin_,
+              [self = shared_from_this()](origin node_origin) { return self->make_session(std::move(node_origin)); },
+              [self = shared_from_this(), handler = std::forward<Handler>(handler)](
+                std::error_code ec, const topology::configuration& config, std::optional<io::mcbp_session> session) mutable {
+                  self->session_ = std::move(session);
+                  self->on_session_bootstrap(ec, config, std::forward<Handler>(handler));
+              });
+        }
+        session_ = make_session(origin_);
         session_->bootstrap([self = shared_from_this(),
                              handler = std::forward<Handler>(handler)](std::error_code ec, const topology::configuration& config) mutable {
-            if (!ec) {
-                if (self->origin_.options().network == "auto") {
-                    self->origin_.options().network = config.select_network(self->session_->bootstrap_hostname());
-                    if (self->origin_.options().network == "default") {
-                        CB_LOG_DEBUG(R"({} detected network is "{}")", self->session_->log_prefix(), self->origin_.options().network);
-                    } else {
-                        CB_LOG_INFO(R"({} detected network is "{}")", self->session_->log_prefix(), self->origin_.options().network);
-                    }
+            self->on_session_bootstrap(ec, config, std::forward<Handler>(handler));
+        });
+    }
+
+    io::mcbp_session make_session(origin session_origin)
+    {
+        if (origin_.options().enable_tls) {
+            return io::mcbp_session(id_, ctx_, tls_, std::move(session_origin), dns_srv_tracker_);
+        }
+        return io::mcbp_session(id_, ctx_, std::move(session_origin), dns_srv_tracker_);
+    }
+
+    template<typename Handler>
+    void on_session_bootstrap(std::error_code ec, const topology::configuration& config, Handler&& handler)
+    {
+        if (!ec) {
+            if (origin_.options().network == "auto") {
+                origin_.options().network = config.select_network(session_->bootstrap_hostname());
+                if (origin_.options().network == "default") {
+                    CB_LOG_DEBUG(R"({} detected network is "{}")", session_->log_prefix(), origin_.options().network);
+                } else {
+                    CB_LOG_INFO(R"({} detected network is "{}")", session_->log_prefix(), origin_.options().network);
                 }
-                if (self->origin_.options().network != "default") {
-                    origin::node_list nodes;
-                    nodes.reserve(config.nodes.size());
-                    for (const auto& address : config.nodes) {
-                        auto port =
-                          address.port_or(self->origin_.options().network, service_type::key_value, self->origin_.options().enable_tls, 0);
-                        if (port == 0) {
-                            continue;
-                        }
-                        origin::node_entry node;
-                        node.first = address.hostname_for(self->origin_.options().network);
-                        node.second = std::to_string(port);
-                        nodes.emplace_back(node);
+            }
+            if (origin_.options().network != "default") {
+                origin::node_list nodes;
+                nodes.reserve(config.nodes.size());
+                for (const auto& address : config.nodes) {
+                    auto port = address.port_or(origin_.options().network, service_type::key_value, origin_.options().enable_tls, 0);
+                    if (port == 0) {
+                        continue;
                     }
-                    self->origin_.set_nodes(nodes);
-                    CB_LOG_INFO("replace list of bootstrap nodes with addresses of alternative network \"{}\": [{}]",
-                                self->origin_.options().network,
-                                utils::join_strings(self->origin_.get_nodes(), ","));
+                    origin::node_entry node;
+                    node.first = address.hostname_for(origin_.options().network);
+                    node.second = std::to_string(port);
+                    nodes.emplace_back(node);
                 }
-                self->session_manager_->set_configuration(config, self->origin_.options());
-                self->session_->on_configuration_update(self->session_manager_);
-                self->session_->on_stop([self]() {
-                    if (self->session_) {
-                        self->session_.reset();
-                    }
-                });
+                origin_.set_nodes(nodes);
+                CB_LOG_INFO("replace list of bootstrap nodes with addresses of alternative network \"{}\": [{}]",
+                            origin_.options().network,
+                            utils::join_strings(origin_.get_nodes(), ","));
             }
-            if (ec) {
-                return self->close([ec, handler = std::forward<Handler>(handler)]() mutable { handler(ec); });
-            }
-            handler(ec);
-        });
+            session_manager_->set_configuration(config, origin_.options(), origin_.credentials());
+            session_->on_configuration_update(session_manager_);
+            session_->on_stop([self = shared_from_this()]() {
+                if (self->session_) {
+                    self->session_.reset();
+                }
+            });
+        }
+        if (ec) {
+            return close([ec, handler = std::forward<Handler>(handler)]() mutable { handler(ec); });
+        }
+        handler(ec);
     }
 
     std::string id_{ uuid::to_string(uuid::random()) };
     asio::io_context& ctx_;
     asio::executor_work_guard<asio::io_context::executor_type> work_;
     asio::ssl::context tls_{ asio::ssl::context::tls_client };
+    // declared after the TLS context, so that it is detached before the context goes away
+    io::tls_session_cache tls_sessions_{};
     std::shared_ptr<io::http_session_manager> session_manager_;
     std::optional<io::mcbp_session> session_{};
     std::shared_ptr<impl::dns_srv_tracker> dns_srv_tracker_{};
@@ -23,6 +23,7 @@
 #include "core/tracing/threshold_logging_options.hxx"
 #include "core/transactions/attempt_context_testing_hooks.hxx"
 #include "core/transactions/cleanup_testing_hooks.hxx"
+#include "http_node_selection_policy.hxx"
 #include "service_type.hxx"
 #include "timeout_defaults.hxx"
 #include "tls_verify_mode.hxx"
@@ -58,6 +59,7 @@ struct cluster_options {
     bool enable_tcp_keep_alive{ true };
     io::ip_protocol use_ip_protocol{ io::ip_protocol::any };
     bool enable_dns_srv{ true };
+    bool enable_parallel_bootstrap{ false };
     io::dns::dns_config dns_config{ io::dns::dns_config::system_config() };
     bool show_queries{ false };
     bool enable_unordered_execution{ true };
@@ -79,6 +81,9 @@ struct cluster_options {
     std::chrono::milliseconds config_idle_redial_timeout = timeout_defaults::config_idle_redial_timeout;
 
     std::size_t max_http_connections{ 0 };
+    std::size_t min_idle_http_connections{ 0 };
+    http_node_selection_policy http_node_selection{ http_node_selection_policy::round_robin };
+    bool enable_http_pipelining{ false };
     std::chrono::milliseconds idle_http_connection_timeout = timeout_defaults::idle_http_connection_timeout;
     std::string user_agent_extra{};
     couchbase::transactions::transactions_config::built transactions{};
@@ -0,0 +1,118 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "default_trust_store.hxx"
+
+#include "capella_ca.hxx"
+#include "core/logger/logger.hxx"
+#include "mozilla_ca_bundle.hxx"
+
+#include <openssl/err.h>
+#include <openssl/pem.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace couchbase::core::default_ca
+{
+namespace
+{
+std::string
+last_openssl_error()
+{
+    std::string message(256, '\0');
+    ERR_error_string_n(ERR_get_error(), message.data(), message.size());
+    ERR_clear_error();
+    message.resize(std::strlen(message.c_str()));
+    return message;
+}
+
+/**
+ * Adds every certificate of the PEM buffer to the store, returns false if none of them could be added
+ */
+bool
+add_certificate_authority(X509_STORE* store, std::string_view pem)
+{
+    std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())), BIO_free);
+    if (!bio) {
+        return false;
+    }
+    bool added = false;
+    while (X509* certificate = PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr)) {
+        added = X509_STORE_add_cert(store, certificate) == 1 || added;
+        X509_free(certificate);
+    }
+    // reaching the end of the buffer is reported as an error too
+    ERR_clear_error();
+    return added;
+}
+
+X509_STORE*
+build_trust_store(bool include_mozilla_ca_certs)
+{
+    X509_STORE* store = X509_STORE_new();
+    if (store == nullptr) {
+        CB_LOG_WARNING("unable to allocate store for default CAs: {}", last_openssl_error());
+        return nullptr;
+    }
+
+    // load system certificates
+    if (X509_STORE_set_default_paths(store) != 1) {
+        CB_LOG_WARNING("failed to load system CAs: {}", last_openssl_error());
+    }
+
+    // add the Capella Root CA in addition to system CAs
+    if (!add_certificate_authority(store, capellaCaCert)) {
+        CB_LOG_WARNING("unable to load default CAs: {}", last_openssl_error());
+        // we don't consider this fatal and try to continue without it
+    }
+
+    if (const auto certificates = mozilla_ca_certs(); include_mozilla_ca_certs && !certificates.empty()) {
+        CB_LOG_DEBUG("loading {} CA certificates from Mozilla bundle. Update date: \"{}\", SHA256: \"{}\"",
+                     certificates.size(),
+                     mozilla_ca_certs_date(),
+                     mozilla_ca_certs_sha256());
+        for (const auto& cert : certificates) {
+            if (!add_certificate_authority(store, cert.body)) {
+                CB_LOG_WARNING("unable to load CA \"{}\" from Mozilla bundle: {}", cert.authority, last_openssl_error());
+            }
+        }
+    }
+    return store;
+}
+} // namespace
+
+auto
+default_trust_store(bool include_mozilla_ca_certs) -> X509_STORE*
+{
+    // built on first use, and never released, as TLS contexts of any cluster might still reference them
+    X509_STORE* store = nullptr;
+    if (include_mozilla_ca_certs) {
+        static X509_STORE* const with_mozilla_ca_certs = build_trust_store(true);
+        store = with_mozilla_ca_certs;
+    } else {
+        static X509_STORE* const without_mozilla_ca_certs = build_trust_store(false);
+        store = without_mozilla_ca_certs;
+    }
+    if (store != nullptr) {
+        X509_STORE_up_ref(store);
+    }
+    return store;
+}
+} // namespace couchbase::core::default_ca
@@ -0,0 +1,34 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/x509.h>
+
+namespace couchbase::core::default_ca
+{
+/**
+ * Returns the store of CAs trusted when the user did not specify any: the system CAs, the Capella Root CA and, unless
+ * excluded, the Mozilla bundle.
+ *
+ * The certificates are parsed only once per process, when the first cluster needs them, and the store is then shared
+ * by the TLS contexts of all clusters. The caller receives its own reference, which is usually handed over to
+ * SSL_CTX_set_cert_store().
+ */
+auto
+default_trust_store(bool include_mozilla_ca_certs) -> X509_STORE*;
+} // namespace couchbase::core::default_ca
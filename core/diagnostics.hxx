@@ -21,6 +21,7 @@
 
 #include <array>
 #include <chrono>
+#include <cstdint>
 #include <map>
 #include <optional>
 #include <string>
@@ -60,10 +61,19 @@ struct endpoint_diag_info {
     std::optional<std::string> details{};
 };
 
+struct tls_session_info {
+    /** handshakes which resumed a cached session */
+    std::uint64_t hits{};
+    /** full handshakes */
+    std::uint64_t misses{};
+};
+
 struct diagnostics_result {
     std::string id;
     std::string sdk;
     std::map<service_type, std::vector<endpoint_diag_info>> services{};
+    /** only present when TLS is enabled */
+    std::optional<tls_session_info> tls_sessions{};
 
     int version{ 2 };
 };
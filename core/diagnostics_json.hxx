@@ -60,6 +60,12 @@ struct traits<couchbase::core::diag::diagnostics_result> {
             { "sdk", r.sdk },
             { "services", services },
         };
+        if (r.tls_sessions) {
+            v["tls_sessions"] = {
+                { "hits", r.tls_sessions->hits },
+                { "misses", r.tls_sessions->misses },
+            };
+        }
     }
 };
 
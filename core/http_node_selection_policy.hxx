@@ -0,0 +1,37 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+namespace couchbase::core
+{
+/**
+ * How HTTP services (query, search, analytics etc.) pick the node for the request, which does not target specific node.
+ */
+enum class http_node_selection_policy {
+    /**
+     * Nodes are used one after another.
+     */
+    round_robin,
+
+    /**
+     * Two random nodes are compared, and the request goes to the one with fewer outstanding requests and lower latency
+     * (exponentially weighted moving average of the completed requests).
+     */
+    power_of_two_choices,
+};
+} // namespace couchbase::core
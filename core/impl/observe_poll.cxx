@@ -20,8 +20,15 @@
 #include "core/cluster.hxx"
 #include "core/impl/observe_seqno.hxx"
 
+#include <couchbase/metrics/meter.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <tuple>
+#include <vector>
 
 namespace couchbase::core::impl
 {
@@ -157,14 +164,11 @@ class observe_status
     mutable std::mutex mutex_{};
 };
 
-class observe_context;
-static void
-observe_poll(std::shared_ptr<couchbase::core::cluster> core, std::shared_ptr<observe_context> ctx);
-
 class observe_context : public std::enable_shared_from_this<observe_context>
 {
   public:
     observe_context(asio::io_context& io,
+                    std::shared_ptr<couchbase::metrics::meter> meter,
                     document_id id,
                     mutation_token token,
                     std::optional<std::chrono::milliseconds> timeout,
@@ -172,7 +176,7 @@ class observe_context : public std::enable_shared_from_this<observe_context>
                     couchbase::replicate_to replicate_to,
                     observe_handler&& handler)
       : poll_deadline_{ io }
-      , poll_backoff_{ io }
+      , meter_{ std::move(meter) }
       , id_{ std::move(id) }
       , status_{ std::move(token) }
       , timeout_{ timeout }
@@ -184,7 +188,8 @@ class observe_context : public std::enable_shared_from_this<observe_context>
 
     void start()
     {
-        poll_deadline_.expires_after(poll_deadline_interval_);
+        deadline_ = std::chrono::steady_clock::now() + timeout_.value_or(poll_deadline_interval_);
+        poll_deadline_.expires_at(deadline_);
         poll_deadline_.async_wait([ctx = shared_from_this()](std::error_code ec) {
             if (ec == asio::error::operation_aborted) {
                 return;
@@ -203,6 +208,11 @@ class observe_context : public std::enable_shared_from_this<observe_context>
         return id_.bucket();
     }
 
+    [[nodiscard]] auto partition() const -> std::uint16_t
+    {
+        return status_.token().partition_id();
+    }
+
     [[nodiscard]] auto partition_uuid() const -> std::uint64_t
     {
         return status_.token().partition_uuid();
@@ -223,22 +233,26 @@ class observe_context : public std::enable_shared_from_this<observe_context>
         return replicate_to_;
     }
 
-    void add_request(observe_seqno_request&& request)
+    [[nodiscard]] bool is_finished()
+    {
+        std::scoped_lock lock(handler_mutex_);
+        return !handler_;
+    }
+
+    /* starts the next round of observe requests */
+    void reset()
     {
-        requests_.emplace_back(std::move(request));
+        status_.reset();
+        ++rounds_;
     }
 
-    void handle_response(observe_seqno_response&& response)
+    void examine(const observe_seqno_response& response)
     {
-        --expect_number_of_responses_;
-        auto r = std::move(response);
-        status_.examine(r);
-        maybe_finish();
+        status_.examine(response);
     }
 
     void finish(std::error_code ec)
     {
-        poll_backoff_.cancel();
         poll_deadline_.cancel();
         observe_handler handler{};
         {
@@ -246,97 +260,259 @@ class observe_context : public std::enable_shared_from_this<observe_context>
             std::swap(handler_, handler);
         }
         if (handler) {
+            record_rounds();
             handler(ec);
         }
     }
 
+    /* completes the context if the responses of the last round have satisfied the requirements */
     void maybe_finish()
     {
-        observe_handler handler{};
-        {
-            std::scoped_lock lock(handler_mutex_);
-            if (!handler_) {
-                return;
-            }
-            if (status_.meets_condition(persist_to_, replicate_to_)) {
-                std::swap(handler_, handler);
-            } else if (expect_number_of_responses_ == 0 && on_last_response_) {
-                poll_backoff_.expires_after(poll_backoff_interval_);
-                return poll_backoff_.async_wait(std::move(on_last_response_));
-            }
-        }
-        if (handler) {
-            handler({});
+        if (status_.meets_condition(persist_to_, replicate_to_)) {
+            finish({});
         }
     }
 
-    void on_last_response(std::size_t expected_number_of_responses, std::function<void(std::error_code)> handler)
+    /*
+     * Replication and persistence usually take few milliseconds, so the polling starts with short intervals, and backs off
+     * exponentially up to the maximum interval, but never sleeps past the deadline.
+     */
+    [[nodiscard]] auto backoff() const -> std::chrono::microseconds
     {
-        expect_number_of_responses_ = expected_number_of_responses;
-        on_last_response_ = std::move(handler);
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline_ - std::chrono::steady_clock::now());
+        return std::max(std::min(poll_backoff_interval_, remaining), std::chrono::microseconds::zero());
     }
 
-    void execute(std::shared_ptr<couchbase::core::cluster> core)
+    void increase_backoff()
     {
-        auto requests = std::move(requests_);
-        status_.reset();
-        on_last_response(requests.size(), [core, ctx = shared_from_this()](std::error_code ec) mutable {
-            if (ec == asio::error::operation_aborted) {
-                return;
-            }
-            observe_poll(std::move(core), std::move(ctx));
-        });
-        for (auto&& request : requests) {
-            core->execute(std::move(request),
-                          [ctx = shared_from_this()](observe_seqno_response&& response) { ctx->handle_response(std::move(response)); });
-        }
+        poll_backoff_interval_ = std::min(poll_backoff_interval_ * 2, poll_backoff_max_interval_);
     }
 
   private:
+    void record_rounds()
+    {
+        if (!meter_) {
+            return;
+        }
+        static const std::string meter_name = "db.couchbase.observe.rounds";
+        meter_
+          ->get_value_recorder(meter_name,
+                               {
+                                 { "db.couchbase.service", "kv" },
+                                 { "db.name", id_.bucket() },
+                               })
+          ->record_value(static_cast<std::int64_t>(rounds_.load()));
+    }
+
     asio::steady_timer poll_deadline_;
-    asio::steady_timer poll_backoff_;
+    std::shared_ptr<couchbase::metrics::meter> meter_;
     const document_id id_;
     observe_status status_;
     std::optional<std::chrono::milliseconds> timeout_;
     couchbase::persist_to persist_to_;
     couchbase::replicate_to replicate_to_;
-    std::vector<observe_seqno_request> requests_{};
-    std::atomic_size_t expect_number_of_responses_{};
     std::mutex handler_mutex_{};
     observe_handler handler_{};
-    std::function<void(std::error_code)> on_last_response_{};
-    std::chrono::milliseconds poll_backoff_interval_{ 500 };
+    std::atomic_size_t rounds_{ 0 };
+    std::chrono::steady_clock::time_point deadline_{};
+    // the backoff is only used by the coordinator, which serializes the rounds
+    std::chrono::microseconds poll_backoff_interval_{ 100 };
+    std::chrono::microseconds poll_backoff_max_interval_{ 500'000 };
     std::chrono::milliseconds poll_deadline_interval_{ 5'000 };
 };
 
-static void
-observe_poll(std::shared_ptr<couchbase::core::cluster> core, std::shared_ptr<observe_context> ctx)
+/**
+ * Polls the state of the mutations of all legacy durable operations in flight for the bucket.
+ *
+ * Every round sends one observe_seqno request per pair of vbucket and node, no matter how many mutations are waiting
+ * for it, examines the responses for all of them, and completes those which satisfy their requirements. The next round
+ * starts after the shortest backoff of the remaining mutations, so the mutation, which has been added during the round,
+ * is observed soon after the round ends.
+ *
+ * The coordinator only lives while it has mutations to observe, and is shared through the registry while it does.
+ */
+class observe_coordinator : public std::enable_shared_from_this<observe_coordinator>
 {
-    std::string bucket_name = ctx->bucket_name();
-    core->with_bucket_configuration(
-      bucket_name, [core, ctx = std::move(ctx)](std::error_code ec, const core::topology::configuration& config) mutable {
-          if (ec) {
-              return ctx->finish(ec);
-          }
-          auto [err, number_of_replicas] = validate_replicas(config, ctx->persist_to(), ctx->replicate_to());
-          if (err) {
-              return ctx->finish(err);
-          }
-
-          if (ctx->persist_to() != persist_to::none) {
-              ctx->add_request(observe_seqno_request{ ctx->id(), true, ctx->partition_uuid(), ctx->timeout() });
-          }
-
-          if (touches_replica(ctx->persist_to(), ctx->replicate_to())) {
-              for (std::uint32_t replica_index = 1; replica_index <= number_of_replicas; ++replica_index) {
-                  auto replica_id = ctx->id();
-                  replica_id.node_index(replica_index);
-                  ctx->add_request(observe_seqno_request{ replica_id, false, ctx->partition_uuid(), ctx->timeout() });
-              }
-          }
-          ctx->execute(core);
-      });
-}
+  public:
+    observe_coordinator(std::shared_ptr<couchbase::core::cluster> core, std::string bucket_name)
+      : core_{ std::move(core) }
+      , bucket_name_{ std::move(bucket_name) }
+      , next_round_timer_{ core_->io_context() }
+    {
+    }
+
+    static auto for_bucket(const std::shared_ptr<couchbase::core::cluster>& core, const std::string& bucket_name)
+      -> std::shared_ptr<observe_coordinator>
+    {
+        static std::mutex registry_mutex{};
+        static std::map<std::pair<const couchbase::core::cluster*, std::string>, std::weak_ptr<observe_coordinator>> registry{};
+
+        std::scoped_lock lock(registry_mutex);
+        if (auto entry = registry.find({ core.get(), bucket_name }); entry != registry.end()) {
+            if (auto coordinator = entry->second.lock(); coordinator) {
+                return coordinator;
+            }
+        }
+        // the live coordinator keeps its cluster alive, so only the expired entries might refer to destroyed clusters
+        for (auto it = registry.begin(); it != registry.end();) {
+            it = it->second.expired() ? registry.erase(it) : std::next(it);
+        }
+        auto coordinator = std::make_shared<observe_coordinator>(core, bucket_name);
+        registry[{ core.get(), bucket_name }] = coordinator;
+        return coordinator;
+    }
+
+    void add(std::shared_ptr<observe_context> ctx)
+    {
+        std::scoped_lock lock(mutex_);
+        waiters_.emplace_back(std::move(ctx));
+        if (!round_in_flight_) {
+            // the first round of the mutation does not wait for the backoff
+            schedule_round(std::chrono::microseconds::zero());
+        }
+    }
+
+  private:
+    using observe_key = std::tuple<std::uint16_t /* partition */, std::uint64_t /* partition uuid */, std::size_t /* node index */>;
+
+    struct observe_group {
+        observe_seqno_request request;
+        std::vector<std::shared_ptr<observe_context>> contexts{};
+    };
+
+    /* must be called with the mutex held */
+    void schedule_round(std::chrono::microseconds delay)
+    {
+        auto when = std::chrono::steady_clock::now() + delay;
+        if (round_scheduled_ && next_round_ <= when) {
+            return;
+        }
+        round_scheduled_ = true;
+        next_round_ = when;
+        // re-arming the timer aborts the previous wait, but it might have expired already, so the stale handlers are recognized by
+        // their generation
+        auto generation = ++timer_generation_;
+        next_round_timer_.expires_at(when);
+        next_round_timer_.async_wait([self = shared_from_this(), generation](std::error_code ec) {
+            if (ec == asio::error::operation_aborted) {
+                return;
+            }
+            self->start_round(generation);
+        });
+    }
+
+    void start_round(std::size_t generation)
+    {
+        std::vector<std::shared_ptr<observe_context>> round{};
+        {
+            std::scoped_lock lock(mutex_);
+            if (generation != timer_generation_ || round_in_flight_) {
+                return;
+            }
+            round_scheduled_ = false;
+            waiters_.erase(std::remove_if(waiters_.begin(), waiters_.end(), [](const auto& ctx) { return ctx->is_finished(); }),
+                           waiters_.end());
+            if (waiters_.empty()) {
+                return;
+            }
+            round_in_flight_ = true;
+            round = waiters_;
+        }
+        core_->with_bucket_configuration(
+          bucket_name_,
+          [self = shared_from_this(), round = std::move(round)](std::error_code ec, const core::topology::configuration& config) mutable {
+              self->execute_round(ec, config, std::make_shared<std::vector<std::shared_ptr<observe_context>>>(std::move(round)));
+          });
+    }
+
+    void execute_round(std::error_code ec,
+                       const core::topology::configuration& config,
+                       std::shared_ptr<std::vector<std::shared_ptr<observe_context>>> round)
+    {
+        std::map<observe_key, observe_group> groups{};
+        for (const auto& ctx : *round) {
+            if (ec) {
+                ctx->finish(ec);
+                continue;
+            }
+            auto [err, number_of_replicas] = validate_replicas(config, ctx->persist_to(), ctx->replicate_to());
+            if (err) {
+                ctx->finish(err);
+                continue;
+            }
+            ctx->reset();
+
+            auto join_group = [&groups, &ctx](std::size_t node_index, bool active) {
+                auto [group, inserted] = groups.try_emplace(
+                  observe_key{ ctx->partition(), ctx->partition_uuid(), node_index },
+                  observe_group{ observe_seqno_request{ ctx->id(), active, ctx->partition_uuid(), ctx->timeout() } });
+                if (inserted) {
+                    group->second.request.id.node_index(node_index);
+                }
+                group->second.contexts.emplace_back(ctx);
+            };
+            if (ctx->persist_to() != persist_to::none) {
+                join_group(0, true);
+            }
+            if (touches_replica(ctx->persist_to(), ctx->replicate_to())) {
+                for (std::uint32_t replica_index = 1; replica_index <= number_of_replicas; ++replica_index) {
+                    join_group(replica_index, false);
+                }
+            }
+        }
+        if (groups.empty()) {
+            return complete_round(round);
+        }
+
+        auto expected_number_of_responses = std::make_shared<std::atomic_size_t>(groups.size());
+        for (auto& [key, group] : groups) {
+            core_->execute(std::move(group.request),
+                           [self = shared_from_this(), round, contexts = std::move(group.contexts), expected_number_of_responses](
+                             observe_seqno_response&& response) {
+                               for (const auto& ctx : contexts) {
+                                   ctx->examine(response);
+                               }
+                               if (--(*expected_number_of_responses) == 0) {
+                                   self->complete_round(round);
+                               }
+                           });
+        }
+    }
+
+    void complete_round(const std::shared_ptr<std::vector<std::shared_ptr<observe_context>>>& round)
+    {
+        // the handlers of the operations must not run under the lock, as they might start new observe polls
+        for (const auto& ctx : *round) {
+            ctx->maybe_finish();
+        }
+
+        std::scoped_lock lock(mutex_);
+        round_in_flight_ = false;
+        for (const auto& ctx : *round) {
+            ctx->increase_backoff();
+        }
+        waiters_.erase(std::remove_if(waiters_.begin(), waiters_.end(), [](const auto& ctx) { return ctx->is_finished(); }),
+                       waiters_.end());
+        if (waiters_.empty()) {
+            return;
+        }
+        auto backoff = waiters_.front()->backoff();
+        for (const auto& ctx : waiters_) {
+            backoff = std::min(backoff, ctx->backoff());
+        }
+        schedule_round(backoff);
+    }
+
+    std::shared_ptr<couchbase::core::cluster> core_;
+    std::string bucket_name_;
+    asio::steady_timer next_round_timer_;
+    std::mutex mutex_{};
+    std::vector<std::shared_ptr<observe_context>> waiters_{};
+    bool round_in_flight_{ false };
+    bool round_scheduled_{ false };
+    std::chrono::steady_clock::time_point next_round_{};
+    std::size_t timer_generation_{ 0 };
+};
 
 void
 initiate_observe_poll(std::shared_ptr<couchbase::core::cluster> core,
@@ -348,8 +524,8 @@ initiate_observe_poll(std::shared_ptr<couchbase::core::cluster> core,
                       observe_handler&& handler)
 {
     auto ctx = std::make_shared<observe_context>(
-      core->io_context(), std::move(id), std::move(token), timeout, persist_to, replicate_to, std::move(handler));
+      core->io_context(), core->meter(), std::move(id), std::move(token), timeout, persist_to, replicate_to, std::move(handler));
     ctx->start();
-    return observe_poll(std::move(core), std::move(ctx));
+    observe_coordinator::for_bucket(core, ctx->bucket_name())->add(std::move(ctx));
 }
 } // namespace couchbase::core::impl
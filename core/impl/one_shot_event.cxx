@@ -0,0 +1,112 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include <couchbase/blocking.hxx>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#endif
+
+namespace couchbase::core::impl
+{
+namespace
+{
+constexpr std::uint32_t pending{ 0 };
+constexpr std::uint32_t signalled{ 1 };
+constexpr std::uint32_t waiting{ 2 };
+
+#if defined(__linux__)
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) && std::atomic<std::uint32_t>::is_always_lock_free,
+              "futex requires the atomic to have the layout of the plain integer");
+
+void
+park(std::atomic<std::uint32_t>& state, std::uint32_t expected)
+{
+    // returns immediately if the state has changed already, and might wake up spuriously
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&state), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void
+unpark(std::atomic<std::uint32_t>& state)
+{
+    // the kernel only uses the address as a key, so it does not matter if the waiter has destroyed the event by now
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+#else
+// the events share a small table of mutexes and condition variables, selected by their address
+struct parking_slot {
+    std::mutex mutex{};
+    std::condition_variable cv{};
+};
+
+parking_slot&
+slot_for(const std::atomic<std::uint32_t>& state)
+{
+    static std::array<parking_slot, 16> slots{};
+    return slots[(reinterpret_cast<std::uintptr_t>(&state) / alignof(std::max_align_t)) % slots.size()];
+}
+
+void
+park(std::atomic<std::uint32_t>& state, std::uint32_t expected)
+{
+    auto& slot = slot_for(state);
+    std::unique_lock lock(slot.mutex);
+    slot.cv.wait(lock, [&state, expected]() { return state.load(std::memory_order_acquire) != expected; });
+}
+
+void
+unpark(std::atomic<std::uint32_t>& state)
+{
+    auto& slot = slot_for(state);
+    {
+        // the waiter either has not checked the state yet, or is already waiting on the condition variable
+        std::scoped_lock lock(slot.mutex);
+    }
+    // other events might share the slot, so wake everyone, and let them check their states
+    slot.cv.notify_all();
+}
+#endif
+} // namespace
+
+void
+one_shot_event::notify()
+{
+    if (state_.exchange(signalled, std::memory_order_acq_rel) == waiting) {
+        unpark(state_);
+    }
+}
+
+void
+one_shot_event::wait()
+{
+    auto expected = pending;
+    if (!state_.compare_exchange_strong(expected, waiting, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        // the operation has completed before the caller started waiting
+        return;
+    }
+    while (state_.load(std::memory_order_acquire) == waiting) {
+        park(state_, waiting);
+    }
+}
+} // namespace couchbase::core::impl
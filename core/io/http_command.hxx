@@ -46,6 +46,7 @@ struct http_command : public std::enable_shared_from_this<http_command<Request>>
     std::shared_ptr<couchbase::tracing::request_span> span_{ nullptr };
     std::shared_ptr<couchbase::metrics::meter> meter_{};
     std::shared_ptr<io::http_session> session_{};
+    std::uint64_t response_id_{};
     http_command_handler handler_{};
     std::chrono::milliseconds timeout_{};
     std::string client_context_id_;
@@ -98,7 +99,7 @@ struct http_command : public std::enable_shared_from_this<http_command<Request>>
     void cancel()
     {
         if (session_) {
-            session_->stop();
+            session_->cancel_response(response_id_);
         }
         invoke_handler(errc::common::unambiguous_timeout, {});
     }
@@ -144,7 +145,7 @@ struct http_command : public std::enable_shared_from_this<http_command<Request>>
                      encoded.path,
                      client_context_id_,
                      timeout_.count());
-        session_->write_and_subscribe(
+        response_id_ = session_->write_and_subscribe(
           encoded,
           [self = this->shared_from_this(), start = std::chrono::steady_clock::now()](std::error_code ec, io::http_response&& msg) {
               if (ec == asio::error::operation_aborted) {
@@ -0,0 +1,135 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace couchbase::core::io
+{
+/**
+ * Outstanding requests and latency of the HTTP endpoints, used by the power of two choices node selection.
+ *
+ * The endpoints are identified as "hostname:port". The latency is an exponentially weighted moving average of the
+ * successful requests. The failed request counts as one, which took at least failure_penalty, so that the endpoint,
+ * which fails fast (e.g. refuses connections or responds with 5xx), does not look cheap.
+ */
+class http_node_load
+{
+  public:
+    static constexpr double latency_ewma_weight{ 0.2 };
+    static constexpr std::chrono::milliseconds failure_penalty{ 1'000 };
+
+    http_node_load() = default;
+
+    explicit http_node_load(std::uint32_t seed)
+      : random_{ seed }
+    {
+    }
+
+    void request_started(const std::string& endpoint)
+    {
+        std::scoped_lock lock(mutex_);
+        ++load_[endpoint].outstanding;
+    }
+
+    void request_completed(const std::string& endpoint, std::chrono::steady_clock::duration elapsed, bool success)
+    {
+        if (!success) {
+            elapsed = std::max<std::chrono::steady_clock::duration>(elapsed, failure_penalty);
+        }
+        auto sample = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        std::scoped_lock lock(mutex_);
+        auto load = load_.find(endpoint);
+        if (load == load_.end()) {
+            // the endpoint has left the cluster
+            return;
+        }
+        if (load->second.outstanding > 0) {
+            --load->second.outstanding;
+        }
+        auto& latency_us = load->second.latency_us;
+        latency_us = latency_us == 0 ? sample : latency_us + latency_ewma_weight * (sample - latency_us);
+    }
+
+    /**
+     * Forgets the endpoints, which are no longer in the configuration.
+     */
+    void retain(const std::set<std::string>& endpoints)
+    {
+        std::scoped_lock lock(mutex_);
+        for (auto it = load_.begin(); it != load_.end();) {
+            if (endpoints.count(it->first) == 0) {
+                it = load_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    /**
+     * Picks two distinct candidates at random, and returns the index of the one with lower cost.
+     */
+    std::size_t choose(const std::vector<std::string>& candidates)
+    {
+        if (candidates.size() < 2) {
+            return 0;
+        }
+        std::scoped_lock lock(mutex_);
+        std::uniform_int_distribution<std::size_t> first_dis(0, candidates.size() - 1);
+        std::uniform_int_distribution<std::size_t> offset_dis(1, candidates.size() - 1);
+        auto first = first_dis(random_);
+        auto second = (first + offset_dis(random_)) % candidates.size();
+        return cost(candidates[first]) <= cost(candidates[second]) ? first : second;
+    }
+
+    [[nodiscard]] std::size_t number_of_endpoints()
+    {
+        std::scoped_lock lock(mutex_);
+        return load_.size();
+    }
+
+  private:
+    struct endpoint_load {
+        std::size_t outstanding{ 0 };
+        double latency_us{ 0 };
+    };
+
+    /* must be called with the mutex held */
+    [[nodiscard]] double cost(const std::string& endpoint) const
+    {
+        endpoint_load load{};
+        if (auto it = load_.find(endpoint); it != load_.end()) {
+            load = it->second;
+        }
+        // the endpoints without completed requests look cheap, so that they receive the requests and get the latency measured
+        return (load.latency_us + 1) * static_cast<double>(load.outstanding + 1);
+    }
+
+    std::mutex mutex_{};
+    std::map<std::string, endpoint_load> load_{};
+    std::mt19937 random_{ std::random_device{}() };
+};
+} // namespace couchbase::core::io
@@ -62,6 +62,8 @@ static_on_message_complete(::http_parser* parser)
 {
     auto* wrapper = static_cast<couchbase::core::io::http_parser*>(parser->data);
     wrapper->complete = true;
+    // stop at the end of the message, the rest of the data belongs to the next (pipelined) response
+    ::http_parser_pause(parser, 1);
     return 0;
 }
 
@@ -133,9 +135,10 @@ http_parser::error_message() const
 http_parser::feeding_result
 http_parser::feed(const char* data, size_t data_len)
 {
-    if (std::size_t bytes_parsed = ::http_parser_execute(&state_->parser_, &state_->settings_, data, data_len); bytes_parsed != data_len) {
-        return { true, complete, error_message() };
+    std::size_t bytes_parsed = ::http_parser_execute(&state_->parser_, &state_->settings_, data, data_len);
+    if (bytes_parsed != data_len && HTTP_PARSER_ERRNO(&state_->parser_) != HPE_PAUSED) {
+        return { true, complete, error_message(), bytes_parsed };
     }
-    return { false, complete };
+    return { false, complete, {}, bytes_parsed };
 }
 } // namespace couchbase::core::io
@@ -31,6 +31,8 @@ struct http_parser {
         bool failure{ false };
         bool complete{ false };
         std::string error{};
+        /** the parser stops at the end of the response, so this might be less than the size of the input */
+        std::size_t bytes_parsed{ 0 };
     };
 
     http_response response;
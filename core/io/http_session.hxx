@@ -35,6 +35,8 @@
 
 #include <asio.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <memory>
 #include <utility>
@@ -257,10 +259,15 @@ class http_session : public std::enable_shared_from_this<http_session>
         idle_timer_.cancel();
 
         {
-            std::scoped_lock lock(current_response_mutex_);
-            auto ctx = std::move(current_response_);
-            if (ctx.handler) {
-                ctx.handler(errc::common::ambiguous_timeout, {});
+            std::deque<response_context> pending_responses{};
+            {
+                std::scoped_lock lock(pending_responses_mutex_);
+                std::swap(pending_responses_, pending_responses);
+            }
+            for (auto& ctx : pending_responses) {
+                if (ctx.handler) {
+                    ctx.handler(errc::common::ambiguous_timeout, {});
+                }
             }
         }
 
@@ -280,6 +287,59 @@ class http_session : public std::enable_shared_from_this<http_session>
         return stopped_;
     }
 
+    /**
+     * Marks the session as shared by pipelined requests, so that timeout of one request does not close the connection
+     * with the responses of the others.
+     */
+    void enable_pipelining()
+    {
+        pipelining_ = true;
+    }
+
+    /**
+     * Drops the handler of the request, which has timed out.
+     *
+     * The session, which is not shared, gets stopped. The pipelined session keeps reading and discards the response, so
+     * that the following responses are matched to their requests. It is only stopped if it is wedged: the response is at
+     * the head of the queue, and the server has not sent anything for it since the session started waiting for it, or
+     * since its handler was dropped.
+     */
+    void cancel_response(std::uint64_t response_id)
+    {
+        if (!pipelining_) {
+            return stop();
+        }
+        bool wedged{ false };
+        {
+            std::scoped_lock lock(pending_responses_mutex_);
+            auto ctx = std::find_if(pending_responses_.begin(), pending_responses_.end(), [response_id](const auto& pending) {
+                return pending.id == response_id;
+            });
+            if (ctx == pending_responses_.end()) {
+                return;
+            }
+            ctx->handler = nullptr;
+            auto& head = pending_responses_.front();
+            if (!head.handler) {
+                wedged = !head.progressed;
+                head.progressed = false;
+            }
+        }
+        if (wedged) {
+            CB_LOG_DEBUG("{} no data received for the pipelined response at the head, stopping the session", info_.log_prefix());
+            stop();
+        }
+    }
+
+    /**
+     * @return number of requests waiting for response, might be more than one if the requests are pipelined
+     */
+    std::size_t pending_requests()
+    {
+        std::scoped_lock lock(pending_responses_mutex_);
+        return pending_responses_.size();
+    }
+
     void write(const std::vector<std::uint8_t>& buf)
     {
         if (stopped_) {
@@ -309,19 +369,18 @@ class http_session : public std::enable_shared_from_this<http_session>
         asio::post(asio::bind_executor(ctx_, [self = shared_from_this()]() { self->do_write(); }));
     }
 
+    /**
+     * @return identifier of the pending response, which might be used to cancel the request
+     */
     template<typename Handler>
-    void write_and_subscribe(io::http_request& request, Handler&& handler)
+    std::uint64_t write_and_subscribe(io::http_request& request, Handler&& handler)
     {
         if (stopped_) {
-            return;
+            return 0;
         }
-        {
-            response_context ctx{ std::forward<Handler>(handler) };
-            if (request.streaming) {
-                ctx.parser.response.body.use_json_streaming(std::move(request.streaming.value()));
-            }
-            std::scoped_lock lock(current_response_mutex_);
-            std::swap(current_response_, ctx);
+        response_context ctx{ std::forward<Handler>(handler) };
+        if (request.streaming) {
+            ctx.parser.response.body.use_json_streaming(std::move(request.streaming.value()));
         }
         if (request.headers["connection"] == "keep-alive") {
             keep_alive_ = true;
@@ -330,16 +389,25 @@ class http_session : public std::enable_shared_from_this<http_session>
         auto credentials = fmt::format("{}:{}", credentials_.username, credentials_.password);
         request.headers["authorization"] =
           fmt::format("Basic {}", base64::encode(gsl::as_bytes(gsl::span{ credentials.data(), credentials.size() })));
-        write(fmt::format("{} {} HTTP/1.1\r\nhost: {}:{}\r\n", request.method, request.path, hostname_, service_));
         if (!request.body.empty()) {
             request.headers["content-length"] = std::to_string(request.body.size());
         }
-        for (const auto& [name, value] : request.headers) {
-            write(fmt::format("{}: {}\r\n", name, value));
+        std::uint64_t response_id{};
+        {
+            // responses are matched to requests in FIFO order, so the request has to be written under the same lock
+            std::scoped_lock lock(pending_responses_mutex_);
+            ctx.id = ++last_response_id_;
+            response_id = ctx.id;
+            pending_responses_.emplace_back(std::move(ctx));
+            write(fmt::format("{} {} HTTP/1.1\r\nhost: {}:{}\r\n", request.method, request.path, hostname_, service_));
+            for (const auto& [name, value] : request.headers) {
+                write(fmt::format("{}: {}\r\n", name, value));
+            }
+            write("\r\n");
+            write(request.body);
         }
-        write("\r\n");
-        write(request.body);
         flush();
+        return response_id;
     }
 
     void set_idle(std::chrono::milliseconds timeout)
@@ -349,6 +417,10 @@ class http_session : public std::enable_shared_from_this<http_session>
             if (ec == asio::error::operation_aborted) {
                 return;
             }
+            if (self->pending_requests() > 0) {
+                // the pipelined session has been checked out again
+                return;
+            }
             self->stop();
         });
     }
@@ -362,6 +434,10 @@ class http_session : public std::enable_shared_from_this<http_session>
     struct response_context {
         utils::movable_function<void(std::error_code, io::http_response&&)> handler{};
         http_parser parser{};
+        std::uint64_t id{};
+        // the server has sent data for the response, since it has got to the head of the queue, or since its handler was
+        // dropped
+        bool progressed{ false };
     };
 
     void on_resolve(std::error_code ec, const asio::ip::tcp::resolver::results_type& endpoints)
@@ -444,10 +520,18 @@ class http_session : public std::enable_shared_from_this<http_session>
 
     void do_read()
     {
-        if (stopped_ || reading_ || !stream_->is_open()) {
+        if (stopped_ || !stream_->is_open()) {
             return;
         }
-        reading_ = true;
+        if (bool expected{ false }; !reading_.compare_exchange_strong(expected, true)) {
+            return;
+        }
+        read_some();
+    }
+
+    /* must be called by the owner of the reading_ flag */
+    void read_some()
+    {
         stream_->async_read_some(
           asio::buffer(input_buffer_), [self = shared_from_this()](std::error_code ec, std::size_t bytes_transferred) {
               if (ec == asio::error::operation_aborted || self->stopped_) {
@@ -472,29 +556,58 @@ class http_session : public std::enable_shared_from_this<http_session>
                   return self->stop();
               }
 
-              http_parser::feeding_result res{};
+              std::vector<response_context> completed{};
+              bool failure{ false };
+              bool want_read{ false };
+              bool drained{ false };
               {
-                  std::scoped_lock lock(self->current_response_mutex_);
-                  res = self->current_response_.parser.feed(reinterpret_cast<const char*>(self->input_buffer_.data()), bytes_transferred);
-              }
-              if (res.failure) {
-                  return self->stop();
-              }
-              if (res.complete) {
-                  response_context ctx{};
-                  {
-                      std::scoped_lock lock(self->current_response_mutex_);
-                      std::swap(self->current_response_, ctx);
+                  std::scoped_lock lock(self->pending_responses_mutex_);
+                  const auto* data = reinterpret_cast<const char*>(self->input_buffer_.data());
+                  std::size_t data_len = bytes_transferred;
+                  // a single read might contain the end of one response and the beginning of the next pipelined one
+                  while (data_len > 0 && !self->pending_responses_.empty()) {
+                      auto& head = self->pending_responses_.front();
+                      head.progressed = true;
+                      auto res = head.parser.feed(data, data_len);
+                      if (res.failure) {
+                          failure = true;
+                          break;
+                      }
+                      if (!res.complete) {
+                          break;
+                      }
+                      data += res.bytes_parsed;
+                      data_len -= res.bytes_parsed;
+                      completed.emplace_back(std::move(head));
+                      self->pending_responses_.pop_front();
+                  }
+                  // the request, which is queued after the lock is released, starts its own read, so the flag must be
+                  // cleared under the same lock
+                  want_read = !failure && !self->pending_responses_.empty();
+                  drained = self->pipelining_ && !completed.empty() && self->pending_responses_.empty();
+                  if (!want_read) {
+                      self->reading_ = false;
                   }
+              }
+              for (auto& ctx : completed) {
                   if (ctx.parser.response.must_close_connection()) {
                       self->keep_alive_ = false;
                   }
-                  ctx.handler({}, std::move(ctx.parser.response));
-                  self->reading_ = false;
-                  return;
+                  if (ctx.handler) {
+                      ctx.handler({}, std::move(ctx.parser.response));
+                  }
+              }
+              if (failure) {
+                  return self->stop();
+              }
+              if (drained &&
+                  std::none_of(completed.begin(), completed.end(), [](const auto& ctx) { return static_cast<bool>(ctx.handler); })) {
+                  // nobody is going to check in the session after the responses of the cancelled requests
+                  self->set_idle(self->http_ctx_.options.idle_http_connection_timeout);
+              }
+              if (want_read) {
+                  return self->read_some();
               }
-              self->reading_ = false;
-              return self->do_read();
           });
     }
 
@@ -563,11 +676,13 @@ class http_session : public std::enable_shared_from_this<http_session>
     std::atomic_bool connected_{ false };
     std::atomic_bool keep_alive_{ false };
     std::atomic_bool reading_{ false };
+    std::atomic_bool pipelining_{ false };
 
     std::function<void()> on_stop_handler_{ nullptr };
 
-    response_context current_response_{};
-    std::mutex current_response_mutex_{};
+    std::deque<response_context> pending_responses_{};
+    std::uint64_t last_response_id_{ 0 };
+    std::mutex pending_responses_mutex_{};
 
     std::array<std::uint8_t, 16384> input_buffer_{};
     std::vector<std::vector<std::uint8_t>> output_buffer_{};
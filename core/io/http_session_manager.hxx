@@ -24,11 +24,17 @@
 #include "couchbase/metrics/meter.hxx"
 #include "http_command.hxx"
 #include "http_context.hxx"
+#include "http_node_load.hxx"
 #include "http_session.hxx"
 #include "http_traits.hxx"
 
 #include <gsl/narrow>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <optional>
 #include <random>
 
 namespace couchbase::core::io
@@ -59,15 +65,23 @@ class http_session_manager
     void update_config(topology::configuration config) override
     {
         std::scoped_lock config_lock(config_mutex_, sessions_mutex_);
+        if (query_endpoints(config_) != query_endpoints(config)) {
+            // prepared statements might not be known to the new query nodes
+            query_cache_.clear();
+        }
         config_ = std::move(config);
+        node_load_.retain(http_endpoints(config_));
         for (auto& [type, sessions] : idle_sessions_) {
             sessions.remove_if([&opts = options_, &cfg = config_](const auto& session) {
                 return session && !cfg.has_node(opts.network, session->type(), opts.enable_tls, session->hostname(), session->port());
             });
         }
+        schedule_warm_up();
     }
 
-    void set_configuration(const topology::configuration& config, const cluster_options& options)
+    void set_configuration(const topology::configuration& config,
+                           const cluster_options& options,
+                           const couchbase::core::cluster_credentials& credentials)
     {
         std::size_t next_index = 0;
         if (config.nodes.size() > 1) {
@@ -76,10 +90,20 @@ class http_session_manager
             std::uniform_int_distribution<std::size_t> dis(0, config.nodes.size() - 1);
             next_index = dis(gen);
         }
-        std::scoped_lock lock(config_mutex_, next_index_mutex_);
-        options_ = options;
-        next_index_ = next_index;
-        config_ = config;
+        {
+            std::scoped_lock lock(config_mutex_, next_index_mutex_);
+            options_ = options;
+            warm_up_enabled_ = options_.min_idle_http_connections > 0;
+            credentials_ = credentials;
+            next_index_ = next_index;
+            config_ = config;
+        }
+        warm_up();
+    }
+
+    [[nodiscard]] query_cache::stats query_cache_statistics()
+    {
+        return query_cache_.statistics();
     }
 
     void export_diag_info(diag::diagnostics_result& res)
@@ -100,6 +124,13 @@ class http_session_manager
                 }
             }
         }
+        for (const auto& [type, sessions] : pipelined_sessions_) {
+            for (const auto& session : sessions) {
+                if (session) {
+                    res.services[type].emplace_back(session->diag_info());
+                }
+            }
+        }
     }
 
     template<typename Collector>
@@ -187,9 +218,38 @@ class http_session_manager
                                                                         const couchbase::core::cluster_credentials& credentials,
                                                                         const std::string& preferred_node)
     {
+        http_node_selection_policy node_selection{};
+        std::size_t min_idle{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            node_selection = options_.http_node_selection;
+            min_idle = options_.min_idle_http_connections;
+        }
         std::scoped_lock lock(sessions_mutex_);
         idle_sessions_[type].remove_if([](const auto& s) { return !s; });
         busy_sessions_[type].remove_if([](const auto& s) { return !s; });
+        if (preferred_node.empty() && node_selection == http_node_selection_policy::power_of_two_choices) {
+            // the node has to be chosen before looking for idle session, otherwise the policy would not make any difference
+            auto [hostname, port] = next_node(type);
+            if (port == 0) {
+                return { errc::common::service_not_available, nullptr };
+            }
+            std::shared_ptr<http_session> session{};
+            auto& idle = idle_sessions_[type];
+            auto same_node = [&h = hostname, p = std::to_string(port)](const auto& s) { return s->hostname() == h && s->port() == p; };
+            if (auto ptr = std::find_if(idle.begin(), idle.end(), same_node); ptr != idle.end()) {
+                session = *ptr;
+                idle.erase(ptr);
+                session->reset_idle();
+                if (idle.size() < min_idle) {
+                    schedule_warm_up();
+                }
+            } else {
+                session = bootstrap_session(type, credentials, hostname, port);
+            }
+            busy_sessions_[type].push_back(session);
+            return { {}, session };
+        }
         if (idle_sessions_[type].empty()) {
             auto [hostname, port] = preferred_node.empty() ? next_node(type) : lookup_node(type, preferred_node);
             if (port == 0) {
@@ -204,6 +264,9 @@ class http_session_manager
             session = idle_sessions_[type].front();
             idle_sessions_[type].pop_front();
             session->reset_idle();
+            if (idle_sessions_[type].size() < min_idle) {
+                schedule_warm_up();
+            }
         } else {
             auto ptr = std::find_if(idle_sessions_[type].begin(), idle_sessions_[type].end(), [preferred_node](const auto& s) {
                 return s->remote_address() == preferred_node;
@@ -223,15 +286,17 @@ class http_session_manager
 
     void check_in(service_type type, std::shared_ptr<http_session> session)
     {
+        std::chrono::milliseconds idle_timeout{};
         {
             std::scoped_lock lock(config_mutex_);
             if (!session->keep_alive() ||
                 !config_.has_node(options_.network, session->type(), options_.enable_tls, session->hostname(), session->port())) {
                 return asio::post(session->get_executor(), [session]() { session->stop(); });
             }
+            idle_timeout = options_.idle_http_connection_timeout;
         }
         if (!session->is_stopped()) {
-            session->set_idle(options_.idle_http_connection_timeout);
+            session->set_idle(idle_timeout);
             CB_LOG_DEBUG("{} put HTTP session back to idle connections", session->log_prefix());
             std::scoped_lock lock(sessions_mutex_);
             idle_sessions_[type].push_back(session);
@@ -239,8 +304,60 @@ class http_session_manager
         }
     }
 
+    /**
+     * Returns the session with the fewest outstanding requests, which is shared by the pipelined requests of the same type.
+     * The new session is created, if all of them are at max_pipelined_requests.
+     */
+    std::pair<std::error_code, std::shared_ptr<http_session>> check_out_pipelined(service_type type,
+                                                                                  const couchbase::core::cluster_credentials& credentials)
+    {
+        std::scoped_lock lock(sessions_mutex_);
+        auto& sessions = pipelined_sessions_[type];
+        sessions.remove_if([](const auto& s) { return !s || s->is_stopped(); });
+        auto least_busy = std::min_element(sessions.begin(), sessions.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs->pending_requests() < rhs->pending_requests();
+        });
+        if (least_busy != sessions.end() && (*least_busy)->pending_requests() < max_pipelined_requests) {
+            (*least_busy)->reset_idle();
+            return { {}, *least_busy };
+        }
+        auto [hostname, port] = next_node(type);
+        if (port == 0) {
+            return { errc::common::service_not_available, nullptr };
+        }
+        auto session = bootstrap_session(type, credentials, hostname, port);
+        session->enable_pipelining();
+        sessions.push_back(session);
+        return { {}, session };
+    }
+
+    void check_in_pipelined(std::shared_ptr<http_session> session)
+    {
+        if (session->pending_requests() > 0) {
+            return;
+        }
+        std::chrono::milliseconds idle_timeout{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            if (!session->keep_alive() ||
+                !config_.has_node(options_.network, session->type(), options_.enable_tls, session->hostname(), session->port())) {
+                return asio::post(session->get_executor(), [session]() { session->stop(); });
+            }
+            idle_timeout = options_.idle_http_connection_timeout;
+        }
+        std::scoped_lock lock(sessions_mutex_);
+        if (!session->is_stopped() && session->pending_requests() == 0) {
+            session->set_idle(idle_timeout);
+        }
+    }
+
     void close()
     {
+        closed_ = true;
+        asio::post(asio::bind_executor(ctx_, [self = shared_from_this()]() {
+            self->keep_alive_timer_.cancel();
+            self->warm_up_retry_timer_.cancel();
+        }));
         std::scoped_lock lock(sessions_mutex_);
         for (auto& [type, sessions] : idle_sessions_) {
             for (auto& s : sessions) {
@@ -251,6 +368,7 @@ class http_session_manager
             }
         }
         busy_sessions_.clear();
+        pipelined_sessions_.clear();
     }
 
     template<typename Request, typename Handler>
@@ -262,7 +380,17 @@ class http_session_manager
                 preferred_node = *request.send_to_node;
             }
         }
-        auto [error, session] = check_out(request.type, credentials, preferred_node);
+        bool pipelined = false;
+        std::chrono::milliseconds timeout{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            if constexpr (http_traits::supports_pipelining_v<Request>) {
+                pipelined = options_.enable_http_pipelining;
+            }
+            timeout = options_.default_timeout_for(request.type);
+        }
+        auto [error, session] = pipelined ? check_out_pipelined(request.type, credentials)
+                                          : check_out(request.type, credentials, preferred_node);
         if (error) {
             typename Request::error_context_type ctx{};
             ctx.ec = error;
@@ -270,11 +398,17 @@ class http_session_manager
             return handler(request.make_response(std::move(ctx), response_type{}));
         }
         const auto& http_ctx = session->http_context();
+        auto node = request_started(*session);
 
-        auto cmd =
-          std::make_shared<operations::http_command<Request>>(ctx_, request, tracer_, meter_, options_.default_timeout_for(request.type));
-        cmd->start([self = shared_from_this(), cmd, http_ctx, handler = std::forward<Handler>(handler)](std::error_code ec,
-                                                                                                        io::http_response&& msg) mutable {
+        auto cmd = std::make_shared<operations::http_command<Request>>(ctx_, request, tracer_, meter_, timeout);
+        cmd->start([self = shared_from_this(),
+                    cmd,
+                    http_ctx,
+                    node = std::move(node),
+                    pipelined,
+                    start = std::chrono::steady_clock::now(),
+                    handler = std::forward<Handler>(handler)](std::error_code ec, io::http_response&& msg) mutable {
+            self->node_load_.request_completed(node, std::chrono::steady_clock::now() - start, !ec && msg.status_code < 500);
             using command_type = typename decltype(cmd)::element_type;
             using encoded_response_type = typename command_type::encoded_response_type;
             using error_context_type = typename command_type::error_context_type;
@@ -291,19 +425,204 @@ class http_session_manager
             ctx.hostname = http_ctx.hostname;
             ctx.port = http_ctx.port;
             handler(cmd->request.make_response(std::move(ctx), std::move(resp)));
+            if (pipelined) {
+                return self->check_in_pipelined(cmd->session_);
+            }
             self->check_in(cmd->request.type, cmd->session_);
         });
         cmd->send_to(session);
     }
 
   private:
+    static constexpr std::size_t max_pipelined_requests{ 16 };
+    static constexpr std::array warmed_up_services{ service_type::query, service_type::search, service_type::analytics };
+
+    void schedule_warm_up()
+    {
+        // might be called with config_mutex_ held, so the options are not consulted here
+        if (warm_up_enabled_ && !closed_) {
+            asio::post(asio::bind_executor(ctx_, [self = shared_from_this()]() { self->warm_up(); }));
+        }
+    }
+
+    /**
+     * Tops up idle sessions of query, search and analytics to min_idle_http_connections. The new sessions are sent no-op
+     * request, so that by the time they are checked out, they are connected.
+     *
+     * The nodes, where the no-op request has failed recently (e.g. the port refuses connections), are skipped until their
+     * backoff expires.
+     */
+    void warm_up()
+    {
+        std::size_t min_idle{};
+        couchbase::core::cluster_credentials credentials{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            min_idle = options_.min_idle_http_connections;
+            credentials = credentials_;
+        }
+        if (min_idle == 0 || closed_) {
+            return;
+        }
+        std::optional<std::chrono::steady_clock::time_point> retry_at{};
+        for (auto type : warmed_up_services) {
+            std::size_t missing{ 0 };
+            {
+                std::scoped_lock lock(sessions_mutex_);
+                idle_sessions_[type].remove_if([](const auto& s) { return !s; });
+                if (auto available = idle_sessions_[type].size() + warming_sessions_[type]; available < min_idle) {
+                    missing = min_idle - available;
+                    warming_sessions_[type] += missing;
+                }
+            }
+            for (std::size_t i = 0; i < missing; ++i) {
+                auto [hostname, port] = next_node(type);
+                if (port == 0) {
+                    // the service is not deployed in the cluster
+                    std::scoped_lock lock(sessions_mutex_);
+                    warming_sessions_[type] -= missing - i;
+                    break;
+                }
+                std::shared_ptr<http_session> session{};
+                {
+                    std::scoped_lock lock(sessions_mutex_);
+                    if (auto backoff = warm_up_backoff_.find({ type, hostname + ":" + std::to_string(port) });
+                        backoff != warm_up_backoff_.end() && backoff->second.retry_at > std::chrono::steady_clock::now()) {
+                        --warming_sessions_[type];
+                        retry_at = retry_at ? std::min(*retry_at, backoff->second.retry_at) : backoff->second.retry_at;
+                        continue;
+                    }
+                    session = bootstrap_session(type, credentials, hostname, port);
+                    busy_sessions_[type].push_back(session);
+                }
+                CB_LOG_DEBUG("{} warm up HTTP session", session->log_prefix());
+                send_noop(type, session);
+            }
+        }
+        if (retry_at) {
+            schedule_warm_up_retry(retry_at.value());
+        }
+        schedule_keep_alive();
+    }
+
+    void schedule_warm_up_retry(std::chrono::steady_clock::time_point retry_at)
+    {
+        if (closed_ || warm_up_retry_scheduled_.exchange(true)) {
+            return;
+        }
+        warm_up_retry_timer_.expires_at(retry_at);
+        warm_up_retry_timer_.async_wait([self = shared_from_this()](std::error_code ec) {
+            self->warm_up_retry_scheduled_ = false;
+            if (ec == asio::error::operation_aborted || self->closed_) {
+                return;
+            }
+            self->warm_up();
+        });
+    }
+
+    /**
+     * Backs off the warm-up of the service on the node after a failed no-op request, so that the node, which refuses
+     * connections, does not get reconnected in a tight loop.
+     */
+    void noop_completed(service_type type, const http_session& session, std::error_code ec)
+    {
+        std::scoped_lock lock(sessions_mutex_);
+        --warming_sessions_[type];
+        auto key = std::make_pair(type, session.hostname() + ":" + session.port());
+        if (!ec) {
+            warm_up_backoff_.erase(key);
+            return;
+        }
+        auto& backoff = warm_up_backoff_[key];
+        backoff.interval = std::clamp(backoff.interval * 2, warm_up_backoff_min_interval, warm_up_backoff_max_interval);
+        backoff.retry_at = std::chrono::steady_clock::now() + backoff.interval;
+    }
+
+    /**
+     * Pings the most recently used idle sessions (up to min_idle_http_connections) before idle_http_connection_timeout
+     * expires. The sessions above the minimum are left to expire.
+     */
+    void schedule_keep_alive()
+    {
+        std::chrono::milliseconds interval{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            interval = options_.idle_http_connection_timeout / 2;
+        }
+        if (interval.count() <= 0 || closed_ || keep_alive_scheduled_.exchange(true)) {
+            return;
+        }
+        keep_alive_timer_.expires_after(interval);
+        keep_alive_timer_.async_wait([self = shared_from_this()](std::error_code ec) {
+            self->keep_alive_scheduled_ = false;
+            if (ec == asio::error::operation_aborted || self->closed_) {
+                return;
+            }
+            std::size_t min_idle{};
+            {
+                std::scoped_lock lock(self->config_mutex_);
+                min_idle = self->options_.min_idle_http_connections;
+            }
+            for (auto type : warmed_up_services) {
+                std::vector<std::shared_ptr<http_session>> sessions{};
+                {
+                    std::scoped_lock lock(self->sessions_mutex_);
+                    auto& idle = self->idle_sessions_[type];
+                    while (!idle.empty() && sessions.size() < min_idle) {
+                        auto session = std::move(idle.back());
+                        idle.pop_back();
+                        if (session && !session->is_stopped()) {
+                            session->reset_idle();
+                            self->busy_sessions_[type].push_back(session);
+                            sessions.emplace_back(std::move(session));
+                        }
+                    }
+                    // the pinged sessions are counted as warming, otherwise warm_up would replace them with the new ones
+                    self->warming_sessions_[type] += sessions.size();
+                }
+                for (const auto& session : sessions) {
+                    self->send_noop(type, session);
+                }
+            }
+            self->warm_up();
+        });
+    }
+
+    /**
+     * The session is counted in warming_sessions_ until the response of the no-op request.
+     */
+    void send_noop(service_type type, std::shared_ptr<http_session> session)
+    {
+        operations::http_noop_request request{};
+        request.type = type;
+        std::chrono::milliseconds timeout{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            timeout = options_.default_timeout_for(request.type);
+        }
+        auto cmd = std::make_shared<operations::http_command<operations::http_noop_request>>(ctx_, request, tracer_, meter_, timeout);
+        cmd->start([self = shared_from_this(), type, cmd](std::error_code ec, io::http_response&& /* msg */) {
+            if (ec) {
+                CB_LOG_DEBUG("{} no-op request on idle HTTP session failed: {}", cmd->session_->log_prefix(), ec.message());
+            }
+            self->noop_completed(type, *cmd->session_, ec);
+            self->check_in(type, cmd->session_);
+        });
+        cmd->send_to(session);
+    }
+
     std::shared_ptr<http_session> bootstrap_session(service_type type,
                                                     const couchbase::core::cluster_credentials& credentials,
                                                     const std::string& hostname,
                                                     std::uint16_t port)
     {
+        bool enable_tls{};
+        {
+            std::scoped_lock lock(config_mutex_);
+            enable_tls = options_.enable_tls;
+        }
         std::shared_ptr<http_session> session;
-        if (options_.enable_tls) {
+        if (enable_tls) {
             session = std::make_shared<http_session>(type,
                                                      client_id_,
                                                      ctx_,
@@ -327,13 +646,46 @@ class http_session_manager
             std::scoped_lock inner_lock(self->sessions_mutex_);
             self->busy_sessions_[type].remove_if([&id](const auto& s) { return !s || s->id() == id; });
             self->idle_sessions_[type].remove_if([&id](const auto& s) { return !s || s->id() == id; });
+            self->pipelined_sessions_[type].remove_if([&id](const auto& s) { return !s || s->id() == id; });
+            self->schedule_warm_up();
         });
         return session;
     }
 
+    std::string request_started(const http_session& session)
+    {
+        auto endpoint = session.hostname() + ":" + session.port();
+        node_load_.request_started(endpoint);
+        return endpoint;
+    }
+
+    /* must be called with config_mutex_ held */
+    std::pair<std::string, std::uint16_t> least_loaded_node(service_type type)
+    {
+        std::vector<std::pair<std::string, std::uint16_t>> candidates{};
+        candidates.reserve(config_.nodes.size());
+        for (const auto& node : config_.nodes) {
+            if (auto port = node.port_or(options_.network, type, options_.enable_tls, 0); port != 0) {
+                candidates.emplace_back(node.hostname_for(options_.network), port);
+            }
+        }
+        if (candidates.empty()) {
+            return { "", static_cast<std::uint16_t>(0U) };
+        }
+        std::vector<std::string> endpoints{};
+        endpoints.reserve(candidates.size());
+        for (const auto& [hostname, port] : candidates) {
+            endpoints.emplace_back(hostname + ":" + std::to_string(port));
+        }
+        return candidates[node_load_.choose(endpoints)];
+    }
+
     std::pair<std::string, std::uint16_t> next_node(service_type type)
     {
         std::scoped_lock lock(config_mutex_);
+        if (options_.http_node_selection == http_node_selection_policy::power_of_two_choices) {
+            return least_loaded_node(type);
+        }
         auto candidates = config_.nodes.size();
         while (candidates > 0) {
             --candidates;
@@ -372,6 +724,35 @@ class http_session_manager
     }
 
     std::string client_id_;
+    [[nodiscard]] std::set<std::string> query_endpoints(const topology::configuration& config) const
+    {
+        std::set<std::string> endpoints{};
+        for (const auto& node : config.nodes) {
+            if (auto port = node.port_or(options_.network, service_type::query, options_.enable_tls, 0); port != 0) {
+                endpoints.emplace(node.hostname_for(options_.network) + ":" + std::to_string(port));
+            }
+        }
+        return endpoints;
+    }
+
+    [[nodiscard]] std::set<std::string> http_endpoints(const topology::configuration& config) const
+    {
+        std::set<std::string> endpoints{};
+        for (const auto& node : config.nodes) {
+            for (auto type : { service_type::query,
+                               service_type::analytics,
+                               service_type::search,
+                               service_type::view,
+                               service_type::management,
+                               service_type::eventing }) {
+                if (auto port = node.port_or(options_.network, type, options_.enable_tls, 0); port != 0) {
+                    endpoints.emplace(node.hostname_for(options_.network) + ":" + std::to_string(port));
+                }
+            }
+        }
+        return endpoints;
+    }
+
     asio::io_context& ctx_;
     asio::ssl::context& tls_;
     std::shared_ptr<couchbase::tracing::request_tracer> tracer_{ nullptr };
@@ -382,9 +763,26 @@ class http_session_manager
     std::mutex config_mutex_{};
     std::map<service_type, std::list<std::shared_ptr<http_session>>> busy_sessions_{};
     std::map<service_type, std::list<std::shared_ptr<http_session>>> idle_sessions_{};
+    std::map<service_type, std::list<std::shared_ptr<http_session>>> pipelined_sessions_{};
     std::size_t next_index_{ 0 };
     std::mutex next_index_mutex_{};
     std::mutex sessions_mutex_{};
     query_cache query_cache_{};
+    couchbase::core::cluster_credentials credentials_{};
+    std::map<service_type, std::size_t> warming_sessions_{};
+    asio::steady_timer keep_alive_timer_{ ctx_ };
+    std::atomic_bool keep_alive_scheduled_{ false };
+    struct warm_up_backoff {
+        std::chrono::milliseconds interval{ 0 };
+        std::chrono::steady_clock::time_point retry_at{};
+    };
+    static constexpr std::chrono::milliseconds warm_up_backoff_min_interval{ 100 };
+    static constexpr std::chrono::milliseconds warm_up_backoff_max_interval{ 10'000 };
+    std::map<std::pair<service_type, std::string /* hostname:port */>, warm_up_backoff> warm_up_backoff_{};
+    asio::steady_timer warm_up_retry_timer_{ ctx_ };
+    std::atomic_bool warm_up_retry_scheduled_{ false };
+    std::atomic_bool warm_up_enabled_{ false };
+    std::atomic_bool closed_{ false };
+    http_node_load node_load_{};
 };
 } // namespace couchbase::core::io
@@ -35,4 +35,14 @@ struct supports_parent_span : public std::false_type {
 template<typename T>
 inline constexpr bool supports_parent_span_v = supports_parent_span<T>::value;
 
+/**
+ * The request is idempotent GET, and can share the connection with other requests of this kind (HTTP/1.1 pipelining).
+ */
+template<typename T>
+struct supports_pipelining : public std::false_type {
+};
+
+template<typename T>
+inline constexpr bool supports_pipelining_v = supports_pipelining<T>::value;
+
 } // namespace couchbase::core::io::http_traits
@@ -199,7 +199,7 @@ struct mcbp_command : public std::enable_shared_from_this<mcbp_command<Manager,
     {
         opaque_ = session_->next_opaque();
         request.opaque = *opaque_;
-        span_->add_tag(tracing::attributes::operation_id, fmt::format("0x{:x}", request.opaque));
+        span_->add_tag(tracing::attributes::operation_id, std::uint64_t{ request.opaque });
         if (request.id.use_collections() && !request.id.is_collection_resolved()) {
             if (session_->supports_feature(protocol::hello_feature::collections)) {
                 auto collection_id = session_->get_collection_uid(request.id.collection_path());
@@ -98,6 +98,7 @@ class mcbp_session_impl
         std::shared_ptr<mcbp_session_impl> session_;
         sasl::ClientContext sasl_;
         std::atomic_bool stopped_{ false };
+        bool authenticated_requests_written_{ false };
 
       public:
         ~bootstrap_handler()
@@ -151,7 +152,16 @@ class mcbp_session_impl
                          utils::join_strings_fmt("{}", hello_req.body().features(), ", "));
             session_->write(hello_req.data());
 
-            if (!session_->origin_.credentials().uses_certificate()) {
+            // The server executes the handshake commands in order, so everything that does not depend on a response is written
+            // in a single batch. The error map is requested before knowing whether the server supports it, the response tells.
+            protocol::client_request<protocol::get_error_map_request_body> errmap_req;
+            errmap_req.opaque(session_->next_opaque());
+            session_->write(errmap_req.data());
+
+            if (session_->origin_.credentials().uses_certificate()) {
+                // the client is authenticated by the TLS handshake already
+                write_authenticated_requests();
+            } else {
                 protocol::client_request<protocol::sasl_list_mechs_request_body> list_req;
                 list_req.opaque(session_->next_opaque());
                 session_->write(list_req.data());
@@ -162,26 +172,26 @@ class mcbp_session_impl
                 auth_req.body().mechanism(sasl_.get_name());
                 auth_req.body().sasl_data(sasl_payload);
                 session_->write(auth_req.data());
+
+                // PLAIN completes in a single step, so the rest of the handshake could go right behind it. If the authentication
+                // fails, the bootstrap completes on the SASL response, and the responses to the commands behind it are ignored.
+                if (sasl_.get_name() == "PLAIN") {
+                    write_authenticated_requests();
+                }
             }
 
             session_->flush();
         }
 
-        void complete(std::error_code ec)
+        /**
+         * Writes the commands which require authenticated connection: SELECT_BUCKET and GET_CLUSTER_CONFIG. Does not flush.
+         */
+        void write_authenticated_requests()
         {
-            if (bool expected_state{ false }; stopped_.compare_exchange_strong(expected_state, true)) {
-                session_->invoke_bootstrap_handler(ec);
-            }
-        }
-
-        void auth_success()
-        {
-            session_->authenticated_ = true;
-            if (session_->supports_feature(protocol::hello_feature::xerror)) {
-                protocol::client_request<protocol::get_error_map_request_body> errmap_req;
-                errmap_req.opaque(session_->next_opaque());
-                session_->write(errmap_req.data());
+            if (authenticated_requests_written_) {
+                return;
             }
+            authenticated_requests_written_ = true;
             if (session_->bucket_name_) {
                 protocol::client_request<protocol::select_bucket_request_body> sb_req;
                 sb_req.opaque(session_->next_opaque());
@@ -191,7 +201,22 @@ class mcbp_session_impl
             protocol::client_request<protocol::get_cluster_config_request_body> cfg_req;
             cfg_req.opaque(session_->next_opaque());
             session_->write(cfg_req.data());
-            session_->flush();
+        }
+
+        void complete(std::error_code ec)
+        {
+            if (bool expected_state{ false }; stopped_.compare_exchange_strong(expected_state, true)) {
+                session_->invoke_bootstrap_handler(ec);
+            }
+        }
+
+        void auth_success()
+        {
+            session_->authenticated_ = true;
+            if (!authenticated_requests_written_) {
+                write_authenticated_requests();
+                session_->flush();
+            }
         }
 
         void handle(mcbp_message&& msg)
@@ -302,6 +327,11 @@ class mcbp_session_impl
                             protocol::client_response<protocol::get_error_map_response_body> resp(std::move(msg));
                             if (resp.status() == key_value_status_code::success) {
                                 session_->error_map_.emplace(resp.body().errmap());
+                            } else if (!session_->supports_feature(protocol::hello_feature::xerror)) {
+                                CB_LOG_DEBUG("{} server does not support error map (status={}, opaque={})",
+                                             session_->log_prefix_,
+                                             resp.status(),
+                                             resp.opaque());
                             } else {
                                 CB_LOG_WARNING("{} unexpected message status during bootstrap: {} (opaque={}, {:n})",
                                                session_->log_prefix_,
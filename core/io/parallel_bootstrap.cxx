@@ -0,0 +1,102 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "parallel_bootstrap.hxx"
+
+#include "core/logger/logger.hxx"
+#include "core/utils/join_strings.hxx"
+
+#include <couchbase/retry_reason.hxx>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace couchbase::core::io
+{
+namespace
+{
+struct bootstrap_race {
+    std::mutex mutex{};
+    bool completed{ false };
+    std::size_t pending{ 0 };
+    std::error_code last_error{};
+    std::vector<mcbp_session> sessions{};
+    parallel_bootstrap_handler handler{};
+};
+} // namespace
+
+void
+parallel_bootstrap(const origin& seeds, utils::movable_function<mcbp_session(origin)>&& make_session, parallel_bootstrap_handler&& handler)
+{
+    auto race = std::make_shared<bootstrap_race>();
+    race->handler = std::move(handler);
+    for (const auto& node : seeds.get_node_list()) {
+        origin node_origin(seeds);
+        node_origin.set_nodes({ node });
+        race->sessions.emplace_back(make_session(std::move(node_origin)));
+    }
+    race->pending = race->sessions.size();
+    CB_LOG_DEBUG("bootstrap {} sessions in parallel: [{}]", race->pending, utils::join_strings(seeds.get_nodes(), ","));
+
+    // the callbacks might be invoked before this loop is over, so iterate over a copy
+    auto sessions = race->sessions;
+    for (auto& session : sessions) {
+        session.bootstrap([race, session](std::error_code ec, topology::configuration config) mutable {
+            parallel_bootstrap_handler handler{};
+            std::vector<mcbp_session> losers{};
+            {
+                std::scoped_lock lock(race->mutex);
+                --race->pending;
+                if (race->completed) {
+                    if (!ec) {
+                        losers.emplace_back(session);
+                    }
+                } else if (!ec) {
+                    race->completed = true;
+                    handler = std::move(race->handler);
+                    for (const auto& other : race->sessions) {
+                        if (other.id() != session.id()) {
+                            losers.emplace_back(other);
+                        }
+                    }
+                    race->sessions.clear();
+                } else {
+                    race->last_error = ec;
+                    if (race->pending == 0) {
+                        race->completed = true;
+                        handler = std::move(race->handler);
+                        race->sessions.clear();
+                    }
+                }
+            }
+            // stopping invokes bootstrap callbacks of the losers, so it must not happen under the lock
+            for (auto& loser : losers) {
+                loser.stop(retry_reason::do_not_retry);
+            }
+            if (!handler) {
+                return;
+            }
+            if (ec) {
+                return handler(ec, std::move(config), {});
+            }
+            CB_LOG_DEBUG("{} won the parallel bootstrap", session.log_prefix());
+            handler(ec, std::move(config), std::move(session));
+        });
+    }
+}
+} // namespace couchbase::core::io
@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "core/origin.hxx"
+#include "core/topology/configuration.hxx"
+#include "core/utils/movable_function.hxx"
+#include "mcbp_session.hxx"
+
+#include <optional>
+#include <system_error>
+
+namespace couchbase::core::io
+{
+using parallel_bootstrap_handler = utils::movable_function<void(std::error_code, topology::configuration, std::optional<mcbp_session>)>;
+
+/**
+ * Bootstraps one session per seed node of the origin at the same time, instead of trying the nodes one after another.
+ *
+ * The handler is invoked once, with the first session that received the configuration. The sessions which are still
+ * bootstrapping at that moment (or succeed later) are stopped. If all sessions fail, the handler receives the error of the
+ * last one, and no session.
+ *
+ * @param seeds origin with the seed nodes, the factory receives its copy restricted to a single node
+ * @param make_session creates the session for the given origin
+ * @param handler invoked when the race is over
+ */
+void
+parallel_bootstrap(const origin& seeds, utils::movable_function<mcbp_session(origin)>&& make_session, parallel_bootstrap_handler&& handler);
+} // namespace couchbase::core::io
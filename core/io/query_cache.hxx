@@ -17,55 +17,174 @@
 
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace couchbase::core
 {
+/**
+ * Cache of prepared statements, bounded by evicting the least recently used ones.
+ *
+ * Statements are spread over shards by their hash, each shard having its own lock and LRU list, so concurrent queries
+ * rarely contend with each other.
+ */
 class query_cache
 {
   public:
+    static constexpr std::size_t default_capacity{ 5000 };
+    static constexpr std::size_t number_of_shards{ 16 };
+
     struct entry {
         std::string name;
         std::optional<std::string> plan{};
     };
 
+    struct stats {
+        std::uint64_t hits{};
+        std::uint64_t misses{};
+        std::uint64_t evictions{};
+        std::size_t size{};
+
+        [[nodiscard]] double hit_ratio() const
+        {
+            auto lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    explicit query_cache(std::size_t capacity = default_capacity)
+      : shard_capacity_{ std::max<std::size_t>(1, (capacity + number_of_shards - 1) / number_of_shards) }
+    {
+    }
+
     void erase(const std::string& statement)
     {
-        std::scoped_lock lock(store_mutex_);
-        auto it = store_.find(statement);
-        if (it == store_.end()) {
-            return;
+        auto hash = std::hash<std::string>{}(statement);
+        auto& s = shard_for(hash);
+        std::scoped_lock lock(s.mutex);
+        if (auto it = s.find(hash, statement); it != s.index.end()) {
+            s.lru.erase(it->second);
+            s.index.erase(it);
         }
-        store_.erase(it);
     }
 
     void put(const std::string& statement, const std::string& prepared)
     {
-        std::scoped_lock lock(store_mutex_);
-        store_.try_emplace(statement, entry{ prepared });
+        emplace(statement, entry{ prepared });
     }
 
     void put(const std::string& statement, const std::string& name, const std::string& encoded_plan)
     {
-        std::scoped_lock lock(store_mutex_);
-        store_.try_emplace(statement, entry{ name, encoded_plan });
+        emplace(statement, entry{ name, encoded_plan });
     }
 
     std::optional<entry> get(const std::string& statement)
     {
-        std::scoped_lock lock(store_mutex_);
-        auto it = store_.find(statement);
-        if (it == store_.end()) {
+        auto hash = std::hash<std::string>{}(statement);
+        auto& s = shard_for(hash);
+        std::scoped_lock lock(s.mutex);
+        auto it = s.find(hash, statement);
+        if (it == s.index.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
             return {};
         }
-        return it->second;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        s.lru.splice(s.lru.begin(), s.lru, it->second);
+        return it->second->value;
+    }
+
+    /**
+     * Drops all prepared statements, for example when the query nodes they were prepared on change.
+     */
+    void clear()
+    {
+        for (auto& s : shards_) {
+            std::scoped_lock lock(s.mutex);
+            s.index.clear();
+            s.lru.clear();
+        }
+    }
+
+    [[nodiscard]] stats statistics()
+    {
+        stats result{ hits_.load(std::memory_order_relaxed),
+                      misses_.load(std::memory_order_relaxed),
+                      evictions_.load(std::memory_order_relaxed) };
+        for (auto& s : shards_) {
+            std::scoped_lock lock(s.mutex);
+            result.size += s.lru.size();
+        }
+        return result;
     }
 
   private:
-    std::map<std::string, entry> store_;
-    std::mutex store_mutex_{};
+    struct node {
+        std::size_t hash;
+        std::string statement;
+        entry value;
+    };
+
+    struct shard {
+        std::mutex mutex{};
+        // most recently used at the front
+        std::list<node> lru{};
+        std::unordered_multimap<std::size_t, std::list<node>::iterator> index{};
+
+        auto find(std::size_t hash, const std::string& statement)
+        {
+            auto [begin, end] = index.equal_range(hash);
+            for (auto it = begin; it != end; ++it) {
+                if (it->second->statement == statement) {
+                    return it;
+                }
+            }
+            return index.end();
+        }
+    };
+
+    shard& shard_for(std::size_t hash)
+    {
+        return shards_[hash % number_of_shards];
+    }
+
+    void emplace(const std::string& statement, entry&& value)
+    {
+        auto hash = std::hash<std::string>{}(statement);
+        auto& s = shard_for(hash);
+        std::scoped_lock lock(s.mutex);
+        if (auto it = s.find(hash, statement); it != s.index.end()) {
+            s.lru.splice(s.lru.begin(), s.lru, it->second);
+            return;
+        }
+        s.lru.push_front(node{ hash, statement, std::move(value) });
+        s.index.emplace(hash, s.lru.begin());
+        if (s.lru.size() > shard_capacity_) {
+            auto victim = std::prev(s.lru.end());
+            auto [begin, end] = s.index.equal_range(victim->hash);
+            for (auto it = begin; it != end; ++it) {
+                if (it->second == victim) {
+                    s.index.erase(it);
+                    break;
+                }
+            }
+            s.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const std::size_t shard_capacity_;
+    std::array<shard, number_of_shards> shards_{};
+    std::atomic<std::uint64_t> hits_{ 0 };
+    std::atomic<std::uint64_t> misses_{ 0 };
+    std::atomic<std::uint64_t> evictions_{ 0 };
 };
 } // namespace couchbase::core
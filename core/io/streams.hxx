@@ -18,6 +18,7 @@
 #pragma once
 
 #include "ip_protocol.hxx"
+#include "tls_session_cache.hxx"
 
 #include <asio.hpp>
 #include <asio/ssl.hpp>
@@ -227,7 +228,7 @@ class tls_stream_impl : public stream_impl
     void async_connect(const asio::ip::tcp::resolver::results_type::endpoint_type& endpoint,
                        std::function<void(std::error_code)>&& handler) override
     {
-        return stream_->lowest_layer().async_connect(endpoint, [this, handler](std::error_code ec_connect) mutable {
+        return stream_->lowest_layer().async_connect(endpoint, [this, endpoint, handler](std::error_code ec_connect) mutable {
             if (ec_connect == asio::error::operation_aborted) {
                 return;
             }
@@ -235,10 +236,14 @@ class tls_stream_impl : public stream_impl
                 return handler(ec_connect);
             }
             open_ = stream_->lowest_layer().is_open();
-            stream_->async_handshake(asio::ssl::stream_base::client, [handler](std::error_code ec_handshake) mutable {
+            tls_session_cache::prepare(stream_->native_handle(), endpoint.address().to_string() + ":" + std::to_string(endpoint.port()));
+            stream_->async_handshake(asio::ssl::stream_base::client, [stream = stream_, handler](std::error_code ec_handshake) mutable {
                 if (ec_handshake == asio::error::operation_aborted) {
                     return;
                 }
+                if (!ec_handshake) {
+                    tls_session_cache::handshake_completed(stream->native_handle());
+                }
                 return handler(ec_handshake);
             });
         });
@@ -0,0 +1,158 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "tls_session_cache.hxx"
+
+namespace couchbase::core::io
+{
+namespace
+{
+// slot of the SSL_CTX, which points to the cache attached to it
+int
+context_index()
+{
+    static const int index = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+void
+free_peer(void* /* parent */, void* ptr, CRYPTO_EX_DATA* /* ad */, int /* idx */, long /* argl */, void* /* argp */)
+{
+    delete static_cast<std::string*>(ptr);
+}
+
+// slot of the SSL, which holds the "host:port" of the peer, owned by the connection
+int
+peer_index()
+{
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, free_peer);
+    return index;
+}
+} // namespace
+
+tls_session_cache::~tls_session_cache()
+{
+    if (ctx_ != nullptr) {
+        SSL_CTX_set_ex_data(ctx_, context_index(), nullptr);
+    }
+    for (auto& [peer, session] : sessions_) {
+        SSL_SESSION_free(session);
+    }
+}
+
+void
+tls_session_cache::attach(SSL_CTX* ctx)
+{
+    ctx_ = ctx;
+    SSL_CTX_set_ex_data(ctx_, context_index(), this);
+    // the sessions are looked up by peer, so OpenSSL does not need to keep them in its own cache
+    SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    // called for TLS 1.2 session IDs at the end of the handshake, and for TLS 1.3 tickets whenever the server sends them
+    SSL_CTX_sess_set_new_cb(ctx_, on_new_session);
+}
+
+tls_session_cache::stats
+tls_session_cache::statistics() const
+{
+    std::scoped_lock lock(mutex_);
+    return { hits_.load(std::memory_order_relaxed), misses_.load(std::memory_order_relaxed), sessions_.size() };
+}
+
+void
+tls_session_cache::prepare(SSL* ssl, const std::string& peer)
+{
+    auto* cache = from(ssl);
+    if (cache == nullptr) {
+        return;
+    }
+    delete static_cast<std::string*>(SSL_get_ex_data(ssl, peer_index()));
+    SSL_set_ex_data(ssl, peer_index(), new std::string(peer));
+    if (auto* session = cache->find(peer); session != nullptr) {
+        SSL_set_session(ssl, session);
+        SSL_SESSION_free(session);
+    }
+}
+
+void
+tls_session_cache::handshake_completed(SSL* ssl)
+{
+    auto* cache = from(ssl);
+    if (cache == nullptr) {
+        return;
+    }
+    if (SSL_session_reused(ssl) != 0) {
+        cache->hits_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        cache->misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int
+tls_session_cache::on_new_session(SSL* ssl, SSL_SESSION* session)
+{
+    auto* cache = from(ssl);
+    const auto* peer = static_cast<const std::string*>(SSL_get_ex_data(ssl, peer_index()));
+    if (cache != nullptr && peer != nullptr) {
+        // Connections are closed without TLS shutdown, which makes OpenSSL mark their session as not resumable, so the
+        // cache keeps its own copy, and OpenSSL keeps the ownership of the original.
+        if (auto* copy = SSL_SESSION_dup(session); copy != nullptr) {
+            cache->store(*peer, copy);
+        }
+    }
+    return 0;
+}
+
+tls_session_cache*
+tls_session_cache::from(SSL* ssl)
+{
+    return static_cast<tls_session_cache*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), context_index()));
+}
+
+void
+tls_session_cache::store(const std::string& peer, SSL_SESSION* session)
+{
+    std::scoped_lock lock(mutex_);
+    if (auto it = sessions_.find(peer); it != sessions_.end()) {
+        SSL_SESSION_free(it->second);
+        it->second = session;
+        return;
+    }
+    if (sessions_.size() >= max_entries) {
+        auto victim = sessions_.begin();
+        SSL_SESSION_free(victim->second);
+        sessions_.erase(victim);
+    }
+    sessions_.try_emplace(peer, session);
+}
+
+SSL_SESSION*
+tls_session_cache::find(const std::string& peer)
+{
+    std::scoped_lock lock(mutex_);
+    auto it = sessions_.find(peer);
+    if (it == sessions_.end()) {
+        return nullptr;
+    }
+    if (SSL_SESSION_is_resumable(it->second) == 0) {
+        SSL_SESSION_free(it->second);
+        sessions_.erase(it);
+        return nullptr;
+    }
+    // the connection gets a copy for the same reason the cache stores one
+    return SSL_SESSION_dup(it->second);
+}
+} // namespace couchbase::core::io
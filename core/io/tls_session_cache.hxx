@@ -0,0 +1,88 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/ssl.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace couchbase::core::io
+{
+/**
+ * Client-side cache of TLS sessions (session IDs and tickets), keyed by "host:port" of the peer.
+ *
+ * Once attached to the TLS context, every connection created from that context (KV and HTTP alike) stores the sessions
+ * negotiated with the server, and offers them back on the next handshake with the same peer, so that reconnects and new
+ * pooled connections resume the session instead of paying for a full handshake.
+ */
+class tls_session_cache
+{
+  public:
+    static constexpr std::size_t max_entries{ 1024 };
+
+    struct stats {
+        /** handshakes which resumed a cached session */
+        std::uint64_t hits{};
+        /** full handshakes */
+        std::uint64_t misses{};
+        std::size_t size{};
+    };
+
+    tls_session_cache() = default;
+    tls_session_cache(const tls_session_cache&) = delete;
+    tls_session_cache(tls_session_cache&&) = delete;
+    tls_session_cache& operator=(const tls_session_cache&) = delete;
+    tls_session_cache& operator=(tls_session_cache&&) = delete;
+    ~tls_session_cache();
+
+    /**
+     * Enables client session caching on the context, and makes connections of this context use this cache.
+     */
+    void attach(SSL_CTX* ctx);
+
+    [[nodiscard]] stats statistics() const;
+
+    /**
+     * Must be called before the handshake. Remembers the peer of the connection, and offers the cached session if any.
+     * Does nothing if the context of the connection does not have a cache attached.
+     */
+    static void prepare(SSL* ssl, const std::string& peer);
+
+    /**
+     * Must be called after successful handshake to account for resumed and full handshakes.
+     */
+    static void handshake_completed(SSL* ssl);
+
+  private:
+    static int on_new_session(SSL* ssl, SSL_SESSION* session);
+    static tls_session_cache* from(SSL* ssl);
+
+    void store(const std::string& peer, SSL_SESSION* session);
+    SSL_SESSION* find(const std::string& peer);
+
+    SSL_CTX* ctx_{ nullptr };
+    mutable std::mutex mutex_{};
+    std::map<std::string, SSL_SESSION*> sessions_{};
+    std::atomic<std::uint64_t> hits_{ 0 };
+    std::atomic<std::uint64_t> misses_{ 0 };
+};
+} // namespace couchbase::core::io
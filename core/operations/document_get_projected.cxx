@@ -26,7 +26,7 @@
 namespace couchbase::core::operations
 {
 
-static std::optional<tao::json::value>
+std::optional<tao::json::value>
 subdoc_lookup(tao::json::value& root, const std::string& path)
 {
     std::string::size_type offset = 0;
@@ -73,7 +73,7 @@ subdoc_lookup(tao::json::value& root, const std::string& path)
     return {};
 }
 
-static void
+void
 subdoc_apply_projection(tao::json::value& root, const std::string& path, tao::json::value& value, bool preserve_array_indexes)
 {
     std::string::size_type offset = 0;
@@ -26,6 +26,12 @@
 #include "core/public_fwd.hxx"
 #include "core/timeout_defaults.hxx"
 
+#include <tao/json/forward.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace couchbase::core::operations
 {
 
@@ -58,6 +64,18 @@ struct get_projected_request {
     [[nodiscard]] get_projected_response make_response(key_value_error_context&& ctx, const encoded_response_type& encoded) const;
 };
 
+/**
+ * Looks up the value at the subdocument @p path in @p root.
+ */
+std::optional<tao::json::value>
+subdoc_lookup(tao::json::value& root, const std::string& path);
+
+/**
+ * Stores @p value at the subdocument @p path of @p root, creating the intermediate objects and arrays.
+ */
+void
+subdoc_apply_projection(tao::json::value& root, const std::string& path, tao::json::value& value, bool preserve_array_indexes);
+
 } // namespace couchbase::core::operations
 
 namespace couchbase::core::io::mcbp_traits
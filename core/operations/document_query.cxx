@@ -27,12 +27,145 @@
 
 #include <gsl/assert>
 
+#include <algorithm>
+#include <array>
+#include <string_view>
+
 namespace couchbase::core::operations
 {
+namespace
+{
+/* keys, which the request encodes itself even if the rest of the options comes from query_body_template */
+bool
+is_per_request_key(std::string_view key)
+{
+    static constexpr std::array<std::string_view, 10> keys{
+        "args", "auto_execute", "client_context_id", "encoded_plan", "prepared", "scan_consistency", "scan_vectors", "scan_wait",
+        "statement", "timeout",
+    };
+    return key.empty() || key[0] == '$' || std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+/* adds the options, which do not depend on the parameters, timeout or scan consistency of the request */
+void
+encode_options(const query_request& request, tao::json::value& body)
+{
+    switch (request.profile) {
+        case couchbase::query_profile::phases:
+            body["profile"] = "phases";
+            break;
+        case couchbase::query_profile::timings:
+            body["profile"] = "timings";
+            break;
+        case couchbase::query_profile::off:
+            break;
+    }
+    if (request.use_replica.has_value()) {
+        if (request.use_replica.value()) {
+            body["use_replica"] = "on";
+        } else {
+            body["use_replica"] = "off";
+        }
+    }
+    if (request.max_parallelism) {
+        body["max_parallelism"] = std::to_string(request.max_parallelism.value());
+    }
+    if (request.pipeline_cap) {
+        body["pipeline_cap"] = std::to_string(request.pipeline_cap.value());
+    }
+    if (request.pipeline_batch) {
+        body["pipeline_batch"] = std::to_string(request.pipeline_batch.value());
+    }
+    if (request.scan_cap) {
+        body["scan_cap"] = std::to_string(request.scan_cap.value());
+    }
+    if (!request.metrics) {
+        body["metrics"] = false;
+    }
+    if (request.readonly) {
+        body["readonly"] = true;
+    }
+    if (request.flex_index) {
+        body["use_fts"] = true;
+    }
+    if (request.preserve_expiry) {
+        body["preserve_expiry"] = true;
+    }
+    if (request.query_context) {
+        body["query_context"] = request.query_context.value();
+    }
+    for (const auto& [name, value] : request.raw) {
+        body[name] = utils::json::parse(value);
+    }
+}
+
+bool
+same_json_string(const json_string& lhs, const json_string& rhs)
+{
+    return lhs.is_string() == rhs.is_string() && lhs.is_binary() == rhs.is_binary() && lhs.str() == rhs.str() && lhs.bytes() == rhs.bytes();
+}
+
+/* inserts the members of another JSON object (without the braces) before the closing brace of the encoded object */
+std::string
+splice_members(std::string object, const std::string& members)
+{
+    if (members.empty()) {
+        return object;
+    }
+    object.pop_back();
+    if (object.size() > 1) {
+        object.push_back(',');
+    }
+    object.append(members);
+    object.push_back('}');
+    return object;
+}
+} // namespace
+
+query_body_template::options_key
+query_body_template::key_of(const query_request& request)
+{
+    return {
+        request.statement,
+        request.profile,
+        request.metrics,
+        request.readonly,
+        request.flex_index,
+        request.preserve_expiry,
+        request.use_replica,
+        request.max_parallelism,
+        request.scan_cap,
+        request.pipeline_batch,
+        request.pipeline_cap,
+        request.query_context,
+        request.raw,
+    };
+}
+
+bool
+query_body_template::matches(const query_request& request) const
+{
+    if (!key_) {
+        return false;
+    }
+    const auto& key = key_.value();
+    return key.statement == request.statement && key.profile == request.profile && key.metrics == request.metrics &&
+           key.readonly == request.readonly && key.flex_index == request.flex_index && key.preserve_expiry == request.preserve_expiry &&
+           key.use_replica == request.use_replica && key.max_parallelism == request.max_parallelism && key.scan_cap == request.scan_cap &&
+           key.pipeline_batch == request.pipeline_batch && key.pipeline_cap == request.pipeline_cap &&
+           key.query_context == request.query_context &&
+           std::equal(key.raw.begin(), key.raw.end(), request.raw.begin(), request.raw.end(), [](const auto& lhs, const auto& rhs) {
+               return lhs.first == rhs.first && same_json_string(lhs.second, rhs.second);
+           });
+}
+
 std::error_code
 query_request::encode_to(query_request::encoded_request_type& encoded, http_context& context)
 {
     ctx_.emplace(context);
+    if (use_replica.has_value() && !context.config.supports_read_from_replica()) {
+        return errc::common::feature_not_available;
+    }
     tao::json::value body{
         { "client_context_id", encoded.client_context_id },
     };
@@ -75,94 +208,72 @@ query_request::encode_to(query_request::encoded_request_type& encoded, http_cont
         }
         body["args"] = std::move(parameters);
     }
-    switch (profile) {
-        case couchbase::query_profile::phases:
-            body["profile"] = "phases";
-            break;
-        case couchbase::query_profile::timings:
-            body["profile"] = "timings";
-            break;
-        case couchbase::query_profile::off:
-            break;
-    }
-    if (use_replica.has_value()) {
-        if (context.config.supports_read_from_replica()) {
-            if (use_replica.value()) {
-                body["use_replica"] = "on";
-            } else {
-                body["use_replica"] = "off";
-            }
-        } else {
-            return errc::common::feature_not_available;
-        }
-    }
-    if (max_parallelism) {
-        body["max_parallelism"] = std::to_string(max_parallelism.value());
-    }
-    if (pipeline_cap) {
-        body["pipeline_cap"] = std::to_string(pipeline_cap.value());
-    }
-    if (pipeline_batch) {
-        body["pipeline_batch"] = std::to_string(pipeline_batch.value());
-    }
-    if (scan_cap) {
-        body["scan_cap"] = std::to_string(scan_cap.value());
-    }
-    if (!metrics) {
-        body["metrics"] = false;
-    }
-    if (readonly) {
-        body["readonly"] = true;
-    }
-    if (flex_index) {
-        body["use_fts"] = true;
-    }
-    if (preserve_expiry) {
-        body["preserve_expiry"] = true;
-    }
-    bool check_scan_wait = false;
     if (scan_consistency) {
         switch (scan_consistency.value()) {
             case query_scan_consistency::not_bounded:
                 body["scan_consistency"] = "not_bounded";
                 break;
             case query_scan_consistency::request_plus:
-                check_scan_wait = true;
                 body["scan_consistency"] = "request_plus";
+                if (scan_wait) {
+                    body["scan_wait"] = fmt::format("{}ms", scan_wait.value().count());
+                }
                 break;
         }
     } else if (!mutation_state.empty()) {
-        check_scan_wait = true;
         body["scan_consistency"] = "at_plus";
         tao::json::value scan_vectors = tao::json::empty_object;
+        /* the tokens of couchbase::mutation_state are grouped by bucket, so the lookup is only needed when the bucket changes */
+        std::string bucket_name{};
+        tao::json::value::object_t* bucket_obj = nullptr;
         for (const auto& token : mutation_state) {
-            auto* bucket = scan_vectors.find(token.bucket_name());
-            if (bucket == nullptr) {
-                scan_vectors[token.bucket_name()] = tao::json::empty_object;
-                bucket = scan_vectors.find(token.bucket_name());
+            if (bucket_obj == nullptr || token.bucket_name() != bucket_name) {
+                bucket_name = token.bucket_name();
+                auto* bucket = scan_vectors.find(bucket_name);
+                if (bucket == nullptr) {
+                    scan_vectors[bucket_name] = tao::json::empty_object;
+                    bucket = scan_vectors.find(bucket_name);
+                }
+                bucket_obj = &bucket->get_object();
+            }
+            auto partition = std::to_string(token.partition_id());
+            if (auto entry = bucket_obj->find(partition);
+                entry != bucket_obj->end() && entry->second.get_array().at(0).get_unsigned() >= token.sequence_number()) {
+                continue;
             }
-            auto& bucket_obj = bucket->get_object();
-            bucket_obj[std::to_string(token.partition_id())] =
-              std::vector<tao::json::value>{ token.sequence_number(), std::to_string(token.partition_uuid()) };
+            (*bucket_obj)[partition] = std::vector<tao::json::value>{ token.sequence_number(), std::to_string(token.partition_uuid()) };
         }
         body["scan_vectors"] = scan_vectors;
-    }
-    if (check_scan_wait && scan_wait) {
-        body["scan_wait"] = fmt::format("{}ms", scan_wait.value().count());
+        if (scan_wait) {
+            body["scan_wait"] = fmt::format("{}ms", scan_wait.value().count());
+        }
     }
 
-    if (query_context) {
-        body["query_context"] = query_context.value();
+    std::shared_ptr<const std::string> template_options{};
+    if (body_template && std::none_of(raw.begin(), raw.end(), [](const auto& entry) { return is_per_request_key(entry.first); })) {
+        std::scoped_lock lock(body_template->mutex_);
+        if (!body_template->key_) {
+            tao::json::value options = tao::json::empty_object;
+            encode_options(*this, options);
+            auto members = utils::json::generate(options);
+            body_template->key_ = query_body_template::key_of(*this);
+            body_template->options_ = std::make_shared<const std::string>(members.substr(1, members.size() - 2));
+        }
+        if (body_template->matches(*this)) {
+            template_options = body_template->options_;
+        }
     }
-    for (const auto& [name, value] : raw) {
-        body[name] = utils::json::parse(value);
+    if (template_options) {
+        body_str = splice_members(utils::json::generate(body), *template_options);
+    } else {
+        encode_options(*this, body);
+        body_str = utils::json::generate(body);
     }
     encoded.type = type;
     encoded.headers["connection"] = "keep-alive";
     encoded.headers["content-type"] = "application/json";
     encoded.method = "POST";
     encoded.path = "/query/service";
-    body_str = utils::json::generate(body);
     encoded.body = body_str;
 
     tao::json::value stmt = body["statement"];
@@ -175,18 +286,24 @@ query_request::encode_to(query_request::encoded_request_type& encoded, http_cont
     }
     body.erase("statement");
     body.erase("prepared");
+    auto options_to_log = [&body, &template_options]() {
+        if (template_options) {
+            return splice_members(utils::json::generate(body), *template_options);
+        }
+        return utils::json::generate(body);
+    };
     if (ctx_->options.show_queries) {
         CB_LOG_INFO("QUERY: client_context_id=\"{}\", prep={}, {}, options={}",
                     encoded.client_context_id,
                     utils::json::generate(prep),
                     utils::json::generate(stmt),
-                    utils::json::generate(body));
+                    options_to_log());
     } else {
         CB_LOG_DEBUG("QUERY: client_context_id=\"{}\", prep={}, {}, options={}",
                      encoded.client_context_id,
                      utils::json::generate(prep),
                      utils::json::generate(stmt),
-                     utils::json::generate(body));
+                     options_to_log());
     }
     if (row_callback) {
         encoded.streaming.emplace(couchbase::core::io::streaming_settings{
@@ -31,6 +31,9 @@
 
 #include <couchbase/mutation_token.hxx>
 
+#include <memory>
+#include <mutex>
+
 namespace couchbase::tracing
 {
 class request_span;
@@ -75,6 +78,55 @@ struct query_response {
     std::string served_by_node{};
 };
 
+struct query_request;
+
+/**
+ * Encoded part of the query request body, which does not change between executions of the same statement with the same options.
+ *
+ * The first request, which uses the template, fills it with the options, e.g. profile, query_context and raw. The following requests
+ * sharing the template only encode the statement (or the name of the prepared statement), the parameters, client_context_id, timeout
+ * and the scan consistency, and splice the cached options into the body.
+ *
+ * The template remembers the statement and the options it has been filled from. The request with another statement or other options,
+ * or with raw options which are encoded for every request, encodes the full body as if there was no template.
+ */
+class query_body_template
+{
+  public:
+    query_body_template() = default;
+    query_body_template(const query_body_template&) = delete;
+    query_body_template& operator=(const query_body_template&) = delete;
+
+  private:
+    friend struct query_request;
+
+    /* the statement and the options of the request, which has filled the template */
+    struct options_key {
+        std::string statement{};
+        query_profile profile{ query_profile::off };
+        bool metrics{ false };
+        bool readonly{ false };
+        bool flex_index{ false };
+        bool preserve_expiry{ false };
+        std::optional<bool> use_replica{};
+        std::optional<std::uint64_t> max_parallelism{};
+        std::optional<std::uint64_t> scan_cap{};
+        std::optional<std::uint64_t> pipeline_batch{};
+        std::optional<std::uint64_t> pipeline_cap{};
+        std::optional<std::string> query_context{};
+        std::map<std::string, couchbase::core::json_string, std::less<>> raw{};
+    };
+
+    [[nodiscard]] static options_key key_of(const query_request& request);
+    [[nodiscard]] bool matches(const query_request& request) const;
+
+    // the requests are encoded on the IO threads
+    std::mutex mutex_{};
+    std::optional<options_key> key_{};
+    // members of the JSON object with the options without the braces, once the first request has filled the template
+    std::shared_ptr<const std::string> options_{};
+};
+
 struct query_request {
     using response_type = query_response;
     using encoded_request_type = io::http_request;
@@ -110,6 +162,7 @@ struct query_request {
     std::map<std::string, couchbase::core::json_string, std::less<>> named_parameters{};
     std::optional<std::function<utils::json::stream_control(std::string)>> row_callback{};
     std::optional<std::string> send_to_node{};
+    std::shared_ptr<query_body_template> body_template{};
 
     [[nodiscard]] std::error_code encode_to(encoded_request_type& encoded, http_context& context);
 
@@ -21,6 +21,7 @@
 #include "core/error_context/http.hxx"
 #include "core/io/http_context.hxx"
 #include "core/io/http_message.hxx"
+#include "core/io/http_traits.hxx"
 #include "core/platform/uuid.h"
 #include "core/timeout_defaults.hxx"
 
@@ -50,3 +51,10 @@ struct analytics_get_pending_mutations_request {
                                                                          const encoded_response_type& encoded) const;
 };
 } // namespace couchbase::core::operations::management
+
+namespace couchbase::core::io::http_traits
+{
+template<>
+struct supports_pipelining<couchbase::core::operations::management::analytics_get_pending_mutations_request> : public std::true_type {
+};
+} // namespace couchbase::core::io::http_traits
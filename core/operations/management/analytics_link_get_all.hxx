@@ -20,6 +20,7 @@
 #include "core/error_context/http.hxx"
 #include "core/io/http_context.hxx"
 #include "core/io/http_message.hxx"
+#include "core/io/http_traits.hxx"
 #include "core/management/analytics_link.hxx"
 #include "core/platform/uuid.h"
 #include "core/timeout_defaults.hxx"
@@ -61,3 +62,10 @@ struct analytics_link_get_all_request {
     [[nodiscard]] analytics_link_get_all_response make_response(error_context::http&& ctx, const encoded_response_type& encoded) const;
 };
 } // namespace couchbase::core::operations::management
+
+namespace couchbase::core::io::http_traits
+{
+template<>
+struct supports_pipelining<couchbase::core::operations::management::analytics_link_get_all_request> : public std::true_type {
+};
+} // namespace couchbase::core::io::http_traits
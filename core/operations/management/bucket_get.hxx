@@ -20,6 +20,7 @@
 #include "core/error_context/http.hxx"
 #include "core/io/http_context.hxx"
 #include "core/io/http_message.hxx"
+#include "core/io/http_traits.hxx"
 #include "core/management/bucket_settings.hxx"
 #include "core/platform/uuid.h"
 #include "core/timeout_defaults.hxx"
@@ -49,3 +50,10 @@ struct bucket_get_request {
     [[nodiscard]] bucket_get_response make_response(error_context::http&& ctx, const encoded_response_type& encoded) const;
 };
 } // namespace couchbase::core::operations::management
+
+namespace couchbase::core::io::http_traits
+{
+template<>
+struct supports_pipelining<couchbase::core::operations::management::bucket_get_request> : public std::true_type {
+};
+} // namespace couchbase::core::io::http_traits
@@ -20,6 +20,7 @@
 #include "core/error_context/http.hxx"
 #include "core/io/http_context.hxx"
 #include "core/io/http_message.hxx"
+#include "core/io/http_traits.hxx"
 #include "core/platform/uuid.h"
 #include "core/service_type.hxx"
 #include "core/timeout_defaults.hxx"
@@ -70,3 +71,10 @@ struct cluster_describe_request {
     [[nodiscard]] cluster_describe_response make_response(error_context::http&& ctx, const encoded_response_type& encoded) const;
 };
 } // namespace couchbase::core::operations::management
+
+namespace couchbase::core::io::http_traits
+{
+template<>
+struct supports_pipelining<couchbase::core::operations::management::cluster_describe_request> : public std::true_type {
+};
+} // namespace couchbase::core::io::http_traits
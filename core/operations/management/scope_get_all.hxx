@@ -20,6 +20,7 @@
 #include "core/error_context/http.hxx"
 #include "core/io/http_context.hxx"
 #include "core/io/http_message.hxx"
+#include "core/io/http_traits.hxx"
 #include "core/platform/uuid.h"
 #include "core/timeout_defaults.hxx"
 #include "core/topology/collections_manifest.hxx"
@@ -49,3 +50,10 @@ struct scope_get_all_request {
     [[nodiscard]] scope_get_all_response make_response(error_context::http&& ctx, const encoded_response_type& encoded) const;
 };
 } // namespace couchbase::core::operations::management
+
+namespace couchbase::core::io::http_traits
+{
+template<>
+struct supports_pipelining<couchbase::core::operations::management::scope_get_all_request> : public std::true_type {
+};
+} // namespace couchbase::core::io::http_traits
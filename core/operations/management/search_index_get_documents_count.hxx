@@ -20,6 +20,7 @@
 #include "core/error_context/http.hxx"
 #include "core/io/http_context.hxx"
 #include "core/io/http_message.hxx"
+#include "core/io/http_traits.hxx"
 #include "core/platform/uuid.h"
 #include "core/timeout_defaults.hxx"
 
@@ -51,3 +52,10 @@ struct search_index_get_documents_count_request {
                                                                           const encoded_response_type& encoded) const;
 };
 } // namespace couchbase::core::operations::management
+
+namespace couchbase::core::io::http_traits
+{
+template<>
+struct supports_pipelining<couchbase::core::operations::management::search_index_get_documents_count_request> : public std::true_type {
+};
+} // namespace couchbase::core::io::http_traits
@@ -59,6 +59,22 @@ struct traits<couchbase::core::tls_verify_mode> {
     }
 };
 
+template<>
+struct traits<couchbase::core::http_node_selection_policy> {
+    template<template<typename...> class Traits>
+    static void assign(tao::json::basic_value<Traits>& v, const couchbase::core::http_node_selection_policy& o)
+    {
+        switch (o) {
+            case couchbase::core::http_node_selection_policy::round_robin:
+                v = "round_robin";
+                break;
+            case couchbase::core::http_node_selection_policy::power_of_two_choices:
+                v = "power_of_two_choices";
+                break;
+        }
+    }
+};
+
 template<>
 struct traits<couchbase::core::io::ip_protocol> {
     template<template<typename...> class Traits>
@@ -231,6 +247,7 @@ origin::to_json() const -> std::string
             { "enable_tcp_keep_alive", options_.enable_tcp_keep_alive },
             { "use_ip_protocol", options_.use_ip_protocol },
             { "enable_dns_srv", options_.enable_dns_srv },
+            { "enable_parallel_bootstrap", options_.enable_parallel_bootstrap },
             { "dns_config", options_.dns_config },
             { "show_queries", options_.show_queries },
             { "enable_unordered_execution", options_.enable_unordered_execution },
@@ -243,6 +260,9 @@ origin::to_json() const -> std::string
             { "config_poll_floor", options_.config_poll_floor },
             { "config_idle_redial_timeout", options_.config_idle_redial_timeout },
             { "max_http_connections", options_.max_http_connections },
+            { "min_idle_http_connections", options_.min_idle_http_connections },
+            { "http_node_selection", options_.http_node_selection },
+            { "enable_http_pipelining", options_.enable_http_pipelining },
             { "idle_http_connection_timeout", options_.idle_http_connection_timeout },
             { "user_agent_extra", options_.user_agent_extra },
             { "dump_configuration", options_.dump_configuration },
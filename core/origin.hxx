@@ -138,6 +138,11 @@ struct origin {
         return res;
     }
 
+    [[nodiscard]] const node_list& get_node_list() const
+    {
+        return nodes_;
+    }
+
     void set_nodes(node_list nodes)
     {
         nodes_ = std::move(nodes);
@@ -0,0 +1,115 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2016 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "salted_password_cache.h"
+
+#include <algorithm>
+
+namespace couchbase::core::sasl::mechanism::scram
+{
+
+/**
+ * Overwrite the string with zeros in a way the compiler is not allowed to
+ * optimize away, and release it
+ */
+static void
+secureZero(std::string& data)
+{
+    volatile char* ptr = data.data();
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        ptr[i] = 0;
+    }
+    data.clear();
+    data.shrink_to_fit();
+}
+
+SaltedPasswordCache&
+SaltedPasswordCache::instance()
+{
+    static SaltedPasswordCache cache;
+    return cache;
+}
+
+SaltedPasswordCache::~SaltedPasswordCache()
+{
+    clear();
+}
+
+std::string
+SaltedPasswordCache::get(Mechanism mechanism,
+                         couchbase::core::crypto::Algorithm algorithm,
+                         const std::string& user,
+                         const std::string& password,
+                         const std::string& salt,
+                         unsigned int iterationCount)
+{
+    auto passwordDigest = couchbase::core::crypto::digest(couchbase::core::crypto::Algorithm::SHA256, password);
+    auto matches = [&](const Entry& entry) {
+        return entry.mechanism == mechanism && entry.iterationCount == iterationCount && entry.user == user && entry.salt == salt &&
+               entry.passwordDigest == passwordDigest;
+    };
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (auto it = std::find_if(entries.begin(), entries.end(), matches); it != entries.end()) {
+            entries.splice(entries.begin(), entries, it);
+            secureZero(passwordDigest);
+            return it->saltedPassword;
+        }
+    }
+
+    // derive outside of the lock, concurrent handshakes for other users should not wait for it
+    auto saltedPassword = couchbase::core::crypto::PBKDF2_HMAC(algorithm, password, salt, iterationCount);
+
+    std::lock_guard<std::mutex> guard(mutex);
+    if (std::find_if(entries.begin(), entries.end(), matches) == entries.end()) {
+        entries.push_front({ mechanism, user, salt, iterationCount, std::move(passwordDigest), saltedPassword });
+        if (entries.size() > capacity) {
+            erase(entries.back());
+            entries.pop_back();
+        }
+    } else {
+        secureZero(passwordDigest);
+    }
+    return saltedPassword;
+}
+
+void
+SaltedPasswordCache::clear()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto& entry : entries) {
+        erase(entry);
+    }
+    entries.clear();
+}
+
+std::size_t
+SaltedPasswordCache::size() const
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return entries.size();
+}
+
+void
+SaltedPasswordCache::erase(Entry& entry)
+{
+    secureZero(entry.saltedPassword);
+    secureZero(entry.passwordDigest);
+}
+
+} // namespace couchbase::core::sasl::mechanism::scram
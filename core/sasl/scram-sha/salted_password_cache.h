@@ -0,0 +1,92 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2016 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+#pragma once
+
+#include "core/crypto/cbcrypto.h"
+#include "core/sasl/mechanism.h"
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+
+namespace couchbase::core::sasl::mechanism::scram
+{
+
+/**
+ * Process-wide cache of the SaltedPassword of SCRAM (Hi(password, salt, i)
+ * in https://www.ietf.org/rfc/rfc5802.txt).
+ *
+ * All nodes of the cluster hand out the same salt and iteration count for a
+ * user, so without the cache every connection (nodes x buckets x reconnects)
+ * would run the same PBKDF2 derivation again.
+ *
+ * The entries are keyed by mechanism, user, salt, iteration count and a
+ * digest of the password, so a changed password never matches an old entry.
+ * The least recently used entry is evicted once the cache is full, and its
+ * secrets are overwritten with zeros before the memory is released.
+ */
+class SaltedPasswordCache
+{
+  public:
+    static constexpr std::size_t capacity = 64;
+
+    static SaltedPasswordCache& instance();
+
+    SaltedPasswordCache() = default;
+    SaltedPasswordCache(const SaltedPasswordCache&) = delete;
+    SaltedPasswordCache& operator=(const SaltedPasswordCache&) = delete;
+    ~SaltedPasswordCache();
+
+    /**
+     * Get the salted password, running PBKDF2 only if it is not cached yet
+     *
+     * @throws std::invalid_argument - unsupported algorithm
+     *         std::runtime_error - Failures generating the salted password
+     */
+    std::string get(Mechanism mechanism,
+                    couchbase::core::crypto::Algorithm algorithm,
+                    const std::string& user,
+                    const std::string& password,
+                    const std::string& salt,
+                    unsigned int iterationCount);
+
+    /**
+     * Securely remove all entries
+     */
+    void clear();
+
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    struct Entry {
+        Mechanism mechanism;
+        std::string user;
+        std::string salt;
+        unsigned int iterationCount;
+        std::string passwordDigest;
+        std::string saltedPassword;
+    };
+
+    static void erase(Entry& entry);
+
+    mutable std::mutex mutex;
+    // most recently used at the front
+    std::list<Entry> entries;
+};
+
+} // namespace couchbase::core::sasl::mechanism::scram
@@ -22,6 +22,7 @@
 #include "core/platform/base64.h"
 #include "core/platform/random.h"
 #include "core/platform/string_hex.h"
+#include "salted_password_cache.h"
 #include "stringutils.h"
 
 #include <cstring>
@@ -362,7 +363,7 @@ bool
 ClientBackend::generateSaltedPassword(const std::string& secret)
 {
     try {
-        saltedPassword = couchbase::core::crypto::PBKDF2_HMAC(algorithm, secret, salt, iterationCount);
+        saltedPassword = SaltedPasswordCache::instance().get(mechanism, algorithm, usernameCallback(), secret, salt, iterationCount);
         return true;
     } catch (...) {
         return false;
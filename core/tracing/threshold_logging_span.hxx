@@ -0,0 +1,250 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "constants.hxx"
+#include "core/service_type.hxx"
+
+#include <couchbase/tracing/request_span.hxx>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace couchbase::core::tracing
+{
+class threshold_logging_tracer;
+
+// attributes of the span which end up in the threshold and orphan reports, any other tags are dropped
+enum class span_attribute : std::uint8_t {
+    operation_id,
+    local_id,
+    local_socket,
+    remote_socket,
+};
+
+constexpr std::size_t number_of_span_attributes{ 4 };
+
+constexpr std::optional<span_attribute>
+span_attribute_from_name(std::string_view name)
+{
+    if (name == attributes::operation_id) {
+        return span_attribute::operation_id;
+    }
+    if (name == attributes::local_id) {
+        return span_attribute::local_id;
+    }
+    if (name == attributes::local_socket) {
+        return span_attribute::local_socket;
+    }
+    if (name == attributes::remote_socket) {
+        return span_attribute::remote_socket;
+    }
+    return {};
+}
+
+constexpr std::optional<service_type>
+service_from_name(std::string_view name)
+{
+    if (name == tracing::service::key_value) {
+        return service_type::key_value;
+    }
+    if (name == tracing::service::query) {
+        return service_type::query;
+    }
+    if (name == tracing::service::view) {
+        return service_type::view;
+    }
+    if (name == tracing::service::search) {
+        return service_type::search;
+    }
+    if (name == tracing::service::analytics) {
+        return service_type::analytics;
+    }
+    if (name == tracing::service::management) {
+        return service_type::management;
+    }
+    return {};
+}
+
+/**
+ * Service of the spans started by the KV and HTTP commands, which is known from their names, so that the threshold
+ * logging span does not need to wait for the service tag.
+ */
+constexpr std::optional<service_type>
+service_from_span_name(std::string_view name)
+{
+    constexpr std::array key_value_operations{
+        operation::mcbp_get,
+        operation::mcbp_get_replica,
+        operation::mcbp_upsert,
+        operation::mcbp_replace,
+        operation::mcbp_insert,
+        operation::mcbp_remove,
+        operation::mcbp_get_and_lock,
+        operation::mcbp_get_and_touch,
+        operation::mcbp_exists,
+        operation::mcbp_touch,
+        operation::mcbp_unlock,
+        operation::mcbp_lookup_in,
+        operation::mcbp_mutate_in,
+        operation::mcbp_append,
+        operation::mcbp_prepend,
+        operation::mcbp_increment,
+        operation::mcbp_decrement,
+        operation::mcbp_observe,
+        operation::mcbp_range_scan_create,
+        operation::mcbp_range_scan_continue,
+        operation::mcbp_range_scan_cancel,
+        operation::mcbp_internal,
+    };
+    for (std::string_view operation_name : key_value_operations) {
+        if (name == operation_name) {
+            return service_type::key_value;
+        }
+    }
+    if (name == operation::http_query) {
+        return service_type::query;
+    }
+    if (name == operation::http_analytics) {
+        return service_type::analytics;
+    }
+    if (name == operation::http_search) {
+        return service_type::search;
+    }
+    if (name == operation::http_views) {
+        return service_type::view;
+    }
+    // the spans of the specific managers are named like "cb.manager_query"
+    if (std::string_view manager{ operation::http_manager }; name.substr(0, manager.size()) == manager) {
+        return service_type::management;
+    }
+    return {};
+}
+
+class threshold_logging_span
+  : public couchbase::tracing::request_span
+  , public std::enable_shared_from_this<threshold_logging_span>
+{
+  private:
+    std::chrono::steady_clock::time_point start_{ std::chrono::steady_clock::now() };
+    std::optional<service_type> service_{};
+    bool orphan_{ false };
+    std::array<std::string, number_of_span_attributes> attributes_{};
+    // the opaque of KV operations is kept as a number, and formatted only when the span gets reported
+    std::optional<std::uint64_t> numeric_operation_id_{};
+    std::chrono::microseconds duration_{ 0 };
+    std::uint64_t last_server_duration_us_{ 0 };
+    std::uint64_t total_server_duration_us_{ 0 };
+
+    std::shared_ptr<threshold_logging_tracer> tracer_{};
+
+  public:
+    threshold_logging_span(std::string name,
+                           std::shared_ptr<threshold_logging_tracer> tracer,
+                           std::shared_ptr<request_span> parent = nullptr)
+      : request_span(std::move(name), parent)
+      , service_{ service_from_span_name(this->name()) }
+      , tracer_{ std::move(tracer) }
+    {
+    }
+
+    void add_tag(const std::string& name, std::uint64_t value) override
+    {
+        if (name == tracing::attributes::server_duration) {
+            last_server_duration_us_ = value;
+            total_server_duration_us_ += value;
+        } else if (name == tracing::attributes::operation_id && !has_operation_id()) {
+            numeric_operation_id_ = value;
+        }
+    }
+
+    void add_tag(const std::string& name, const std::string& value) override
+    {
+        if (name == tracing::attributes::service) {
+            // the tag is only needed for the spans with names, which do not identify the service
+            if (!service_) {
+                service_ = service_from_name(value);
+            }
+        } else if (name == tracing::attributes::orphan) {
+            orphan_ = true;
+        } else if (name == tracing::attributes::operation_id) {
+            if (!has_operation_id()) {
+                attributes_[static_cast<std::size_t>(span_attribute::operation_id)] = value;
+            }
+        } else if (auto attribute = span_attribute_from_name(name); attribute) {
+            if (auto& slot = attributes_[static_cast<std::size_t>(*attribute)]; slot.empty()) {
+                slot = value;
+            }
+        }
+    }
+
+    void end() override;
+
+    [[nodiscard]] const std::string& attribute(span_attribute attribute) const
+    {
+        return attributes_[static_cast<std::size_t>(attribute)];
+    }
+
+    [[nodiscard]] std::optional<std::uint64_t> numeric_operation_id() const
+    {
+        return numeric_operation_id_;
+    }
+
+    [[nodiscard]] std::chrono::microseconds duration() const
+    {
+        return duration_;
+    }
+
+    [[nodiscard]] std::uint64_t last_server_duration_us() const
+    {
+        return last_server_duration_us_;
+    }
+
+    [[nodiscard]] std::uint64_t total_server_duration_us() const
+    {
+        return total_server_duration_us_;
+    }
+
+    [[nodiscard]] bool orphan() const
+    {
+        return orphan_;
+    }
+
+    [[nodiscard]] bool is_key_value() const
+    {
+        return service_ == service_type::key_value;
+    }
+
+    [[nodiscard]] std::optional<service_type> service() const
+    {
+        return service_;
+    }
+
+  private:
+    [[nodiscard]] bool has_operation_id() const
+    {
+        return numeric_operation_id_.has_value() || !attribute(span_attribute::operation_id).empty();
+    }
+};
+} // namespace couchbase::core::tracing
@@ -16,246 +16,173 @@
  */
 
 #include "threshold_logging_tracer.hxx"
+#include "threshold_logging_span.hxx"
 
 #include "couchbase/build_info.hxx"
 
 #include "constants.hxx"
 #include "core/logger/logger.hxx"
-#include "core/meta/version.hxx"
-#include "core/platform/uuid.h"
 #include "core/service_type_fmt.hxx"
 #include "core/utils/json.hxx"
 
 #include <asio/steady_timer.hpp>
 #include <tao/json/value.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <iterator>
+#include <map>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <thread>
+#include <vector>
 
 namespace couchbase::core::tracing
 {
-struct reported_span {
-    std::chrono::microseconds duration;
-    tao::json::value payload;
-
-    bool operator<(const reported_span& other) const
+// raw data of the span, kept until the report is emitted, so that JSON is only built for the spans that make it into
+// the report
+struct sampled_span {
+    std::chrono::microseconds duration{};
+    std::string operation_name{};
+    bool is_key_value{ false };
+    std::uint64_t last_server_duration_us{};
+    std::uint64_t total_server_duration_us{};
+    std::string operation_id{};
+    std::optional<std::uint64_t> numeric_operation_id{};
+    std::string local_id{};
+    std::string local_socket{};
+    std::string remote_socket{};
+
+    static sampled_span from(const threshold_logging_span& span)
     {
-        return duration < other.duration;
+        return {
+            span.duration(),
+            span.name(),
+            span.is_key_value(),
+            span.last_server_duration_us(),
+            span.total_server_duration_us(),
+            span.attribute(span_attribute::operation_id),
+            span.numeric_operation_id(),
+            span.attribute(span_attribute::local_id),
+            span.attribute(span_attribute::local_socket),
+            span.attribute(span_attribute::remote_socket),
+        };
     }
 };
 
-class threshold_logging_span
-  : public couchbase::tracing::request_span
-  , public std::enable_shared_from_this<threshold_logging_span>
+tao::json::value
+to_json(const sampled_span& span)
 {
-  private:
-    std::chrono::system_clock::time_point start_{ std::chrono::system_clock::now() };
-    std::string id_{ uuid::to_string(uuid::random()) };
-    std::map<std::string, std::uint64_t> integer_tags_{};
-    std::map<std::string, std::string> string_tags_{
-        { attributes::system, "couchbase" },
-        { attributes::span_kind, "client" },
-        { attributes::component, couchbase::core::meta::sdk_id() },
-    };
-    std::chrono::microseconds duration_{ 0 };
-    std::uint64_t last_server_duration_us_{ 0 };
-    std::uint64_t total_server_duration_us_{ 0 };
-
-    std::shared_ptr<threshold_logging_tracer> tracer_{};
-
-  public:
-    threshold_logging_span(std::string name,
-                           std::shared_ptr<threshold_logging_tracer> tracer,
-                           std::shared_ptr<request_span> parent = nullptr)
-      : request_span(std::move(name), parent)
-      , tracer_{ std::move(tracer) }
-    {
+    tao::json::value entry{ { "operation_name", span.operation_name }, { "total_duration_us", span.duration.count() } };
+    if (span.is_key_value) {
+        entry["last_server_duration_us"] = span.last_server_duration_us;
+        entry["total_server_duration_us"] = span.total_server_duration_us;
     }
 
-    void add_tag(const std::string& name, std::uint64_t value) override
-    {
-        if (name == tracing::attributes::server_duration) {
-            last_server_duration_us_ = value;
-            total_server_duration_us_ += value;
-        }
-        integer_tags_.try_emplace(name, value);
+    if (span.numeric_operation_id) {
+        entry["last_operation_id"] = fmt::format("0x{:x}", *span.numeric_operation_id);
+    } else if (!span.operation_id.empty()) {
+        entry["last_operation_id"] = span.operation_id;
     }
-
-    void add_tag(const std::string& name, const std::string& value) override
-    {
-        string_tags_.try_emplace(name, value);
-    }
-
-    void end() override;
-
-    [[nodiscard]] const auto& string_tags() const
-    {
-        return string_tags_;
-    }
-
-    [[nodiscard]] std::chrono::microseconds duration() const
-    {
-        return duration_;
+    if (!span.local_id.empty()) {
+        entry["last_local_id"] = span.local_id;
     }
-
-    [[nodiscard]] std::uint64_t last_server_duration_us() const
-    {
-        return last_server_duration_us_;
+    if (!span.local_socket.empty()) {
+        entry["last_local_socket"] = span.local_socket;
     }
-
-    [[nodiscard]] std::uint64_t total_server_duration_us() const
-    {
-        return total_server_duration_us_;
+    if (!span.remote_socket.empty()) {
+        entry["last_remote_socket"] = span.remote_socket;
     }
+    return entry;
+}
 
-    [[nodiscard]] bool orphan() const
-    {
-        return string_tags_.find(tracing::attributes::orphan) != string_tags_.end();
-    }
+/**
+ * Collects the slowest spans of the emit interval.
+ *
+ * Every thread records into its own stripe, which holds a bounded min-heap, so the fastest sample is the one replaced.
+ * Once a stripe is full, its fastest duration is published atomically, and spans which would not make it into the heap
+ * are rejected without taking the lock. The stripes are merged when the report is emitted.
+ */
+class span_sampler
+{
+  public:
+    static constexpr std::size_t number_of_stripes{ 16 };
 
-    [[nodiscard]] bool is_key_value() const
+    explicit span_sampler(std::size_t capacity)
+      : capacity_{ capacity }
     {
-        auto service_tag = string_tags_.find(tracing::attributes::service);
-        if (service_tag == string_tags_.end()) {
-            return false;
-        }
-        return service_tag->second == tracing::service::key_value;
     }
 
-    [[nodiscard]] std::optional<service_type> service() const
+    void offer(const threshold_logging_span& span)
     {
-        auto service_tag = string_tags_.find(tracing::attributes::service);
-        if (service_tag == string_tags_.end()) {
-            return {};
-        }
-        const auto& service_name = service_tag->second;
-        if (service_name == tracing::service::key_value) {
-            return service_type::key_value;
-        }
-        if (service_name == tracing::service::query) {
-            return service_type::query;
-        }
-        if (service_name == tracing::service::view) {
-            return service_type::view;
+        if (capacity_ == 0) {
+            return;
         }
-        if (service_name == tracing::service::search) {
-            return service_type::search;
+        auto& s = local_stripe();
+        if (span.duration().count() <= s.floor_us.load(std::memory_order_relaxed)) {
+            return;
         }
-        if (service_name == tracing::service::analytics) {
-            return service_type::analytics;
+        std::scoped_lock lock(s.mutex);
+        if (s.heap.size() < capacity_) {
+            s.heap.emplace_back(sampled_span::from(span));
+            std::push_heap(s.heap.begin(), s.heap.end(), slower);
+        } else if (span.duration() > s.heap.front().duration) {
+            std::pop_heap(s.heap.begin(), s.heap.end(), slower);
+            s.heap.back() = sampled_span::from(span);
+            std::push_heap(s.heap.begin(), s.heap.end(), slower);
         }
-        if (service_name == tracing::service::management) {
-            return service_type::management;
+        if (s.heap.size() == capacity_) {
+            s.floor_us.store(s.heap.front().duration.count(), std::memory_order_relaxed);
         }
-        return {};
-    }
-};
-
-template<typename T>
-class concurrent_fixed_queue
-{
-  private:
-    std::mutex mutex_;
-    std::priority_queue<T> data_;
-    std::size_t capacity_{};
-
-  public:
-    using size_type = typename std::priority_queue<T>::size_type;
-
-    explicit concurrent_fixed_queue(std::size_t capacity)
-      : capacity_(capacity)
-    {
     }
 
-    concurrent_fixed_queue(concurrent_fixed_queue& other)
+    /**
+     * Takes the samples collected so far, and returns at most capacity of the slowest ones, slowest first.
+     */
+    std::vector<sampled_span> drain()
     {
-        std::unique_lock<std::mutex> lock(other.mutex_);
-        data_ = other.data_;
-        capacity_ = other.capacity_;
-    }
-
-    concurrent_fixed_queue(const concurrent_fixed_queue& other) = delete;
-
-    concurrent_fixed_queue(concurrent_fixed_queue&& other) noexcept
-    {
-        std::unique_lock<std::mutex> lock(other.mutex_);
-        std::swap(data_, other.data_);
-        std::swap(capacity_, other.capacity_);
-    }
-
-    void pop()
-    {
-        std::unique_lock<std::mutex> lock(mutex_);
-        data_.pop();
+        std::vector<sampled_span> merged;
+        for (auto& s : stripes_) {
+            std::vector<sampled_span> heap;
+            {
+                std::scoped_lock lock(s.mutex);
+                std::swap(heap, s.heap);
+                s.floor_us.store(-1, std::memory_order_relaxed);
+            }
+            merged.insert(merged.end(), std::make_move_iterator(heap.begin()), std::make_move_iterator(heap.end()));
+        }
+        auto keep = std::min(capacity_, merged.size());
+        std::partial_sort(merged.begin(), merged.begin() + static_cast<std::ptrdiff_t>(keep), merged.end(), slower);
+        merged.erase(merged.begin() + static_cast<std::ptrdiff_t>(keep), merged.end());
+        return merged;
     }
 
-    size_type size()
-    {
-        std::unique_lock<std::mutex> lock(mutex_);
-        return data_.size();
-    }
+  private:
+    struct stripe {
+        std::mutex mutex{};
+        std::vector<sampled_span> heap{};
+        // duration of the fastest sample when the heap is full, -1 otherwise
+        std::atomic<std::int64_t> floor_us{ -1 };
+    };
 
-    bool empty()
+    // used with the heap algorithms, it keeps the fastest sample at the front
+    static bool slower(const sampled_span& lhs, const sampled_span& rhs)
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        return data_.empty();
+        return lhs.duration > rhs.duration;
     }
 
-    void emplace(const T&& item)
+    stripe& local_stripe()
     {
-        std::unique_lock<std::mutex> lock(mutex_);
-        data_.emplace(std::forward<const T>(item));
-        if (data_.size() > capacity_) {
-            data_.pop();
-        }
+        static thread_local const std::size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % number_of_stripes;
+        return stripes_[index];
     }
 
-    std::priority_queue<T> steal_data()
-    {
-        std::priority_queue<T> data;
-        std::unique_lock<std::mutex> lock(mutex_);
-        std::swap(data, data_);
-        return data;
-    }
+    const std::size_t capacity_;
+    std::array<stripe, number_of_stripes> stripes_{};
 };
 
-using fixed_span_queue = concurrent_fixed_queue<reported_span>;
-
-reported_span
-convert(std::shared_ptr<threshold_logging_span> span)
-{
-    tao::json::value entry{ { "operation_name", span->name() },
-                            { "total_duration_us", std::chrono::duration_cast<std::chrono::microseconds>(span->duration()).count() } };
-    if (span->is_key_value()) {
-        entry["last_server_duration_us"] = span->last_server_duration_us();
-        entry["total_server_duration_us"] = span->total_server_duration_us();
-    }
-
-    const auto& tags = span->string_tags();
-    auto pair = tags.find(attributes::operation_id);
-    if (pair != tags.end()) {
-        entry["last_operation_id"] = pair->second;
-    }
-
-    pair = tags.find(attributes::local_id);
-    if (pair != tags.end()) {
-        entry["last_local_id"] = pair->second;
-    }
-
-    pair = tags.find(attributes::local_socket);
-    if (pair != tags.end()) {
-        entry["last_local_socket"] = pair->second;
-    }
-
-    pair = tags.find(attributes::remote_socket);
-    if (pair != tags.end()) {
-        entry["last_remote_socket"] = pair->second;
-    }
-
-    return { span->duration(), std::move(entry) };
-}
-
 class threshold_logging_tracer_impl
 {
   public:
@@ -263,14 +190,14 @@ class threshold_logging_tracer_impl
       : options_(options)
       , emit_orphan_report_(ctx)
       , emit_threshold_report_(ctx)
-      , orphan_queue_{ options.orphaned_sample_size }
+      , orphan_sampler_{ options.orphaned_sample_size }
     {
-        threshold_queues_.try_emplace(service_type::key_value, options.threshold_sample_size);
-        threshold_queues_.try_emplace(service_type::query, options.threshold_sample_size);
-        threshold_queues_.try_emplace(service_type::view, options.threshold_sample_size);
-        threshold_queues_.try_emplace(service_type::search, options.threshold_sample_size);
-        threshold_queues_.try_emplace(service_type::analytics, options.threshold_sample_size);
-        threshold_queues_.try_emplace(service_type::management, options.threshold_sample_size);
+        threshold_samplers_.try_emplace(service_type::key_value, options.threshold_sample_size);
+        threshold_samplers_.try_emplace(service_type::query, options.threshold_sample_size);
+        threshold_samplers_.try_emplace(service_type::view, options.threshold_sample_size);
+        threshold_samplers_.try_emplace(service_type::search, options.threshold_sample_size);
+        threshold_samplers_.try_emplace(service_type::analytics, options.threshold_sample_size);
+        threshold_samplers_.try_emplace(service_type::management, options.threshold_sample_size);
     }
 
     ~threshold_logging_tracer_impl()
@@ -296,7 +223,7 @@ class threshold_logging_tracer_impl
 
     void add_orphan(std::shared_ptr<threshold_logging_span> span)
     {
-        orphan_queue_.emplace(convert(std::move(span)));
+        orphan_sampler_.offer(*span);
     }
 
     void check_threshold(std::shared_ptr<threshold_logging_span> span)
@@ -306,9 +233,9 @@ class threshold_logging_tracer_impl
             return;
         }
         if (span->duration() > options_.threshold_for_service(service.value())) {
-            auto queue = threshold_queues_.find(service.value());
-            if (queue != threshold_queues_.end()) {
-                queue->second.emplace(convert(span));
+            auto sampler = threshold_samplers_.find(service.value());
+            if (sampler != threshold_samplers_.end()) {
+                sampler->second.offer(*span);
             }
         }
     }
@@ -340,21 +267,20 @@ class threshold_logging_tracer_impl
 
     void log_orphan_report()
     {
-        if (orphan_queue_.empty()) {
+        auto samples = orphan_sampler_.drain();
+        if (samples.empty()) {
             return;
         }
-        auto queue = orphan_queue_.steal_data();
         tao::json::value report
         {
-            { "count", queue.size() },
+            { "count", samples.size() },
 #if COUCHBASE_CXX_CLIENT_DEBUG_BUILD
               { "emit_interval_ms", options_.orphaned_emit_interval.count() }, { "sample_size", options_.orphaned_sample_size },
 #endif
         };
         tao::json::value entries = tao::json::empty_array;
-        while (!queue.empty()) {
-            entries.emplace_back(queue.top().payload);
-            queue.pop();
+        for (const auto& sample : samples) {
+            entries.emplace_back(to_json(sample));
         }
         report["top"] = entries;
         CB_LOG_WARNING("Orphan responses observed: {}", utils::json::generate(report));
@@ -362,14 +288,14 @@ class threshold_logging_tracer_impl
 
     void log_threshold_report()
     {
-        for (auto& [service, threshold_queue] : threshold_queues_) {
-            if (threshold_queue.empty()) {
+        for (auto& [service, sampler] : threshold_samplers_) {
+            auto samples = sampler.drain();
+            if (samples.empty()) {
                 continue;
             }
-            auto queue = threshold_queue.steal_data();
             tao::json::value report
             {
-                { "count", queue.size() }, { "service", fmt::format("{}", service) },
+                { "count", samples.size() }, { "service", fmt::format("{}", service) },
 #if COUCHBASE_CXX_CLIENT_DEBUG_BUILD
                   { "emit_interval_ms", options_.threshold_emit_interval.count() }, { "sample_size", options_.threshold_sample_size },
                   { "threshold_ms",
@@ -377,9 +303,8 @@ class threshold_logging_tracer_impl
 #endif
             };
             tao::json::value entries = tao::json::empty_array;
-            while (!queue.empty()) {
-                entries.emplace_back(queue.top().payload);
-                queue.pop();
+            for (const auto& sample : samples) {
+                entries.emplace_back(to_json(sample));
             }
             report["top"] = entries;
             CB_LOG_WARNING("Operations over threshold: {}", utils::json::generate(report));
@@ -390,8 +315,8 @@ class threshold_logging_tracer_impl
 
     asio::steady_timer emit_orphan_report_;
     asio::steady_timer emit_threshold_report_;
-    fixed_span_queue orphan_queue_;
-    std::map<service_type, fixed_span_queue> threshold_queues_{};
+    span_sampler orphan_sampler_;
+    std::map<service_type, span_sampler> threshold_samplers_{};
 };
 
 std::shared_ptr<couchbase::tracing::request_span>
@@ -431,7 +356,7 @@ threshold_logging_tracer::stop()
 void
 threshold_logging_span::end()
 {
-    duration_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start_);
+    duration_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_);
     tracer_->report(shared_from_this());
 }
 
@@ -25,6 +25,7 @@
 #include <future>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace couchbase::core::transactions
 {
@@ -58,6 +59,15 @@ class async_attempt_context
      */
     virtual void get_optional(const core::document_id& id, Callback&& cb) = 0;
 
+    /**
+     * Gets only the given paths of a document from the specified Couchbase collection matching the specified id.
+     *
+     * @param id the document's ID
+     * @param projections subdocument paths to fetch, all of the document when empty
+     * @param cb callback function with the projected result when successful, or a @ref transaction_operation_failed.
+     */
+    virtual void get_projected(const core::document_id& id, const std::vector<std::string>& projections, Callback&& cb) = 0;
+
     /**
      * Mutates the specified document with new content, using the document's last TransactionDocument#cas().
      *
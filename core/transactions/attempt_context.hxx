@@ -20,6 +20,7 @@
 
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace couchbase::core::transactions
 {
@@ -61,6 +62,22 @@ class attempt_context
      */
     virtual std::optional<transaction_get_result> get_optional(const core::document_id& id) = 0;
 
+    /**
+     * Gets only the given paths of a document from the specified Couchbase collection matching the specified id.
+     *
+     * The paths are fetched with the transactional metadata in a single subdocument lookup, so write-write conflicts are
+     * detected exactly as in @ref get.  The content of the result is a JSON object holding just those paths.  With no paths,
+     * this is the same as @ref get.
+     *
+     * @param id the document's ID
+     * @param projections subdocument paths to fetch
+     * @return a TransactionDocument containing the projected document
+     *
+     * @throws transaction_operation_failed which either should not be caught by the lambda, or
+     *         rethrown if it is caught.
+     */
+    virtual transaction_get_result get_projected(const core::document_id& id, const std::vector<std::string>& projections) = 0;
+
     /**
      * Mutates the specified document with new content, using the document's last TransactionDocument#cas().
      *
@@ -30,6 +30,8 @@
 
 namespace couchbase::core::transactions
 {
+// the transactional metadata takes 13 of the 16 specs allowed in a single lookup_in
+static constexpr std::size_t MAX_PROJECTED_PATHS{ 3 };
 
 // statement constants for queries
 static const std::string BEGIN_WORK{ "BEGIN WORK" };
@@ -111,9 +113,40 @@ attempt_context_impl::get(const core::document_id& id)
 }
 void
 attempt_context_impl::get(const core::document_id& id, Callback&& cb)
+{
+    get_projected(id, {}, std::move(cb));
+}
+
+transaction_get_result
+attempt_context_impl::get_projected(const core::document_id& id, const std::vector<std::string>& projections)
+{
+    auto barrier = std::make_shared<std::promise<transaction_get_result>>();
+    auto f = barrier->get_future();
+    get_projected(id, projections, [barrier](std::exception_ptr err, std::optional<transaction_get_result> res) {
+        if (err) {
+            barrier->set_exception(err);
+        } else {
+            barrier->set_value(*res);
+        }
+    });
+    return f.get();
+}
+
+void
+attempt_context_impl::get_projected(const core::document_id& id, const std::vector<std::string>& projections, Callback&& cb)
 {
     if (op_list_.get_mode().is_query()) {
-        return get_with_query(id, false, std::move(cb));
+        if (projections.empty()) {
+            return get_with_query(id, false, std::move(cb));
+        }
+        // queries return the whole document, so project it here
+        return get_with_query(
+          id, false, [projections, cb = std::move(cb)](std::exception_ptr err, std::optional<transaction_get_result> res) mutable {
+              if (res) {
+                  res = transaction_get_result::create_from(*res, transaction_get_result::project_content(res->content(), projections));
+              }
+              cb(err, std::move(res));
+          });
     }
     cache_error_async(cb, [&]() mutable {
         check_if_done(cb);
@@ -159,7 +192,8 @@ attempt_context_impl::get(const core::document_id& id, Callback&& cb)
                   }
                   return op_completed_with_callback(std::move(cb), res);
               }
-          });
+          },
+          projections);
     });
 }
 
@@ -521,9 +555,26 @@ attempt_context_impl::select_atr_if_needed_unlocked(const core::document_id id,
 template<typename Handler, typename Delay>
 void
 attempt_context_impl::check_atr_entry_for_blocking_document(const transaction_get_result& doc, Delay delay, Handler&& cb)
+{
+    std::chrono::nanoseconds wait{};
+    try {
+        wait = delay.next();
+    } catch (const retry_operation_timeout&) {
+        return cb(transaction_operation_failed(FAIL_WRITE_WRITE_CONFLICT, "document is in another transaction").retry());
+    }
+    if (wait > std::chrono::nanoseconds::zero()) {
+        return async_delay(cluster_ref()->io_context(), wait, [this, doc, delay, cb = std::forward<Handler>(cb)]() mutable {
+            check_atr_entry_for_blocking_document_now(doc, std::move(delay), std::move(cb));
+        });
+    }
+    check_atr_entry_for_blocking_document_now(doc, std::move(delay), std::forward<Handler>(cb));
+}
+
+template<typename Handler, typename Delay>
+void
+attempt_context_impl::check_atr_entry_for_blocking_document_now(const transaction_get_result& doc, Delay delay, Handler&& cb)
 {
     try {
-        delay();
         if (auto ec = hooks_.before_check_atr_entry_for_blocking_doc(this, doc.id().key())) {
             return cb(transaction_operation_failed(FAIL_WRITE_WRITE_CONFLICT, "document is in another transaction").retry());
         }
@@ -1371,119 +1422,137 @@ attempt_context_impl::rollback_with_query(VoidCallback&& cb)
                });
 }
 void
-attempt_context_impl::atr_commit(bool ambiguity_resolution_mode)
+attempt_context_impl::atr_commit(bool ambiguity_resolution_mode, VoidCallback&& cb)
 {
-    retry_op<void>([this, &ambiguity_resolution_mode]() {
-        try {
-            std::string prefix(ATR_FIELD_ATTEMPTS + "." + id() + ".");
-            core::operations::mutate_in_request req{ atr_id_.value() };
-            req.specs =
-              couchbase::mutate_in_specs{
-                  couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_STATUS, attempt_state_name(attempt_state::COMMITTED)).xattr(),
-                  couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_START_COMMIT, subdoc::mutate_in_macro::cas).xattr(),
-                  couchbase::mutate_in_specs::insert(prefix + ATR_FIELD_PREVENT_COLLLISION, 0).xattr(),
+    std::string prefix(ATR_FIELD_ATTEMPTS + "." + id() + ".");
+    core::operations::mutate_in_request req{ atr_id_.value() };
+    req.specs =
+      couchbase::mutate_in_specs{
+          couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_STATUS, attempt_state_name(attempt_state::COMMITTED)).xattr(),
+          couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_START_COMMIT, subdoc::mutate_in_macro::cas).xattr(),
+          couchbase::mutate_in_specs::insert(prefix + ATR_FIELD_PREVENT_COLLLISION, 0).xattr(),
+      }
+        .specs();
+    wrap_durable_request(req, overall_.config());
+    try {
+        auto ec = error_if_expired_and_not_in_overtime(STAGE_ATR_COMMIT, {});
+        if (ec) {
+            throw client_error(*ec, "atr_commit check for expiry threw error");
+        }
+        if (!!(ec = hooks_.before_atr_commit(this))) {
+            throw client_error(*ec, "before_atr_commit hook raised error");
+        }
+    } catch (const client_error& e) {
+        return handle_atr_commit_error(e, ambiguity_resolution_mode, std::move(cb));
+    }
+    staged_mutations_->extract_to(prefix, req);
+    CB_ATTEMPT_CTX_LOG_TRACE(this, "updating atr {}, setting to {}", req.id, attempt_state_name(attempt_state::COMMITTED));
+    overall_.cluster_ref()->execute(
+      req, [this, ambiguity_resolution_mode, cb = std::move(cb)](core::operations::mutate_in_response resp) mutable {
+          try {
+              auto res = result::create_from_subdoc_response(resp);
+              validate_operation_result(res, false);
+              auto ec = hooks_.after_atr_commit(this);
+              if (ec) {
+                  throw client_error(*ec, "after_atr_commit hook raised error");
               }
-                .specs();
-            wrap_durable_request(req, overall_.config());
-            auto ec = error_if_expired_and_not_in_overtime(STAGE_ATR_COMMIT, {});
-            if (ec) {
-                throw client_error(*ec, "atr_commit check for expiry threw error");
-            }
-            if (!!(ec = hooks_.before_atr_commit(this))) {
-                // for now, throw.  Later, if this is async, we will use error handler no doubt.
-                throw client_error(*ec, "before_atr_commit hook raised error");
-            }
-            staged_mutations_->extract_to(prefix, req);
-            auto barrier = std::make_shared<std::promise<result>>();
-            auto f = barrier->get_future();
-            CB_ATTEMPT_CTX_LOG_TRACE(this, "updating atr {}, setting to {}", req.id, attempt_state_name(attempt_state::COMMITTED));
-            overall_.cluster_ref()->execute(
-              req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-            auto res = wrap_operation_future(f, false);
-            ec = hooks_.after_atr_commit(this);
-            if (ec) {
-                throw client_error(*ec, "after_atr_commit hook raised error");
-            }
-            state(attempt_state::COMMITTED);
-        } catch (const client_error& e) {
-            error_class ec = e.ec();
-            switch (ec) {
-                case FAIL_EXPIRY: {
-                    expiry_overtime_mode_ = true;
-                    auto out = transaction_operation_failed(ec, e.what()).no_rollback();
-                    if (ambiguity_resolution_mode) {
-                        out.ambiguous();
-                    } else {
-                        out.expired();
-                    }
-                    throw out;
+              state(attempt_state::COMMITTED);
+          } catch (const client_error& e) {
+              return handle_atr_commit_error(e, ambiguity_resolution_mode, std::move(cb));
+          }
+          cb({});
+      });
+}
+
+void
+attempt_context_impl::handle_atr_commit_error(const client_error& e, bool ambiguity_resolution_mode, VoidCallback&& cb)
+{
+    try {
+        error_class ec = e.ec();
+        switch (ec) {
+            case FAIL_EXPIRY: {
+                expiry_overtime_mode_ = true;
+                auto out = transaction_operation_failed(ec, e.what()).no_rollback();
+                if (ambiguity_resolution_mode) {
+                    out.ambiguous();
+                } else {
+                    out.expired();
                 }
-                case FAIL_AMBIGUOUS:
-                    CB_ATTEMPT_CTX_LOG_DEBUG(this, "atr_commit got FAIL_AMBIGUOUS, resolving ambiguity...");
-                    ambiguity_resolution_mode = true;
+                throw out;
+            }
+            case FAIL_AMBIGUOUS:
+                CB_ATTEMPT_CTX_LOG_DEBUG(this, "atr_commit got FAIL_AMBIGUOUS, resolving ambiguity...");
+                ambiguity_resolution_mode = true;
+                throw retry_operation(e.what());
+            case FAIL_TRANSIENT:
+                if (ambiguity_resolution_mode) {
                     throw retry_operation(e.what());
-                case FAIL_TRANSIENT:
-                    if (ambiguity_resolution_mode) {
-                        throw retry_operation(e.what());
-                    }
-                    throw transaction_operation_failed(ec, e.what()).retry();
-
-                case FAIL_PATH_ALREADY_EXISTS:
-                    // Need retry_op as atr_commit_ambiguity_resolution can throw retry_operation
-                    return retry_op<void>([&]() { return atr_commit_ambiguity_resolution(); });
-                case FAIL_HARD: {
-                    auto out = transaction_operation_failed(ec, e.what()).no_rollback();
-                    if (ambiguity_resolution_mode) {
-                        out.ambiguous();
-                    }
-                    throw out;
                 }
-                case FAIL_DOC_NOT_FOUND: {
-                    auto out = transaction_operation_failed(ec, e.what())
-                                 .cause(external_exception::ACTIVE_TRANSACTION_RECORD_NOT_FOUND)
-                                 .no_rollback();
-                    if (ambiguity_resolution_mode) {
-                        out.ambiguous();
-                    }
-                    throw out;
+                throw transaction_operation_failed(ec, e.what()).retry();
+
+            case FAIL_PATH_ALREADY_EXISTS:
+                // atr_commit_ambiguity_resolution retries on its own
+                return atr_commit_ambiguity_resolution(std::move(cb));
+            case FAIL_HARD: {
+                auto out = transaction_operation_failed(ec, e.what()).no_rollback();
+                if (ambiguity_resolution_mode) {
+                    out.ambiguous();
                 }
-                case FAIL_PATH_NOT_FOUND: {
-                    auto out = transaction_operation_failed(ec, e.what())
-                                 .cause(external_exception::ACTIVE_TRANSACTION_RECORD_ENTRY_NOT_FOUND)
-                                 .no_rollback();
-                    if (ambiguity_resolution_mode) {
-                        out.ambiguous();
-                    }
-                    throw out;
+                throw out;
+            }
+            case FAIL_DOC_NOT_FOUND: {
+                auto out = transaction_operation_failed(ec, e.what())
+                             .cause(external_exception::ACTIVE_TRANSACTION_RECORD_NOT_FOUND)
+                             .no_rollback();
+                if (ambiguity_resolution_mode) {
+                    out.ambiguous();
                 }
-                case FAIL_ATR_FULL: {
-                    auto out =
-                      transaction_operation_failed(ec, e.what()).cause(external_exception::ACTIVE_TRANSACTION_RECORD_FULL).no_rollback();
-                    if (ambiguity_resolution_mode) {
-                        out.ambiguous();
-                    }
-                    throw out;
+                throw out;
+            }
+            case FAIL_PATH_NOT_FOUND: {
+                auto out = transaction_operation_failed(ec, e.what())
+                             .cause(external_exception::ACTIVE_TRANSACTION_RECORD_ENTRY_NOT_FOUND)
+                             .no_rollback();
+                if (ambiguity_resolution_mode) {
+                    out.ambiguous();
                 }
-                default: {
-                    CB_ATTEMPT_CTX_LOG_ERROR(this,
-                                             "failed to commit transaction {}, attempt {}, ambiguity_resolution_mode {}, with error {}",
-                                             transaction_id(),
-                                             id(),
-                                             ambiguity_resolution_mode,
-                                             e.what());
-                    auto out = transaction_operation_failed(ec, e.what());
-                    if (ambiguity_resolution_mode) {
-                        out.no_rollback().ambiguous();
-                    }
-                    throw out;
+                throw out;
+            }
+            case FAIL_ATR_FULL: {
+                auto out =
+                  transaction_operation_failed(ec, e.what()).cause(external_exception::ACTIVE_TRANSACTION_RECORD_FULL).no_rollback();
+                if (ambiguity_resolution_mode) {
+                    out.ambiguous();
+                }
+                throw out;
+            }
+            default: {
+                CB_ATTEMPT_CTX_LOG_ERROR(this,
+                                         "failed to commit transaction {}, attempt {}, ambiguity_resolution_mode {}, with error {}",
+                                         transaction_id(),
+                                         id(),
+                                         ambiguity_resolution_mode,
+                                         e.what());
+                auto out = transaction_operation_failed(ec, e.what());
+                if (ambiguity_resolution_mode) {
+                    out.no_rollback().ambiguous();
                 }
+                throw out;
             }
         }
-    });
+    } catch (const retry_operation&) {
+        return async_delay(overall_.cluster_ref()->io_context(),
+                           DEFAULT_RETRY_OP_DELAY,
+                           [this, ambiguity_resolution_mode, cb = std::move(cb)]() mutable {
+                               atr_commit(ambiguity_resolution_mode, std::move(cb));
+                           });
+    } catch (...) {
+        return cb(std::current_exception());
+    }
 }
 
 void
-attempt_context_impl::atr_commit_ambiguity_resolution()
+attempt_context_impl::atr_commit_ambiguity_resolution(VoidCallback&& cb)
 {
     try {
         auto ec = error_if_expired_and_not_in_overtime(STAGE_ATR_COMMIT_AMBIGUITY_RESOLUTION, {});
@@ -1493,30 +1562,44 @@ attempt_context_impl::atr_commit_ambiguity_resolution()
         if (!!(ec = hooks_.before_atr_commit_ambiguity_resolution(this))) {
             throw client_error(*ec, "before_atr_commit_ambiguity_resolution hook threw error");
         }
-        std::string prefix(ATR_FIELD_ATTEMPTS + "." + id() + ".");
-        core::operations::lookup_in_request req{ atr_id_.value() };
-        req.specs = lookup_in_specs{ lookup_in_specs::get(prefix + ATR_FIELD_STATUS).xattr() }.specs();
-        wrap_request(req, overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        overall_.cluster_ref()->execute(
-          req, [barrier](core::operations::lookup_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        auto res = wrap_operation_future(f);
-        auto atr_status_raw = res.values[0].content_as<std::string>();
-        CB_ATTEMPT_CTX_LOG_DEBUG(this, "atr_commit_ambiguity_resolution read atr state {}", atr_status_raw);
-        auto atr_status = attempt_state_value(atr_status_raw);
-        switch (atr_status) {
-            case attempt_state::COMMITTED:
-                return;
-            case attempt_state::ABORTED:
-                // aborted by another process?
-                throw transaction_operation_failed(FAIL_OTHER, "transaction aborted externally").retry();
-            default:
-                throw transaction_operation_failed(FAIL_OTHER, "unexpected state found on ATR ambiguity resolution")
-                  .cause(ILLEGAL_STATE_EXCEPTION)
-                  .no_rollback();
-        }
     } catch (const client_error& e) {
+        return handle_atr_commit_ambiguity_resolution_error(e, std::move(cb));
+    }
+    std::string prefix(ATR_FIELD_ATTEMPTS + "." + id() + ".");
+    core::operations::lookup_in_request req{ atr_id_.value() };
+    req.specs = lookup_in_specs{ lookup_in_specs::get(prefix + ATR_FIELD_STATUS).xattr() }.specs();
+    wrap_request(req, overall_.config());
+    overall_.cluster_ref()->execute(req, [this, cb = std::move(cb)](core::operations::lookup_in_response resp) mutable {
+        std::exception_ptr err{};
+        try {
+            auto res = result::create_from_subdoc_response(resp);
+            validate_operation_result(res);
+            auto atr_status_raw = res.values[0].content_as<std::string>();
+            CB_ATTEMPT_CTX_LOG_DEBUG(this, "atr_commit_ambiguity_resolution read atr state {}", atr_status_raw);
+            auto atr_status = attempt_state_value(atr_status_raw);
+            switch (atr_status) {
+                case attempt_state::COMMITTED:
+                    break;
+                case attempt_state::ABORTED:
+                    // aborted by another process?
+                    err = std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, "transaction aborted externally").retry());
+                    break;
+                default:
+                    err = std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, "unexpected state found on ATR ambiguity resolution")
+                                                    .cause(ILLEGAL_STATE_EXCEPTION)
+                                                    .no_rollback());
+            }
+        } catch (const client_error& e) {
+            return handle_atr_commit_ambiguity_resolution_error(e, std::move(cb));
+        }
+        cb(err);
+    });
+}
+
+void
+attempt_context_impl::handle_atr_commit_ambiguity_resolution_error(const client_error& e, VoidCallback&& cb)
+{
+    try {
         error_class ec = e.ec();
         switch (ec) {
             case FAIL_EXPIRY:
@@ -1533,14 +1616,19 @@ attempt_context_impl::atr_commit_ambiguity_resolution()
             default:
                 throw transaction_operation_failed(ec, e.what()).no_rollback().ambiguous();
         }
+    } catch (const retry_operation&) {
+        return async_delay(overall_.cluster_ref()->io_context(), DEFAULT_RETRY_OP_DELAY, [this, cb = std::move(cb)]() mutable {
+            atr_commit_ambiguity_resolution(std::move(cb));
+        });
+    } catch (...) {
+        return cb(std::current_exception());
     }
 }
 
 void
-attempt_context_impl::atr_complete()
+attempt_context_impl::atr_complete(VoidCallback&& cb)
 {
     try {
-        result atr_res;
         auto ec = hooks_.before_atr_complete(this);
         if (ec) {
             throw client_error(*ec, "before_atr_complete hook threw error");
@@ -1549,93 +1637,131 @@ attempt_context_impl::atr_complete()
         if (!!(ec = error_if_expired_and_not_in_overtime(STAGE_ATR_COMPLETE, {}))) {
             throw client_error(*ec, "atr_complete threw error");
         }
-        CB_ATTEMPT_CTX_LOG_DEBUG(this, "removing attempt {} from atr", atr_id_.value());
-        std::string prefix(ATR_FIELD_ATTEMPTS + "." + id());
-        core::operations::mutate_in_request req{ atr_id_.value() };
-        req.specs =
-          couchbase::mutate_in_specs{
-              couchbase::mutate_in_specs::remove(prefix).xattr(),
-          }
-            .specs();
-        wrap_durable_request(req, overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        overall_.cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        wrap_operation_future(f);
-        ec = hooks_.after_atr_complete(this);
-        if (ec) {
-            throw client_error(*ec, "after_atr_complete hook threw error");
-        }
-        state(attempt_state::COMPLETED);
-    } catch (const client_error& er) {
-        error_class ec = er.ec();
-        switch (ec) {
-            case FAIL_HARD:
-                throw transaction_operation_failed(ec, er.what()).no_rollback().failed_post_commit();
-            default:
-                CB_ATTEMPT_CTX_LOG_INFO(this, "ignoring error in atr_complete {}", er.what());
+    } catch (const client_error& e) {
+        return handle_atr_complete_error(e, std::move(cb));
+    }
+    CB_ATTEMPT_CTX_LOG_DEBUG(this, "removing attempt {} from atr", atr_id_.value());
+    std::string prefix(ATR_FIELD_ATTEMPTS + "." + id());
+    core::operations::mutate_in_request req{ atr_id_.value() };
+    req.specs =
+      couchbase::mutate_in_specs{
+          couchbase::mutate_in_specs::remove(prefix).xattr(),
+      }
+        .specs();
+    wrap_durable_request(req, overall_.config());
+    overall_.cluster_ref()->execute(req, [this, cb = std::move(cb)](core::operations::mutate_in_response resp) mutable {
+        try {
+            auto res = result::create_from_subdoc_response(resp);
+            validate_operation_result(res);
+            auto ec = hooks_.after_atr_complete(this);
+            if (ec) {
+                throw client_error(*ec, "after_atr_complete hook threw error");
+            }
+            state(attempt_state::COMPLETED);
+        } catch (const client_error& e) {
+            return handle_atr_complete_error(e, std::move(cb));
         }
+        cb({});
+    });
+}
+
+void
+attempt_context_impl::handle_atr_complete_error(const client_error& er, VoidCallback&& cb)
+{
+    error_class ec = er.ec();
+    switch (ec) {
+        case FAIL_HARD:
+            return cb(std::make_exception_ptr(transaction_operation_failed(ec, er.what()).no_rollback().failed_post_commit()));
+        default:
+            CB_ATTEMPT_CTX_LOG_INFO(this, "ignoring error in atr_complete {}", er.what());
     }
+    cb({});
 }
+
 void
 attempt_context_impl::commit(VoidCallback&& cb)
 {
-    // for now, lets keep the blocking implementation
-    std::thread([cb = std::move(cb), this]() mutable {
-        try {
-            commit();
+    do_commit([cb = std::move(cb)](std::exception_ptr err) mutable {
+        if (!err) {
             return cb({});
+        }
+        try {
+            std::rethrow_exception(err);
         } catch (const transaction_operation_failed&) {
             return cb(std::current_exception());
         } catch (const std::exception& e) {
             return cb(std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, e.what())));
         }
-    }).detach();
+    });
 }
 
 void
 attempt_context_impl::commit()
+{
+    auto barrier = std::make_shared<std::promise<void>>();
+    auto f = barrier->get_future();
+    do_commit([barrier](std::exception_ptr err) {
+        if (err) {
+            return barrier->set_exception(err);
+        }
+        barrier->set_value();
+    });
+    f.get();
+}
+
+void
+attempt_context_impl::do_commit(VoidCallback&& cb)
 {
     CB_ATTEMPT_CTX_LOG_DEBUG(this, "waiting on ops to finish...");
-    op_list_.wait_and_block_ops();
-    existing_error(false);
-    CB_ATTEMPT_CTX_LOG_DEBUG(this, "commit {}", id());
-    if (op_list_.get_mode().is_query()) {
-        auto barrier = std::make_shared<std::promise<void>>();
-        auto f = barrier->get_future();
-        commit_with_query([barrier](std::exception_ptr err) {
-            if (err) {
-                barrier->set_exception(err);
-            } else {
-                barrier->set_value();
-            }
-        });
-        f.get();
-    } else {
+    op_list_.wait_and_block_ops([this, cb = std::move(cb)]() mutable {
+        try {
+            existing_error(false);
+        } catch (...) {
+            return cb(std::current_exception());
+        }
+        CB_ATTEMPT_CTX_LOG_DEBUG(this, "commit {}", id());
+        if (op_list_.get_mode().is_query()) {
+            return commit_with_query(std::move(cb));
+        }
         if (check_expiry_pre_commit(STAGE_BEFORE_COMMIT, {})) {
-            throw transaction_operation_failed(FAIL_EXPIRY, "transaction expired").expired();
+            return cb(std::make_exception_ptr(transaction_operation_failed(FAIL_EXPIRY, "transaction expired").expired()));
         }
         if (atr_id_ && !atr_id_->key().empty() && !is_done_) {
-            retry_op_exp<void>([&]() { atr_commit(false); });
-            staged_mutations_->commit(this);
-            atr_complete();
+            return atr_commit(false, [this, cb = std::move(cb)](std::exception_ptr err) mutable {
+                if (err) {
+                    return cb(err);
+                }
+                staged_mutations_->commit(this, [this, cb = std::move(cb)](std::exception_ptr err) mutable {
+                    if (err) {
+                        return cb(err);
+                    }
+                    atr_complete([this, cb = std::move(cb)](std::exception_ptr err) mutable {
+                        if (err) {
+                            return cb(err);
+                        }
+                        is_done_ = true;
+                        cb({});
+                    });
+                });
+            });
+        }
+        // no mutation, no need to commit
+        if (!is_done_) {
+            CB_ATTEMPT_CTX_LOG_DEBUG(this, "calling commit on attempt that has got no mutations, skipping");
             is_done_ = true;
-        } else {
-            // no mutation, no need to commit
-            if (!is_done_) {
-                CB_ATTEMPT_CTX_LOG_DEBUG(this, "calling commit on attempt that has got no mutations, skipping");
-                is_done_ = true;
-                return;
-            } // do not rollback or retry
-            throw transaction_operation_failed(FAIL_OTHER, "calling commit on attempt that is already completed").no_rollback();
+            return cb({});
         }
-    }
+        // do not rollback or retry
+        cb(std::make_exception_ptr(
+          transaction_operation_failed(FAIL_OTHER, "calling commit on attempt that is already completed").no_rollback()));
+    });
 }
 
 void
-attempt_context_impl::atr_abort()
+attempt_context_impl::atr_abort(std::size_t retries, VoidCallback&& cb)
 {
+    std::string prefix(ATR_FIELD_ATTEMPTS + "." + id() + ".");
+    core::operations::mutate_in_request req{ atr_id_.value() };
     try {
         auto ec = error_if_expired_and_not_in_overtime(STAGE_ATR_ABORT, {});
         if (ec) {
@@ -1644,32 +1770,40 @@ attempt_context_impl::atr_abort()
         if (!!(ec = hooks_.before_atr_aborted(this))) {
             throw client_error(*ec, "before_atr_aborted hook threw error");
         }
-        std::string prefix(ATR_FIELD_ATTEMPTS + "." + id() + ".");
-        core::operations::mutate_in_request req{ atr_id_.value() };
-        req.specs =
-          couchbase::mutate_in_specs{
-              couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_STATUS, attempt_state_name(attempt_state::ABORTED))
-                .xattr()
-                .create_path(),
-              couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_TIMESTAMP_ROLLBACK_START, subdoc::mutate_in_macro::cas)
-                .xattr()
-                .create_path(),
-          }
-            .specs();
-        staged_mutations_->extract_to(prefix, req);
-        wrap_durable_request(req, overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        overall_.cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        wrap_operation_future(f);
-        state(attempt_state::ABORTED);
-        ec = hooks_.after_atr_aborted(this);
-        if (ec) {
-            throw client_error(*ec, "after_atr_aborted hook threw error");
-        }
-        CB_ATTEMPT_CTX_LOG_DEBUG(this, "rollback completed atr abort phase");
     } catch (const client_error& e) {
+        return handle_atr_abort_error(e, retries, std::move(cb));
+    }
+    req.specs =
+      couchbase::mutate_in_specs{
+          couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_STATUS, attempt_state_name(attempt_state::ABORTED)).xattr().create_path(),
+          couchbase::mutate_in_specs::upsert(prefix + ATR_FIELD_TIMESTAMP_ROLLBACK_START, subdoc::mutate_in_macro::cas)
+            .xattr()
+            .create_path(),
+      }
+        .specs();
+    staged_mutations_->extract_to(prefix, req);
+    wrap_durable_request(req, overall_.config());
+    overall_.cluster_ref()->execute(req, [this, retries, cb = std::move(cb)](core::operations::mutate_in_response resp) mutable {
+        try {
+            auto res = result::create_from_subdoc_response(resp);
+            validate_operation_result(res);
+            state(attempt_state::ABORTED);
+            auto ec = hooks_.after_atr_aborted(this);
+            if (ec) {
+                throw client_error(*ec, "after_atr_aborted hook threw error");
+            }
+            CB_ATTEMPT_CTX_LOG_DEBUG(this, "rollback completed atr abort phase");
+        } catch (const client_error& e) {
+            return handle_atr_abort_error(e, retries, std::move(cb));
+        }
+        cb({});
+    });
+}
+
+void
+attempt_context_impl::handle_atr_abort_error(const client_error& e, std::size_t retries, VoidCallback&& cb)
+{
+    try {
         auto ec = e.ec();
         CB_ATTEMPT_CTX_LOG_TRACE(this, "atr_abort got {} {}", ec, e.what());
         if (expiry_overtime_mode_.load()) {
@@ -1694,11 +1828,20 @@ attempt_context_impl::atr_abort()
             default:
                 throw retry_operation("retry atr_abort");
         }
+    } catch (const retry_operation&) {
+        if (retries >= DEFAULT_RETRY_OP_MAX_RETRIES) {
+            return cb(std::make_exception_ptr(retry_operation_retries_exhausted("retry_op hit max retries!")));
+        }
+        return async_delay(overall_.cluster_ref()->io_context(),
+                           exponential_backoff_delay(DEFAULT_RETRY_OP_EXP_DELAY, retries),
+                           [this, retries, cb = std::move(cb)]() mutable { atr_abort(retries + 1, std::move(cb)); });
+    } catch (...) {
+        return cb(std::current_exception());
     }
 }
 
 void
-attempt_context_impl::atr_rollback_complete()
+attempt_context_impl::atr_rollback_complete(std::size_t retries, VoidCallback&& cb)
 {
     try {
         auto ec = error_if_expired_and_not_in_overtime(STAGE_ATR_ROLLBACK_COMPLETE, std::nullopt);
@@ -1708,27 +1851,38 @@ attempt_context_impl::atr_rollback_complete()
         if (!!(ec = hooks_.before_atr_rolled_back(this))) {
             throw client_error(*ec, "before_atr_rolled_back hook threw error");
         }
-        std::string prefix(ATR_FIELD_ATTEMPTS + "." + id());
-        core::operations::mutate_in_request req{ atr_id_.value() };
-        req.specs =
-          couchbase::mutate_in_specs{
-              couchbase::mutate_in_specs::remove(prefix).xattr(),
-          }
-            .specs();
-        wrap_durable_request(req, overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        overall_.cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        wrap_operation_future(f);
-        state(attempt_state::ROLLED_BACK);
-        ec = hooks_.after_atr_rolled_back(this);
-        if (ec) {
-            throw client_error(*ec, "after_atr_rolled_back hook threw error");
+    } catch (const client_error& e) {
+        return handle_atr_rollback_complete_error(e, retries, std::move(cb));
+    }
+    std::string prefix(ATR_FIELD_ATTEMPTS + "." + id());
+    core::operations::mutate_in_request req{ atr_id_.value() };
+    req.specs =
+      couchbase::mutate_in_specs{
+          couchbase::mutate_in_specs::remove(prefix).xattr(),
+      }
+        .specs();
+    wrap_durable_request(req, overall_.config());
+    overall_.cluster_ref()->execute(req, [this, retries, cb = std::move(cb)](core::operations::mutate_in_response resp) mutable {
+        try {
+            auto res = result::create_from_subdoc_response(resp);
+            validate_operation_result(res);
+            state(attempt_state::ROLLED_BACK);
+            auto ec = hooks_.after_atr_rolled_back(this);
+            if (ec) {
+                throw client_error(*ec, "after_atr_rolled_back hook threw error");
+            }
+            is_done_ = true;
+        } catch (const client_error& e) {
+            return handle_atr_rollback_complete_error(e, retries, std::move(cb));
         }
-        is_done_ = true;
+        cb({});
+    });
+}
 
-    } catch (const client_error& e) {
+void
+attempt_context_impl::handle_atr_rollback_complete_error(const client_error& e, std::size_t retries, VoidCallback&& cb)
+{
+    try {
         auto ec = e.ec();
         if (expiry_overtime_mode_.load()) {
             CB_ATTEMPT_CTX_LOG_DEBUG(this, "atr_rollback_complete error while in overtime mode {}", e.what());
@@ -1755,19 +1909,31 @@ attempt_context_impl::atr_rollback_complete()
                 CB_ATTEMPT_CTX_LOG_DEBUG(this, "retrying atr_rollback_complete");
                 throw retry_operation(e.what());
         }
+    } catch (const retry_operation&) {
+        if (retries >= DEFAULT_RETRY_OP_MAX_RETRIES) {
+            return cb(std::make_exception_ptr(retry_operation_retries_exhausted("retry_op hit max retries!")));
+        }
+        return async_delay(overall_.cluster_ref()->io_context(),
+                           exponential_backoff_delay(DEFAULT_RETRY_OP_EXP_DELAY, retries),
+                           [this, retries, cb = std::move(cb)]() mutable { atr_rollback_complete(retries + 1, std::move(cb)); });
+    } catch (...) {
+        return cb(std::current_exception());
     }
+    cb({});
 }
+
 void
 attempt_context_impl::rollback(VoidCallback&& cb)
 {
-    // for now, lets keep the blocking implementation
-    std::thread([cb = std::move(cb), this]() mutable {
-        if (op_list_.get_mode().is_query()) {
-            return rollback_with_query(std::move(cb));
+    if (op_list_.get_mode().is_query()) {
+        return rollback_with_query(std::move(cb));
+    }
+    do_rollback([cb = std::move(cb)](std::exception_ptr err) mutable {
+        if (!err) {
+            return cb({});
         }
         try {
-            rollback();
-            return cb({});
+            std::rethrow_exception(err);
         } catch (const transaction_operation_failed&) {
             return cb(std::current_exception());
         } catch (const std::exception& e) {
@@ -1775,56 +1941,62 @@ attempt_context_impl::rollback(VoidCallback&& cb)
         } catch (...) {
             return cb(std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, "unexpected exception during rollback")));
         }
-    }).detach();
+    });
 }
 
 void
 attempt_context_impl::rollback()
 {
-    op_list_.wait_and_block_ops();
-    CB_ATTEMPT_CTX_LOG_DEBUG(this, "rolling back {}", id());
-    if (op_list_.get_mode().is_query()) {
-        auto barrier = std::make_shared<std::promise<void>>();
-        auto f = barrier->get_future();
-        rollback_with_query([barrier](std::exception_ptr err) {
+    auto barrier = std::make_shared<std::promise<void>>();
+    auto f = barrier->get_future();
+    do_rollback([barrier](std::exception_ptr err) {
+        if (err) {
+            return barrier->set_exception(err);
+        }
+        barrier->set_value();
+    });
+    f.get();
+}
+
+void
+attempt_context_impl::do_rollback(VoidCallback&& cb)
+{
+    op_list_.wait_and_block_ops([this, cb = std::move(cb)]() mutable {
+        CB_ATTEMPT_CTX_LOG_DEBUG(this, "rolling back {}", id());
+        if (op_list_.get_mode().is_query()) {
+            return rollback_with_query(std::move(cb));
+        }
+        // check for expiry
+        check_expiry_during_commit_or_rollback(STAGE_ROLLBACK, std::nullopt);
+        if (!atr_id_ || atr_id_->key().empty() || state() == attempt_state::NOT_STARTED) {
+            // TODO: check this, but if we try to rollback an empty txn, we should prevent a subsequent commit
+            CB_ATTEMPT_CTX_LOG_DEBUG(this, "rollback called on txn with no mutations");
+            is_done_ = true;
+            return cb({});
+        }
+        if (is_done()) {
+            std::string msg("Transaction already done, cannot rollback");
+            CB_ATTEMPT_CTX_LOG_ERROR(this, msg);
+            // need to raise a FAIL_OTHER which is not retryable or rollback-able
+            return cb(std::make_exception_ptr(transaction_operation_failed(FAIL_OTHER, msg).no_rollback()));
+        }
+        // (1) atr_abort
+        atr_abort(0, [this, cb = std::move(cb)](std::exception_ptr err) mutable {
             if (err) {
-                barrier->set_exception(err);
-            } else {
-                barrier->set_value();
+                return cb(err);
             }
-        });
-        return f.get();
-    }
-    // check for expiry
-    check_expiry_during_commit_or_rollback(STAGE_ROLLBACK, std::nullopt);
-    if (!atr_id_ || atr_id_->key().empty() || state() == attempt_state::NOT_STARTED) {
-        // TODO: check this, but if we try to rollback an empty txn, we should prevent a subsequent commit
-        CB_ATTEMPT_CTX_LOG_DEBUG(this, "rollback called on txn with no mutations");
-        is_done_ = true;
-        return;
-    }
-    if (is_done()) {
-        std::string msg("Transaction already done, cannot rollback");
-        CB_ATTEMPT_CTX_LOG_ERROR(this, msg);
-        // need to raise a FAIL_OTHER which is not retryable or rollback-able
-        throw transaction_operation_failed(FAIL_OTHER, msg).no_rollback();
-    }
-    try {
-        // (1) atr_abort
-        retry_op_exp<void>([&]() { atr_abort(); });
-        // (2) rollback staged mutations
-        staged_mutations_->rollback(this);
-        CB_ATTEMPT_CTX_LOG_DEBUG(this, "rollback completed unstaging docs");
+            // (2) rollback staged mutations
+            staged_mutations_->rollback(this, [this, cb = std::move(cb)](std::exception_ptr err) mutable {
+                if (err) {
+                    return cb(err);
+                }
+                CB_ATTEMPT_CTX_LOG_DEBUG(this, "rollback completed unstaging docs");
 
-        // (3) atr_rollback
-        retry_op_exp<void>([&]() { atr_rollback_complete(); });
-    } catch (const client_error& e) {
-        error_class ec = e.ec();
-        CB_ATTEMPT_CTX_LOG_ERROR(this, "rollback transaction {}, attempt {} fail with error {}", transaction_id(), id(), e.what());
-        if (ec == FAIL_HARD) {
-            throw transaction_operation_failed(ec, e.what()).no_rollback();
-        }
-    }
+                // (3) atr_rollback
+                atr_rollback_complete(0, std::move(cb));
+            });
+        });
+    });
 }
 
 bool
@@ -2016,7 +2188,10 @@ attempt_context_impl::check_if_done(Handler& cb)
 }
 template<typename Handler>
 void
-attempt_context_impl::do_get(const core::document_id& id, const std::optional<std::string> resolving_missing_atr_entry, Handler&& cb)
+attempt_context_impl::do_get(const core::document_id& id,
+                             const std::optional<std::string> resolving_missing_atr_entry,
+                             Handler&& cb,
+                             std::vector<std::string> projections)
 {
     try {
         if (check_expiry_pre_commit(STAGE_GET, id.key())) {
@@ -2026,7 +2201,10 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
         staged_mutation* own_write = check_for_own_write(id);
         if (own_write) {
             CB_ATTEMPT_CTX_LOG_DEBUG(this, "found own-write of mutated doc {}", id);
-            return cb(std::nullopt, std::nullopt, transaction_get_result::create_from(own_write->doc(), own_write->content()));
+            return cb(std::nullopt,
+                      std::nullopt,
+                      transaction_get_result::create_from(own_write->doc(),
+                                                          transaction_get_result::project_content(own_write->content(), projections)));
         }
         staged_mutation* own_remove = staged_mutations_->find_remove(id);
         if (own_remove) {
@@ -2041,7 +2219,7 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
 
         get_doc(
           id,
-          [this, id, resolving_missing_atr_entry = std::move(resolving_missing_atr_entry), cb = std::move(cb)](
+          [this, id, resolving_missing_atr_entry = std::move(resolving_missing_atr_entry), cb = std::move(cb), projections](
             std::optional<error_class> ec, std::optional<std::string> err_message, std::optional<transaction_get_result> doc) mutable {
               if (!ec && !doc) {
                   // it just isn't there.
@@ -2071,7 +2249,8 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
                       active_transaction_record::get_atr(
                         cluster_ref(),
                         doc_atr_id,
-                        [this, id, doc, cb = std::move(cb)](std::error_code ec2, std::optional<active_transaction_record> atr) mutable {
+                        [this, id, doc, cb = std::move(cb), projections](std::error_code ec2,
+                                                                        std::optional<active_transaction_record> atr) mutable {
                             if (!ec2 && atr) {
                                 active_transaction_record& atr_doc = atr.value();
                                 std::optional<atr_entry> entry;
@@ -2087,7 +2266,7 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
                                     if (doc->links().staged_attempt_id() && entry->attempt_id() == this->id()) {
                                         // Attempt is reading its own writes
                                         // This is here as backup, it should be returned from the in-memory cache instead
-                                        content = doc->links().staged_content();
+                                        content = transaction_get_result::project_content(doc->links().staged_content(), projections);
                                     } else {
                                         auto err = forward_compat::check(forward_compat_stage::GETS_READING_ATR, entry->forward_compat());
                                         if (err) {
@@ -2099,7 +2278,8 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
                                                 if (doc->links().is_document_being_removed()) {
                                                     ignore_doc = true;
                                                 } else {
-                                                    content = doc->links().staged_content();
+                                                    content =
+                                                      transaction_get_result::project_content(doc->links().staged_content(), projections);
                                                 }
                                                 break;
                                             default:
@@ -2115,7 +2295,7 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
                                     CB_ATTEMPT_CTX_LOG_DEBUG(this,
                                                              "could not get ATR entry, checking again with {}",
                                                              doc->links().staged_attempt_id().value_or("-"));
-                                    return do_get(id, doc->links().staged_attempt_id(), cb);
+                                    return do_get(id, doc->links().staged_attempt_id(), cb, projections);
                                 }
                                 if (ignore_doc) {
                                     return cb(std::nullopt, std::nullopt, std::nullopt);
@@ -2126,7 +2306,7 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
                                 // failed to get the ATR
                                 CB_ATTEMPT_CTX_LOG_DEBUG(
                                   this, "could not get ATR, checking again with {}", doc->links().staged_attempt_id().value_or("-"));
-                                return do_get(id, doc->links().staged_attempt_id(), cb);
+                                return do_get(id, doc->links().staged_attempt_id(), cb, projections);
                             }
                         });
                   } else {
@@ -2140,7 +2320,8 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
               } else {
                   return cb(ec, err_message, std::nullopt);
               }
-          });
+          },
+          projections);
 
     } catch (const transaction_operation_failed&) {
         throw;
@@ -2154,10 +2335,11 @@ attempt_context_impl::do_get(const core::document_id& id, const std::optional<st
 void
 attempt_context_impl::get_doc(
   const core::document_id& id,
-  std::function<void(std::optional<error_class>, std::optional<std::string>, std::optional<transaction_get_result>)>&& cb)
+  std::function<void(std::optional<error_class>, std::optional<std::string>, std::optional<transaction_get_result>)>&& cb,
+  const std::vector<std::string>& projections)
 {
     core::operations::lookup_in_request req{ id };
-    req.specs =
+    auto specs =
       lookup_in_specs{
           lookup_in_specs::get(ATR_ID).xattr(),
           lookup_in_specs::get(TRANSACTION_ID).xattr(),
@@ -2172,26 +2354,46 @@ attempt_context_impl::get_doc(
           lookup_in_specs::get(subdoc::lookup_in_macro::document).xattr(),
           lookup_in_specs::get(CRC32_OF_STAGING).xattr(),
           lookup_in_specs::get(FORWARD_COMPAT).xattr(),
-          lookup_in_specs::get(""),
-      }
-        .specs();
+      };
+    // the paths are fetched alongside the transactional metadata when they fit in the same lookup, otherwise the whole
+    // body is fetched and projected here
+    std::vector<std::string> fetched_projections;
+    if (projections.size() <= MAX_PROJECTED_PATHS) {
+        fetched_projections = projections;
+    }
+    if (fetched_projections.empty()) {
+        specs.push_back(lookup_in_specs::get(""));
+    } else {
+        for (const auto& path : fetched_projections) {
+            specs.push_back(lookup_in_specs::get(path));
+        }
+    }
+    req.specs = specs.specs();
     req.access_deleted = true;
     wrap_request(req, overall_.config());
     try {
-        overall_.cluster_ref()->execute(req, [this, id, cb = std::move(cb)](core::operations::lookup_in_response resp) {
-            auto ec = error_class_from_response(resp);
-            if (ec) {
-                CB_ATTEMPT_CTX_LOG_TRACE(this, "get_doc got error {} : {}", resp.ctx.ec().message(), *ec);
-                switch (*ec) {
-                    case FAIL_PATH_NOT_FOUND:
-                        return cb(*ec, resp.ctx.ec().message(), transaction_get_result::create_from(resp));
-                    default:
-                        return cb(*ec, resp.ctx.ec().message(), std::nullopt);
-                }
-            } else {
-                return cb({}, {}, transaction_get_result::create_from(resp));
-            }
-        });
+        overall_.cluster_ref()->execute(
+          req, [this, id, cb = std::move(cb), projections, fetched_projections](core::operations::lookup_in_response resp) {
+              auto to_result = [&resp, &projections, &fetched_projections]() {
+                  auto doc = transaction_get_result::create_from(resp, fetched_projections);
+                  if (fetched_projections.empty() && !projections.empty()) {
+                      return transaction_get_result::create_from(doc, transaction_get_result::project_content(doc.content(), projections));
+                  }
+                  return doc;
+              };
+              auto ec = error_class_from_response(resp);
+              if (ec) {
+                  CB_ATTEMPT_CTX_LOG_TRACE(this, "get_doc got error {} : {}", resp.ctx.ec().message(), *ec);
+                  switch (*ec) {
+                      case FAIL_PATH_NOT_FOUND:
+                          return cb(*ec, resp.ctx.ec().message(), to_result());
+                      default:
+                          return cb(*ec, resp.ctx.ec().message(), std::nullopt);
+                  }
+              } else {
+                  return cb({}, {}, to_result());
+              }
+          });
     } catch (const std::exception& e) {
         return cb(FAIL_OTHER, e.what(), std::nullopt);
     }
@@ -2221,8 +2423,11 @@ attempt_context_impl::create_staged_insert_error_handler(const core::document_id
                                            transaction_operation_failed(ec, "transient error in insert").retry());
         case FAIL_AMBIGUOUS:
             CB_ATTEMPT_CTX_LOG_DEBUG(this, "FAIL_AMBIGUOUS in create_staged_insert, retrying");
-            delay();
-            return create_staged_insert(id, content, cas, delay, op_id, std::forward<Handler>(cb));
+            return async_delay(cluster_ref()->io_context(),
+                               delay.next(),
+                               [this, id, content, cas, delay, op_id, cb = std::forward<Handler>(cb)]() mutable {
+                                   create_staged_insert(id, content, cas, delay, op_id, std::move(cb));
+                               });
         case FAIL_OTHER:
             return op_completed_with_error(std::forward<Handler>(cb), transaction_operation_failed(ec, "error in create_staged_insert"));
         case FAIL_HARD:
@@ -2276,8 +2481,11 @@ attempt_context_impl::create_staged_insert_error_handler(const core::document_id
                               // it is just a deleted doc, so we are ok.  Let's try again, but with the cas
                               CB_ATTEMPT_CTX_LOG_DEBUG(
                                 this, "create staged insert found existing deleted doc, retrying with cas {}", doc->cas().value());
-                              delay();
-                              return create_staged_insert(id, content, doc->cas().value(), delay, op_id, std::forward<Handler>(cb));
+                              return async_delay(cluster_ref()->io_context(),
+                                                 delay.next(),
+                                                 [this, id, content, cas = doc->cas().value(), delay, op_id, cb = std::move(cb)]() mutable {
+                                                     create_staged_insert(id, content, cas, delay, op_id, std::move(cb));
+                                                 });
                           }
                           if (!doc->links().is_document_in_transaction()) {
                               // doc was inserted outside txn elsewhere
@@ -2315,8 +2523,12 @@ attempt_context_impl::create_staged_insert_error_handler(const core::document_id
                                 }
                                 CB_ATTEMPT_CTX_LOG_DEBUG(
                                   this, "doc ok to overwrite, retrying create_staged_insert with cas {}", doc->cas().value());
-                                delay();
-                                return create_staged_insert(id, content, doc->cas().value(), delay, op_id, std::forward<Handler>(cb));
+                                return async_delay(
+                                  cluster_ref()->io_context(),
+                                  delay.next(),
+                                  [this, id, content, cas = doc->cas().value(), delay, op_id, cb = std::move(cb)]() mutable {
+                                      create_staged_insert(id, content, cas, delay, op_id, std::move(cb));
+                                  });
                             });
                       } else {
                           // no doc now, just retry entire txn
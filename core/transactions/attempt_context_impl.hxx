@@ -369,6 +369,9 @@ class attempt_context_impl
     std::optional<transaction_get_result> get_optional(const core::document_id& id) override;
     void get_optional(const core::document_id& id, Callback&& cb) override;
 
+    transaction_get_result get_projected(const core::document_id& id, const std::vector<std::string>& projections) override;
+    void get_projected(const core::document_id& id, const std::vector<std::string>& projections, Callback&& cb) override;
+
     void remove(const transaction_get_result& document) override;
     couchbase::transaction_op_error_context remove(const couchbase::transactions::transaction_get_result& doc) override
     {
@@ -501,26 +504,42 @@ class attempt_context_impl
     template<typename Handler, typename Delay>
     void check_atr_entry_for_blocking_document(const transaction_get_result& doc, Delay delay, Handler&& cb);
 
+    template<typename Handler, typename Delay>
+    void check_atr_entry_for_blocking_document_now(const transaction_get_result& doc, Delay delay, Handler&& cb);
+
     template<typename Handler>
     void check_if_done(Handler& cb);
 
-    void atr_commit(bool ambiguity_resolution_mode);
+    void do_commit(VoidCallback&& cb);
+
+    void do_rollback(VoidCallback&& cb);
+
+    void atr_commit(bool ambiguity_resolution_mode, VoidCallback&& cb);
+    void handle_atr_commit_error(const client_error& e, bool ambiguity_resolution_mode, VoidCallback&& cb);
 
-    void atr_commit_ambiguity_resolution();
+    void atr_commit_ambiguity_resolution(VoidCallback&& cb);
+    void handle_atr_commit_ambiguity_resolution_error(const client_error& e, VoidCallback&& cb);
 
-    void atr_complete();
+    void atr_complete(VoidCallback&& cb);
+    void handle_atr_complete_error(const client_error& e, VoidCallback&& cb);
 
-    void atr_abort();
+    void atr_abort(std::size_t retries, VoidCallback&& cb);
+    void handle_atr_abort_error(const client_error& e, std::size_t retries, VoidCallback&& cb);
 
-    void atr_rollback_complete();
+    void atr_rollback_complete(std::size_t retries, VoidCallback&& cb);
+    void handle_atr_rollback_complete_error(const client_error& e, std::size_t retries, VoidCallback&& cb);
 
     void select_atr_if_needed_unlocked(const core::document_id id, std::function<void(std::optional<transaction_operation_failed>)>&& cb);
 
     template<typename Handler>
-    void do_get(const core::document_id& id, const std::optional<std::string> resolving_missing_atr_entry, Handler&& cb);
+    void do_get(const core::document_id& id,
+                const std::optional<std::string> resolving_missing_atr_entry,
+                Handler&& cb,
+                std::vector<std::string> projections = {});
 
     void get_doc(const core::document_id& id,
-                 std::function<void(std::optional<error_class>, std::optional<std::string>, std::optional<transaction_get_result>)>&& cb);
+                 std::function<void(std::optional<error_class>, std::optional<std::string>, std::optional<transaction_get_result>)>&& cb,
+                 const std::vector<std::string>& projections = {});
 
     core::operations::mutate_in_request create_staging_request(const core::document_id& in,
                                                                const transaction_get_result* document,
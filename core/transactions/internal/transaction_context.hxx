@@ -32,6 +32,7 @@
 namespace couchbase::core::transactions
 {
 class attempt_context_impl;
+class transaction_operation_failed;
 
 struct exp_delay;
 
@@ -167,6 +168,8 @@ class transaction_context
 
     void handle_error(std::exception_ptr err, txn_complete_callback&& cb);
 
+    void complete_with_error(const transaction_operation_failed& er, txn_complete_callback&& cb);
+
     std::chrono::nanoseconds remaining() const;
 
   private:
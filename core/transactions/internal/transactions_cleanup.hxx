@@ -21,8 +21,11 @@
 #include "couchbase/transactions/transactions_config.hxx"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <list>
 #include <thread>
+#include <vector>
 
 namespace couchbase::core
 {
@@ -84,6 +87,21 @@ struct atr_cleanup_stats {
     }
 };
 
+// number of ATRs looked up concurrently by each step of the lost attempts scan
+static constexpr std::size_t DEFAULT_LOST_ATTEMPTS_BATCH_SIZE{ 32 };
+
+// progress of the lost attempts scan of one collection through the current cleanup window
+struct lost_attempts_collection_state {
+    couchbase::transactions::transaction_keyspace keyspace;
+    std::vector<std::string> atrs{};
+    std::size_t next_atr{ 0 };
+    std::chrono::steady_clock::time_point window_start{};
+    std::chrono::steady_clock::time_point next_batch{};
+    std::chrono::microseconds busy{ 0 };
+};
+
+class active_transaction_record;
+
 class transactions_cleanup
 {
   public:
@@ -138,7 +156,7 @@ class transactions_cleanup
     atr_cleanup_queue atr_queue_;
     mutable std::condition_variable cv_;
     mutable std::mutex mutex_;
-    std::list<std::thread> lost_attempt_cleanup_workers_;
+    std::thread lost_attempts_thr_;
 
     const std::string client_uuid_;
     std::list<couchbase::transactions::transaction_keyspace> collections_;
@@ -154,11 +172,19 @@ class transactions_cleanup
     template<class R, class P>
     bool interruptable_wait(std::chrono::duration<R, P> time);
 
+    bool wait_for_lost_attempts_batch(std::chrono::steady_clock::time_point deadline, std::size_t known_collections);
+
     void lost_attempts_loop();
-    void clean_collection(const couchbase::transactions::transaction_keyspace& keyspace);
+    void clean_lost_attempts_batch(lost_attempts_collection_state& state);
+    void record_window_utilisation(const lost_attempts_collection_state& state);
+    void order_atrs_by_node(const std::string& bucket_name, std::vector<std::string>& atrs);
+    std::vector<std::pair<core::document_id, active_transaction_record>> fetch_atrs(const std::vector<core::document_id>& atr_ids);
     void create_client_record(const couchbase::transactions::transaction_keyspace& keyspace);
     const atr_cleanup_stats handle_atr_cleanup(const core::document_id& atr_id,
                                                std::vector<transactions_cleanup_attempt>* result = nullptr);
+    const atr_cleanup_stats clean_atr(const core::document_id& atr_id,
+                                      const active_transaction_record& atr,
+                                      std::vector<transactions_cleanup_attempt>* result = nullptr);
     bool running_{ false };
 };
 } // namespace transactions
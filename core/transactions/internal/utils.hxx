@@ -21,6 +21,9 @@
 #include "core/transactions/result.hxx"
 #include "exceptions_internal.hxx"
 
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+
 #include <chrono>
 #include <cmath>
 #include <functional>
@@ -85,6 +88,10 @@ wrap_durable_request(T&& req, const couchbase::transactions::transactions_config
 result
 wrap_operation_future(std::future<result>& fut, bool ignore_subdoc_errors = true);
 
+// same checks as wrap_operation_future, but for results delivered to a callback rather than through a future
+void
+validate_operation_result(result& res, bool ignore_subdoc_errors = true);
+
 inline void
 wrap_collection_call(result& res, std::function<void(result&)> call);
 
@@ -167,6 +174,15 @@ jitter()
     return dist(gen);
 }
 
+// delay before the given retry of retry_op_exponential_backoff, for callers which cannot block between attempts
+template<typename Rep, typename Period>
+std::chrono::nanoseconds
+exponential_backoff_delay(std::chrono::duration<Rep, Period> delay, std::size_t retries)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      delay * (jitter() * std::pow(2, std::fmin(DEFAULT_RETRY_OP_EXPONENT_CAP, retries))));
+}
+
 template<typename R, typename R1, typename P1, typename R2, typename P2, typename R3, typename P3>
 R
 retry_op_exponential_backoff_timeout(std::chrono::duration<R1, P1> initial_delay,
@@ -220,6 +236,15 @@ retry_op_exp(std::function<R()> func)
     return retry_op_exponential_backoff<R>(DEFAULT_RETRY_OP_EXP_DELAY, DEFAULT_RETRY_OP_MAX_RETRIES, func);
 }
 
+// schedules handler on the io_context after the given delay, without blocking the calling thread
+template<typename Rep, typename Period, typename Handler>
+void
+async_delay(asio::io_context& io, std::chrono::duration<Rep, Period> delay, Handler&& handler)
+{
+    auto timer = std::make_shared<asio::steady_timer>(io, std::chrono::duration_cast<std::chrono::nanoseconds>(delay));
+    timer->async_wait([timer, handler = std::forward<Handler>(handler)](std::error_code) mutable { handler(); });
+}
+
 template<typename R, typename Rep, typename Period>
 R
 retry_op_constant_delay(std::chrono::duration<Rep, Period> delay, std::size_t max_retries, std::function<R()> func)
@@ -258,11 +283,17 @@ struct exp_delay {
     {
     }
     void operator()() const
+    {
+        std::this_thread::sleep_for(next());
+    }
+
+    // returns the time to wait before the next attempt, so the caller can wait on a timer rather than sleep
+    std::chrono::nanoseconds next() const
     {
         auto now = std::chrono::steady_clock::now();
         if (!end_time) {
             end_time = std::chrono::steady_clock::now() + timeout;
-            return;
+            return std::chrono::nanoseconds::zero();
         }
         if (now > *end_time) {
             throw retry_operation_timeout("timed out");
@@ -272,10 +303,9 @@ struct exp_delay {
             delay = max_delay;
         }
         if (now + delay > *end_time) {
-            std::this_thread::sleep_for(*end_time - now);
-        } else {
-            std::this_thread::sleep_for(delay);
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(*end_time - now);
         }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(delay);
     }
 };
 
@@ -22,6 +22,8 @@
 #include "internal/utils.hxx"
 #include "result.hxx"
 
+#include <memory>
+
 namespace couchbase::core::transactions
 {
 
@@ -150,43 +152,125 @@ staged_mutation_queue::iterate(std::function<void(staged_mutation&)> op)
     }
 }
 
-void
-staged_mutation_queue::commit(attempt_context_impl* ctx)
+namespace
 {
-    CB_ATTEMPT_CTX_LOG_TRACE(ctx, "staged mutations committing...");
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        switch (item.type()) {
-            case staged_mutation_type::REMOVE:
-                remove_doc(ctx, item);
-                break;
-            case staged_mutation_type::INSERT:
-            case staged_mutation_type::REPLACE:
-                commit_doc(ctx, item);
-                break;
+/**
+ * Runs an asynchronous per-document operation over the staged mutations, keeping at most `window` of them in flight. After the first
+ * failure no new operations are started, and the error is reported once the in-flight ones have finished.
+ */
+class staged_mutation_window : public std::enable_shared_from_this<staged_mutation_window>
+{
+  public:
+    using operation = std::function<void(staged_mutation&, std::function<void(std::exception_ptr)>&&)>;
+
+    staged_mutation_window(std::vector<staged_mutation>& items,
+                           std::size_t window,
+                           operation op,
+                           std::function<void(std::exception_ptr)>&& done)
+      : items_(items)
+      , window_(std::max<std::size_t>(1, window))
+      , op_(std::move(op))
+      , done_(std::move(done))
+    {
+    }
+
+    void run()
+    {
+        if (items_.empty()) {
+            return done_({});
+        }
+        for (std::size_t i = 0; i < window_; ++i) {
+            launch_next();
+        }
+    }
+
+  private:
+    void launch_next()
+    {
+        std::size_t index{};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error_ || next_ >= items_.size() || in_flight_ >= window_) {
+                return;
+            }
+            index = next_++;
+            ++in_flight_;
+        }
+        op_(items_[index], [self = shared_from_this()](std::exception_ptr err) { self->on_complete(err); });
+    }
+
+    void on_complete(std::exception_ptr err)
+    {
+        bool done = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --in_flight_;
+            if (err && !error_) {
+                error_ = err;
+            }
+            if (in_flight_ == 0 && (error_ || next_ >= items_.size()) && !completed_) {
+                completed_ = done = true;
+            }
+        }
+        if (!done) {
+            return launch_next();
         }
+        done_(error_);
     }
+
+    std::vector<staged_mutation>& items_;
+    const std::size_t window_;
+    operation op_;
+    std::function<void(std::exception_ptr)> done_;
+    std::mutex mutex_{};
+    std::size_t next_{ 0 };
+    std::size_t in_flight_{ 0 };
+    bool completed_{ false };
+    std::exception_ptr error_{};
+};
+} // namespace
+
+void
+staged_mutation_queue::commit(attempt_context_impl* ctx, VoidCallback&& cb, std::size_t window)
+{
+    CB_ATTEMPT_CTX_LOG_TRACE(ctx, "staged mutations committing...");
+    std::make_shared<staged_mutation_window>(
+      queue_,
+      window,
+      [this, ctx](staged_mutation& item, VoidCallback&& item_cb) {
+          switch (item.type()) {
+              case staged_mutation_type::REMOVE:
+                  return remove_doc(ctx, item, std::move(item_cb));
+              case staged_mutation_type::INSERT:
+              case staged_mutation_type::REPLACE:
+                  return commit_doc(ctx, item, std::move(item_cb));
+          }
+      },
+      std::move(cb))
+      ->run();
 }
 
 void
-staged_mutation_queue::rollback(attempt_context_impl* ctx)
+staged_mutation_queue::rollback(attempt_context_impl* ctx, VoidCallback&& cb, std::size_t window)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto& item : queue_) {
-        switch (item.type()) {
-            case staged_mutation_type::INSERT:
-                retry_op_exp<void>([&]() { rollback_insert(ctx, item); });
-                break;
-            case staged_mutation_type::REMOVE:
-            case staged_mutation_type::REPLACE:
-                retry_op_exp<void>([&]() { rollback_remove_or_replace(ctx, item); });
-                break;
-        }
-    }
+    std::make_shared<staged_mutation_window>(
+      queue_,
+      window,
+      [this, ctx](staged_mutation& item, VoidCallback&& item_cb) {
+          switch (item.type()) {
+              case staged_mutation_type::INSERT:
+                  return rollback_insert(ctx, item, std::move(item_cb));
+              case staged_mutation_type::REMOVE:
+              case staged_mutation_type::REPLACE:
+                  return rollback_remove_or_replace(ctx, item, std::move(item_cb));
+          }
+      },
+      std::move(cb))
+      ->run();
 }
 
 void
-staged_mutation_queue::rollback_insert(attempt_context_impl* ctx, const staged_mutation& item)
+staged_mutation_queue::rollback_insert(attempt_context_impl* ctx, const staged_mutation& item, VoidCallback&& cb, std::size_t retries)
 {
     try {
         CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rolling back staged insert for {} with cas {}", item.doc().id(), item.doc().cas().value());
@@ -198,26 +282,42 @@ staged_mutation_queue::rollback_insert(attempt_context_impl* ctx, const staged_m
         if (ec) {
             throw client_error(*ec, "before_rollback_delete_insert hook threw error");
         }
-        core::operations::mutate_in_request req{ item.doc().id() };
-        req.specs =
-          couchbase::mutate_in_specs{
-              couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
-          }
-            .specs();
-        req.access_deleted = true;
-        req.cas = item.doc().cas();
-        wrap_durable_request(req, ctx->overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        ctx->cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        auto res = wrap_operation_future(f);
-        CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
-        ec = ctx->hooks_.after_rollback_delete_inserted(ctx, item.doc().id().key());
-        if (ec) {
-            throw client_error(*ec, "after_rollback_delete_insert hook threw error");
-        }
     } catch (const client_error& e) {
+        return handle_rollback_insert_error(ctx, item, e, std::move(cb), retries);
+    }
+    core::operations::mutate_in_request req{ item.doc().id() };
+    req.specs =
+      couchbase::mutate_in_specs{
+          couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
+      }
+        .specs();
+    req.access_deleted = true;
+    req.cas = item.doc().cas();
+    wrap_durable_request(req, ctx->overall_.config());
+    ctx->cluster_ref()->execute(req, [this, ctx, &item, cb = std::move(cb), retries](core::operations::mutate_in_response resp) mutable {
+        try {
+            auto res = result::create_from_subdoc_response(resp);
+            validate_operation_result(res);
+            CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
+            auto ec = ctx->hooks_.after_rollback_delete_inserted(ctx, item.doc().id().key());
+            if (ec) {
+                throw client_error(*ec, "after_rollback_delete_insert hook threw error");
+            }
+        } catch (const client_error& e) {
+            return handle_rollback_insert_error(ctx, item, e, std::move(cb), retries);
+        }
+        cb({});
+    });
+}
+
+void
+staged_mutation_queue::handle_rollback_insert_error(attempt_context_impl* ctx,
+                                                    const staged_mutation& item,
+                                                    const client_error& e,
+                                                    VoidCallback&& cb,
+                                                    std::size_t retries)
+{
+    try {
         auto ec = e.ec();
         if (ctx->expiry_overtime_mode_.load()) {
             CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback_insert for {} error while in overtime mode {}", item.doc().id(), e.what());
@@ -236,15 +336,30 @@ staged_mutation_queue::rollback_insert(attempt_context_impl* ctx, const staged_m
             case FAIL_DOC_NOT_FOUND:
             case FAIL_PATH_NOT_FOUND:
                 // already cleaned up?
-                return;
+                break;
             default:
                 throw retry_operation("retry rollback insert");
         }
+    } catch (const retry_operation&) {
+        if (retries >= DEFAULT_RETRY_OP_MAX_RETRIES) {
+            return cb(std::make_exception_ptr(retry_operation_retries_exhausted("retry_op hit max retries!")));
+        }
+        return async_delay(ctx->cluster_ref()->io_context(),
+                           exponential_backoff_delay(DEFAULT_RETRY_OP_EXP_DELAY, retries),
+                           [this, ctx, &item, cb = std::move(cb), retries]() mutable {
+                               rollback_insert(ctx, item, std::move(cb), retries + 1);
+                           });
+    } catch (...) {
+        return cb(std::current_exception());
     }
+    cb({});
 }
 
 void
-staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx, const staged_mutation& item)
+staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx,
+                                                  const staged_mutation& item,
+                                                  VoidCallback&& cb,
+                                                  std::size_t retries)
 {
     try {
         CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rolling back staged remove/replace for {} with cas {}", item.doc().id(), item.doc().cas().value());
@@ -256,25 +371,41 @@ staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx, con
         if (ec) {
             throw client_error(*ec, "before_doc_rolled_back hook threw error");
         }
-        core::operations::mutate_in_request req{ item.doc().id() };
-        req.specs =
-          couchbase::mutate_in_specs{
-              couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
-          }
-            .specs();
-        req.cas = item.doc().cas();
-        wrap_durable_request(req, ctx->overall_.config());
-        auto barrier = std::make_shared<std::promise<result>>();
-        auto f = barrier->get_future();
-        ctx->cluster_ref()->execute(
-          req, [barrier](core::operations::mutate_in_response resp) { barrier->set_value(result::create_from_subdoc_response(resp)); });
-        auto res = wrap_operation_future(f);
-        CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
-        ec = ctx->hooks_.after_rollback_replace_or_remove(ctx, item.doc().id().key());
-        if (ec) {
-            throw client_error(*ec, "after_rollback_replace_or_remove hook threw error");
-        }
     } catch (const client_error& e) {
+        return handle_rollback_remove_or_replace_error(ctx, item, e, std::move(cb), retries);
+    }
+    core::operations::mutate_in_request req{ item.doc().id() };
+    req.specs =
+      couchbase::mutate_in_specs{
+          couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
+      }
+        .specs();
+    req.cas = item.doc().cas();
+    wrap_durable_request(req, ctx->overall_.config());
+    ctx->cluster_ref()->execute(req, [this, ctx, &item, cb = std::move(cb), retries](core::operations::mutate_in_response resp) mutable {
+        try {
+            auto res = result::create_from_subdoc_response(resp);
+            validate_operation_result(res);
+            CB_ATTEMPT_CTX_LOG_TRACE(ctx, "rollback result {}", res);
+            auto ec = ctx->hooks_.after_rollback_replace_or_remove(ctx, item.doc().id().key());
+            if (ec) {
+                throw client_error(*ec, "after_rollback_replace_or_remove hook threw error");
+            }
+        } catch (const client_error& e) {
+            return handle_rollback_remove_or_replace_error(ctx, item, e, std::move(cb), retries);
+        }
+        cb({});
+    });
+}
+
+void
+staged_mutation_queue::handle_rollback_remove_or_replace_error(attempt_context_impl* ctx,
+                                                               const staged_mutation& item,
+                                                               const client_error& e,
+                                                               VoidCallback&& cb,
+                                                               std::size_t retries)
+{
+    try {
         auto ec = e.ec();
         if (ctx->expiry_overtime_mode_.load()) {
             throw transaction_operation_failed(FAIL_EXPIRY, std::string("expired while handling ") + e.what()).no_rollback();
@@ -290,62 +421,53 @@ staged_mutation_queue::rollback_remove_or_replace(attempt_context_impl* ctx, con
                 throw retry_operation("retry rollback_remove_or_replace");
             case FAIL_PATH_NOT_FOUND:
                 // already cleaned up?
-                return;
+                break;
             default:
                 throw retry_operation("retry rollback_remove_or_replace");
         }
+    } catch (const retry_operation&) {
+        if (retries >= DEFAULT_RETRY_OP_MAX_RETRIES) {
+            return cb(std::make_exception_ptr(retry_operation_retries_exhausted("retry_op hit max retries!")));
+        }
+        return async_delay(ctx->cluster_ref()->io_context(),
+                           exponential_backoff_delay(DEFAULT_RETRY_OP_EXP_DELAY, retries),
+                           [this, ctx, &item, cb = std::move(cb), retries]() mutable {
+                               rollback_remove_or_replace(ctx, item, std::move(cb), retries + 1);
+                           });
+    } catch (...) {
+        return cb(std::current_exception());
     }
+    cb({});
 }
+
 void
-staged_mutation_queue::commit_doc(attempt_context_impl* ctx, staged_mutation& item, bool ambiguity_resolution_mode, bool cas_zero_mode)
+staged_mutation_queue::commit_doc(attempt_context_impl* ctx,
+                                  staged_mutation& item,
+                                  VoidCallback&& cb,
+                                  bool ambiguity_resolution_mode,
+                                  bool cas_zero_mode)
 {
-    retry_op<void>([&]() {
-        CB_ATTEMPT_CTX_LOG_TRACE(
-          ctx, "commit doc {}, cas_zero_mode {}, ambiguity_resolution_mode {}", item.doc().id(), cas_zero_mode, ambiguity_resolution_mode);
-        try {
-            ctx->check_expiry_during_commit_or_rollback(STAGE_COMMIT_DOC, std::optional<const std::string>(item.doc().id().key()));
-            auto ec = ctx->hooks_.before_doc_committed(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "before_doc_committed hook threw error");
-            }
+    CB_ATTEMPT_CTX_LOG_TRACE(
+      ctx, "commit doc {}, cas_zero_mode {}, ambiguity_resolution_mode {}", item.doc().id(), cas_zero_mode, ambiguity_resolution_mode);
+    try {
+        ctx->check_expiry_during_commit_or_rollback(STAGE_COMMIT_DOC, std::optional<const std::string>(item.doc().id().key()));
+        auto ec = ctx->hooks_.before_doc_committed(ctx, item.doc().id().key());
+        if (ec) {
+            throw client_error(*ec, "before_doc_committed hook threw error");
+        }
+    } catch (const client_error& e) {
+        return handle_commit_doc_error(ctx, item, e, std::move(cb), ambiguity_resolution_mode, cas_zero_mode);
+    }
 
-            // move staged content into doc
-            CB_ATTEMPT_CTX_LOG_TRACE(
-              ctx, "commit doc id {}, content {}, cas {}", item.doc().id(), to_string(item.content()), item.doc().cas().value());
-
-            result res;
-            if (item.type() == staged_mutation_type::INSERT && !cas_zero_mode) {
-                core::operations::insert_request req{ item.doc().id(), item.content() };
-                req.flags = couchbase::codec::codec_flags::json_common_flags;
-                wrap_durable_request(req, ctx->overall_.config());
-                auto barrier = std::make_shared<std::promise<result>>();
-                auto f = barrier->get_future();
-                ctx->cluster_ref()->execute(req, [barrier](core::operations::insert_response resp) {
-                    barrier->set_value(result::create_from_mutation_response(resp));
-                });
-                res = wrap_operation_future(f);
-            } else {
-                core::operations::mutate_in_request req{ item.doc().id() };
-                req.specs =
-                  couchbase::mutate_in_specs{
-                      couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
-                      // subdoc::opcode::set_doc used in replace w/ empty path
-                      couchbase::mutate_in_specs::replace_raw("", item.content()),
-                  }
-                    .specs();
-                req.store_semantics = couchbase::store_semantics::replace;
-                req.cas = couchbase::cas(cas_zero_mode ? 0 : item.doc().cas().value());
-                wrap_durable_request(req, ctx->overall_.config());
-                auto barrier = std::make_shared<std::promise<result>>();
-                auto f = barrier->get_future();
-                ctx->cluster_ref()->execute(req, [barrier](core::operations::mutate_in_response resp) {
-                    barrier->set_value(result::create_from_subdoc_response(resp));
-                });
-                res = wrap_operation_future(f);
-            }
+    // move staged content into doc
+    CB_ATTEMPT_CTX_LOG_TRACE(ctx, "commit doc id {}, content {}, cas {}", item.doc().id(), to_string(item.content()), item.doc().cas().value());
+
+    auto handler = [this, ctx, &item, cb = std::move(cb), ambiguity_resolution_mode, cas_zero_mode](result res) mutable {
+        try {
+            validate_operation_result(res);
             CB_ATTEMPT_CTX_LOG_TRACE(ctx, "commit doc result {}", res);
             // TODO: mutation tokens
-            ec = ctx->hooks_.after_doc_committed_before_saving_cas(ctx, item.doc().id().key());
+            auto ec = ctx->hooks_.after_doc_committed_before_saving_cas(ctx, item.doc().id().key());
             if (ec) {
                 throw client_error(*ec, "after_doc_committed_before_saving_cas threw error");
             }
@@ -355,62 +477,127 @@ staged_mutation_queue::commit_doc(attempt_context_impl* ctx, staged_mutation& it
                 throw client_error(*ec, "after_doc_committed threw error");
             }
         } catch (const client_error& e) {
-            error_class ec = e.ec();
-            if (ctx->expiry_overtime_mode_.load()) {
-                throw transaction_operation_failed(FAIL_EXPIRY, "expired during commit").no_rollback().failed_post_commit();
-            }
-            switch (ec) {
-                case FAIL_AMBIGUOUS:
-                    ambiguity_resolution_mode = true;
-                    throw retry_operation("FAIL_AMBIGUOUS in commit_doc");
-                case FAIL_CAS_MISMATCH:
-                case FAIL_DOC_ALREADY_EXISTS:
-                    if (ambiguity_resolution_mode) {
-                        throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-                    }
-                    ambiguity_resolution_mode = true;
-                    cas_zero_mode = true;
-                    throw retry_operation("FAIL_DOC_ALREADY_EXISTS in commit_doc");
-                default:
+            return handle_commit_doc_error(ctx, item, e, std::move(cb), ambiguity_resolution_mode, cas_zero_mode);
+        }
+        cb({});
+    };
+
+    if (item.type() == staged_mutation_type::INSERT && !cas_zero_mode) {
+        core::operations::insert_request req{ item.doc().id(), item.content() };
+        req.flags = couchbase::codec::codec_flags::json_common_flags;
+        wrap_durable_request(req, ctx->overall_.config());
+        ctx->cluster_ref()->execute(req, [handler = std::move(handler)](core::operations::insert_response resp) mutable {
+            handler(result::create_from_mutation_response(resp));
+        });
+    } else {
+        core::operations::mutate_in_request req{ item.doc().id() };
+        req.specs =
+          couchbase::mutate_in_specs{
+              couchbase::mutate_in_specs::remove(TRANSACTION_INTERFACE_PREFIX_ONLY).xattr(),
+              // subdoc::opcode::set_doc used in replace w/ empty path
+              couchbase::mutate_in_specs::replace_raw("", item.content()),
+          }
+            .specs();
+        req.store_semantics = couchbase::store_semantics::replace;
+        req.cas = couchbase::cas(cas_zero_mode ? 0 : item.doc().cas().value());
+        wrap_durable_request(req, ctx->overall_.config());
+        ctx->cluster_ref()->execute(req, [handler = std::move(handler)](core::operations::mutate_in_response resp) mutable {
+            handler(result::create_from_subdoc_response(resp));
+        });
+    }
+}
+
+void
+staged_mutation_queue::handle_commit_doc_error(attempt_context_impl* ctx,
+                                               staged_mutation& item,
+                                               const client_error& e,
+                                               VoidCallback&& cb,
+                                               bool ambiguity_resolution_mode,
+                                               bool cas_zero_mode)
+{
+    try {
+        error_class ec = e.ec();
+        if (ctx->expiry_overtime_mode_.load()) {
+            throw transaction_operation_failed(FAIL_EXPIRY, "expired during commit").no_rollback().failed_post_commit();
+        }
+        switch (ec) {
+            case FAIL_AMBIGUOUS:
+                ambiguity_resolution_mode = true;
+                throw retry_operation("FAIL_AMBIGUOUS in commit_doc");
+            case FAIL_CAS_MISMATCH:
+            case FAIL_DOC_ALREADY_EXISTS:
+                if (ambiguity_resolution_mode) {
                     throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-            }
+                }
+                ambiguity_resolution_mode = true;
+                cas_zero_mode = true;
+                throw retry_operation("FAIL_DOC_ALREADY_EXISTS in commit_doc");
+            default:
+                throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
         }
-    });
+    } catch (const retry_operation&) {
+        return async_delay(ctx->cluster_ref()->io_context(),
+                           DEFAULT_RETRY_OP_DELAY,
+                           [this, ctx, &item, cb = std::move(cb), ambiguity_resolution_mode, cas_zero_mode]() mutable {
+                               commit_doc(ctx, item, std::move(cb), ambiguity_resolution_mode, cas_zero_mode);
+                           });
+    } catch (...) {
+        return cb(std::current_exception());
+    }
 }
 
 void
-staged_mutation_queue::remove_doc(attempt_context_impl* ctx, const staged_mutation& item)
+staged_mutation_queue::remove_doc(attempt_context_impl* ctx, const staged_mutation& item, VoidCallback&& cb)
 {
-    retry_op<void>([&] {
+    try {
+        ctx->check_expiry_during_commit_or_rollback(STAGE_REMOVE_DOC, std::optional<const std::string>(item.doc().id().key()));
+        auto ec = ctx->hooks_.before_doc_removed(ctx, item.doc().id().key());
+        if (ec) {
+            throw client_error(*ec, "before_doc_removed hook threw error");
+        }
+    } catch (const client_error& e) {
+        return handle_remove_doc_error(ctx, item, e, std::move(cb));
+    }
+    core::operations::remove_request req{ item.doc().id() };
+    wrap_durable_request(req, ctx->overall_.config());
+    ctx->cluster_ref()->execute(req, [this, ctx, &item, cb = std::move(cb)](core::operations::remove_response resp) mutable {
         try {
-            ctx->check_expiry_during_commit_or_rollback(STAGE_REMOVE_DOC, std::optional<const std::string>(item.doc().id().key()));
-            auto ec = ctx->hooks_.before_doc_removed(ctx, item.doc().id().key());
-            if (ec) {
-                throw client_error(*ec, "before_doc_removed hook threw error");
-            }
-            core::operations::remove_request req{ item.doc().id() };
-            wrap_durable_request(req, ctx->overall_.config());
-            auto barrier = std::make_shared<std::promise<result>>();
-            auto f = barrier->get_future();
-            ctx->cluster_ref()->execute(
-              req, [barrier](core::operations::remove_response resp) { barrier->set_value(result::create_from_mutation_response(resp)); });
-            wrap_operation_future(f);
-            ec = ctx->hooks_.after_doc_removed_pre_retry(ctx, item.doc().id().key());
+            auto res = result::create_from_mutation_response(resp);
+            validate_operation_result(res);
+            auto ec = ctx->hooks_.after_doc_removed_pre_retry(ctx, item.doc().id().key());
             if (ec) {
                 throw client_error(*ec, "after_doc_removed_pre_retry threw error");
             }
         } catch (const client_error& e) {
-            error_class ec = e.ec();
-            if (ctx->expiry_overtime_mode_.load()) {
-                throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-            }
-            switch (ec) {
-                case FAIL_AMBIGUOUS:
-                    throw retry_operation("remove_doc got FAIL_AMBIGUOUS");
-                default:
-                    throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
-            }
+            return handle_remove_doc_error(ctx, item, e, std::move(cb));
         }
+        cb({});
     });
 }
+
+void
+staged_mutation_queue::handle_remove_doc_error(attempt_context_impl* ctx,
+                                               const staged_mutation& item,
+                                               const client_error& e,
+                                               VoidCallback&& cb)
+{
+    try {
+        error_class ec = e.ec();
+        if (ctx->expiry_overtime_mode_.load()) {
+            throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
+        }
+        switch (ec) {
+            case FAIL_AMBIGUOUS:
+                throw retry_operation("remove_doc got FAIL_AMBIGUOUS");
+            default:
+                throw transaction_operation_failed(ec, e.what()).no_rollback().failed_post_commit();
+        }
+    } catch (const retry_operation&) {
+        return async_delay(ctx->cluster_ref()->io_context(), DEFAULT_RETRY_OP_DELAY, [this, ctx, &item, cb = std::move(cb)]() mutable {
+            remove_doc(ctx, item, std::move(cb));
+        });
+    } catch (...) {
+        return cb(std::current_exception());
+    }
+}
 } // namespace couchbase::core::transactions
@@ -21,6 +21,8 @@
 #include "transaction_get_result.hxx"
 #include "uid_generator.hxx"
 
+#include <exception>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -109,22 +111,51 @@ class staged_mutation
     }
 };
 
+// maximum number of staged mutations being committed or rolled back concurrently
+static constexpr std::size_t DEFAULT_STAGED_MUTATION_WINDOW{ 32 };
+
 class staged_mutation_queue
 {
+  public:
+    using VoidCallback = std::function<void(std::exception_ptr)>;
+
   private:
     std::mutex mutex_;
     std::vector<staged_mutation> queue_;
-    void commit_doc(attempt_context_impl* ctx, staged_mutation& item, bool ambiguity_resolution_mode = false, bool cas_zero_mode = false);
-    void remove_doc(attempt_context_impl* ctx, const staged_mutation& item);
-    void rollback_insert(attempt_context_impl* ctx, const staged_mutation& item);
-    void rollback_remove_or_replace(attempt_context_impl* ctx, const staged_mutation& item);
+    void commit_doc(attempt_context_impl* ctx,
+                    staged_mutation& item,
+                    VoidCallback&& cb,
+                    bool ambiguity_resolution_mode = false,
+                    bool cas_zero_mode = false);
+    void remove_doc(attempt_context_impl* ctx, const staged_mutation& item, VoidCallback&& cb);
+    void rollback_insert(attempt_context_impl* ctx, const staged_mutation& item, VoidCallback&& cb, std::size_t retries = 0);
+    void rollback_remove_or_replace(attempt_context_impl* ctx, const staged_mutation& item, VoidCallback&& cb, std::size_t retries = 0);
+
+    void handle_commit_doc_error(attempt_context_impl* ctx,
+                                 staged_mutation& item,
+                                 const client_error& e,
+                                 VoidCallback&& cb,
+                                 bool ambiguity_resolution_mode,
+                                 bool cas_zero_mode);
+    void handle_remove_doc_error(attempt_context_impl* ctx, const staged_mutation& item, const client_error& e, VoidCallback&& cb);
+    void handle_rollback_insert_error(attempt_context_impl* ctx,
+                                      const staged_mutation& item,
+                                      const client_error& e,
+                                      VoidCallback&& cb,
+                                      std::size_t retries);
+    void handle_rollback_remove_or_replace_error(attempt_context_impl* ctx,
+                                                 const staged_mutation& item,
+                                                 const client_error& e,
+                                                 VoidCallback&& cb,
+                                                 std::size_t retries);
 
   public:
     bool empty();
     void add(const staged_mutation& mutation);
     void extract_to(const std::string& prefix, core::operations::mutate_in_request& req);
-    void commit(attempt_context_impl* ctx);
-    void rollback(attempt_context_impl* ctx);
+    // the caller must have blocked further operations on the attempt, as the queue is not locked while these run
+    void commit(attempt_context_impl* ctx, VoidCallback&& cb, std::size_t window = DEFAULT_STAGED_MUTATION_WINDOW);
+    void rollback(attempt_context_impl* ctx, VoidCallback&& cb, std::size_t window = DEFAULT_STAGED_MUTATION_WINDOW);
     void iterate(std::function<void(staged_mutation&)>);
     void remove_any(const core::document_id&);
 
@@ -92,11 +92,16 @@ transaction_context::after_delay(std::chrono::milliseconds delay, std::function<
 void
 transaction_context::new_attempt_context(async_attempt_context::VoidCallback&& cb)
 {
-    asio::post(transactions_.cluster_ref()->io_context(), [this, cb = std::move(cb)]() {
-        // the first time we call the delay, it just records an end time.  After that, it
-        // actually delays.
+    // the first time we call the delay, it just records an end time.  After that, it
+    // actually delays.
+    std::chrono::nanoseconds delay{};
+    try {
+        delay = delay_->next();
+    } catch (...) {
+        return cb(std::current_exception());
+    }
+    async_delay(transactions_.cluster_ref()->io_context(), delay, [this, cb = std::move(cb)]() {
         try {
-            (*delay_)();
             current_attempt_context_ = std::make_shared<attempt_context_impl>(*this);
             CB_ATTEMPT_CTX_LOG_INFO(
               current_attempt_context_, "starting attempt {}/{}/{}/", num_attempts(), transaction_id(), current_attempt_context_->id());
@@ -218,68 +223,86 @@ transaction_context::handle_error(std::exception_ptr err, txn_complete_callback&
         CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got transaction_operation_failed {}", er.what());
         if (er.should_rollback()) {
             CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_, "got rollback-able exception, rolling back");
-            try {
-                current_attempt_context_->rollback();
-            } catch (const std::exception& er_rollback) {
-                cleanup().add_attempt(*current_attempt_context_);
-                CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_,
-                                         "got error \"{}\" while auto rolling back, throwing original error",
-                                         er_rollback.what(),
-                                         er.what());
-                auto final = er.get_final_exception(*this);
-                // if you get here, we didn't throw, yet we had an error.  Fall through in
-                // this case.  Note the current logic is such that rollback will not have a
-                // commit ambiguous error, so we should always throw.
-                assert(final);
-                return callback(final, std::nullopt);
-            }
-            if (er.should_retry() && has_expired_client_side()) {
-                CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_, "auto rollback succeeded, however we are expired so no retry");
+            return current_attempt_context_->do_rollback([this, er, callback = std::move(callback)](std::exception_ptr rollback_err) mutable {
+                if (rollback_err) {
+                    std::string rollback_what{ "unexpected error" };
+                    try {
+                        std::rethrow_exception(rollback_err);
+                    } catch (const std::exception& er_rollback) {
+                        rollback_what = er_rollback.what();
+                    } catch (...) {
+                    }
+                    cleanup().add_attempt(*current_attempt_context_);
+                    CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_,
+                                             "got error \"{}\" while auto rolling back, throwing original error",
+                                             rollback_what,
+                                             er.what());
+                    auto final = er.get_final_exception(*this);
+                    // if you get here, we didn't throw, yet we had an error.  Fall through in
+                    // this case.  Note the current logic is such that rollback will not have a
+                    // commit ambiguous error, so we should always throw.
+                    assert(final);
+                    return callback(final, std::nullopt);
+                }
+                if (er.should_retry() && has_expired_client_side()) {
+                    CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_, "auto rollback succeeded, however we are expired so no retry");
 
-                return callback(
-                  transaction_operation_failed(FAIL_EXPIRY, "expired in auto rollback").no_rollback().expired().get_final_exception(*this),
-                  {});
-            }
-        }
-        if (er.should_retry()) {
-            CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_, "got retryable exception, retrying");
-            cleanup().add_attempt(*current_attempt_context_);
-            return callback(std::nullopt, std::nullopt);
+                    return callback(transaction_operation_failed(FAIL_EXPIRY, "expired in auto rollback")
+                                      .no_rollback()
+                                      .expired()
+                                      .get_final_exception(*this),
+                                    {});
+                }
+                complete_with_error(er, std::move(callback));
+            });
         }
-
-        // throw the expected exception here
-        cleanup().add_attempt(*current_attempt_context_);
-        auto final = er.get_final_exception(*this);
-        std::optional<::couchbase::transactions::transaction_result> res;
-        if (!final) {
-            res = get_transaction_result();
-        }
-        return callback(final, res);
+        return complete_with_error(er, std::move(callback));
     } catch (const std::exception& ex) {
         CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got runtime error \"{}\"", ex.what());
-        try {
-            current_attempt_context_->rollback();
-        } catch (...) {
-            CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got error rolling back \"{}\"", ex.what());
-        }
-        cleanup().add_attempt(*current_attempt_context_);
         // the assumption here is this must come from the logic, not
         // our operations (which only throw transaction_operation_failed),
         auto op_failed = transaction_operation_failed(FAIL_OTHER, ex.what());
-        return callback(op_failed.get_final_exception(*this), std::nullopt);
+        return current_attempt_context_->do_rollback(
+          [this, what = std::string(ex.what()), op_failed, callback = std::move(callback)](std::exception_ptr rollback_err) mutable {
+              if (rollback_err) {
+                  CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got error rolling back \"{}\"", what);
+              }
+              cleanup().add_attempt(*current_attempt_context_);
+              return callback(op_failed.get_final_exception(*this), std::nullopt);
+          });
     } catch (...) {
         CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got unexpected error, rolling back");
-        try {
-            current_attempt_context_->rollback();
-        } catch (...) {
-            CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got error rolling back unexpected error");
-        }
-        cleanup().add_attempt(*current_attempt_context_);
         // the assumption here is this must come from the logic, not
         // our operations (which only throw transaction_operation_failed),
         auto op_failed = transaction_operation_failed(FAIL_OTHER, "Unexpected error");
-        return callback(op_failed.get_final_exception(*this), std::nullopt);
+        return current_attempt_context_->do_rollback(
+          [this, op_failed, callback = std::move(callback)](std::exception_ptr rollback_err) mutable {
+              if (rollback_err) {
+                  CB_ATTEMPT_CTX_LOG_ERROR(current_attempt_context_, "got error rolling back unexpected error");
+              }
+              cleanup().add_attempt(*current_attempt_context_);
+              return callback(op_failed.get_final_exception(*this), std::nullopt);
+          });
+    }
+}
+
+void
+transaction_context::complete_with_error(const transaction_operation_failed& er, txn_complete_callback&& callback)
+{
+    if (er.should_retry()) {
+        CB_ATTEMPT_CTX_LOG_TRACE(current_attempt_context_, "got retryable exception, retrying");
+        cleanup().add_attempt(*current_attempt_context_);
+        return callback(std::nullopt, std::nullopt);
+    }
+
+    // throw the expected exception here
+    cleanup().add_attempt(*current_attempt_context_);
+    auto final = er.get_final_exception(*this);
+    std::optional<::couchbase::transactions::transaction_result> res;
+    if (!final) {
+        res = get_transaction_result();
     }
+    return callback(final, res);
 }
 
 void
@@ -20,7 +20,7 @@
 namespace couchbase::core::transactions
 {
 transaction_get_result
-transaction_get_result::create_from(const core::operations::lookup_in_response& resp)
+transaction_get_result::create_from(const core::operations::lookup_in_response& resp, const std::vector<std::string>& projections)
 {
     std::optional<std::string> atr_id;
     std::optional<std::string> transaction_id;
@@ -98,8 +98,20 @@ transaction_get_result::create_from(const core::operations::lookup_in_response&
     } else {
         forward_compat = tao::json::empty_object;
     }
-    if (resp.fields[13].status == key_value_status_code::success) {
-        content = resp.fields[13].value;
+    if (projections.empty()) {
+        if (resp.fields[13].status == key_value_status_code::success) {
+            content = resp.fields[13].value;
+        }
+    } else {
+        tao::json::value projected = tao::json::empty_object;
+        for (std::size_t idx = 0; idx < projections.size(); ++idx) {
+            const auto& field = resp.fields[13 + idx];
+            if (field.status == key_value_status_code::success && !field.value.empty()) {
+                auto value = core::utils::json::parse_binary(field.value);
+                core::operations::subdoc_apply_projection(projected, projections[idx], value, false);
+            }
+        }
+        content = core::utils::json::generate_binary(projected);
     }
 
     transaction_links links(atr_id,
@@ -125,6 +137,27 @@ transaction_get_result::create_from(const core::operations::lookup_in_response&
              std::make_optional(md) };
 }
 
+std::vector<std::byte>
+transaction_get_result::project_content(const std::vector<std::byte>& content, const std::vector<std::string>& projections)
+{
+    if (projections.empty() || content.empty()) {
+        return content;
+    }
+    tao::json::value document;
+    try {
+        document = core::utils::json::parse_binary(content);
+    } catch (const tao::pegtl::parse_error&) {
+        return content;
+    }
+    tao::json::value projected = tao::json::empty_object;
+    for (const auto& path : projections) {
+        if (auto value = core::operations::subdoc_lookup(document, path); value) {
+            core::operations::subdoc_apply_projection(projected, path, *value, false);
+        }
+    }
+    return core::utils::json::generate_binary(projected);
+}
+
 transaction_get_result
 transaction_get_result::create_from(const core::document_id& id, const result& res)
 {
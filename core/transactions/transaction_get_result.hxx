@@ -145,8 +145,19 @@ class transaction_get_result
     /** @internal */
     static transaction_get_result create_from(const core::document_id& id, const result& res);
 
-    /** @internal */
-    static transaction_get_result create_from(const core::operations::lookup_in_response& resp);
+    /**
+     * @internal
+     * When @p projections is not empty, the lookup fetched those paths of the body (in order) instead of the whole body.
+     */
+    static transaction_get_result create_from(const core::operations::lookup_in_response& resp,
+                                              const std::vector<std::string>& projections = {});
+
+    /**
+     * @internal
+     * Keeps only the given paths of the JSON @p content.  Returns the content untouched when there are no projections, or it is
+     * not JSON.
+     */
+    static std::vector<std::byte> project_content(const std::vector<std::byte>& content, const std::vector<std::string>& projections);
 
     /** @internal */
     template<typename Content>
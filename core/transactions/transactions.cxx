@@ -139,32 +139,84 @@ transactions::run(couchbase::transactions::txn_logic&& code, const couchbase::tr
     }
 }
 
+template<typename Handler>
 void
-transactions::run(const couchbase::transactions::transaction_options& config, async_logic&& code, txn_complete_callback&& cb)
+wrap_run_attempt(std::shared_ptr<transaction_context> overall,
+                 std::shared_ptr<Handler> fn,
+                 std::size_t attempts_left,
+                 txn_complete_callback&& cb)
 {
-    std::thread([this, config, code = std::move(code), cb = std::move(cb)]() {
+    if (attempts_left == 0) {
+        // only thing to do here is return, but we really exceeded the max attempts
+        return cb(std::nullopt, overall->get_transaction_result());
+    }
+    // NOTE: new_attempt_context schedules the exponential backoff on the io_context rather than sleeping,
+    // so no thread is held while waiting between attempts.
+    overall->new_attempt_context([overall, fn, attempts_left, cb = std::move(cb)](std::exception_ptr err) mutable {
+        if (err) {
+            return cb(transaction_operation_failed(FAIL_EXPIRY, "transaction expired before starting attempt")
+                        .no_rollback()
+                        .expired()
+                        .get_final_exception(*overall),
+                      std::nullopt);
+        }
+        auto finalize_handler = [overall, fn, attempts_left, cb = std::move(cb)](
+                                  std::optional<transaction_exception> final_err,
+                                  std::optional<couchbase::transactions::transaction_result> result) mutable {
+            if (result) {
+                return cb(std::nullopt, result);
+            }
+            if (final_err) {
+                return cb(final_err, std::nullopt);
+            }
+            // no return value, no exception means retry.
+            wrap_run_attempt(overall, fn, attempts_left - 1, std::move(cb));
+        };
         try {
-            auto result = wrap_run(*this, config, max_attempts_, std::move(code));
-            return cb({}, result);
-        } catch (const transaction_exception& e) {
-            return cb(e, std::nullopt);
+            auto ctx = overall->current_attempt_context();
+            (*fn)(*ctx);
+        } catch (...) {
+            return overall->handle_error(std::current_exception(), std::move(finalize_handler));
         }
-    }).detach();
+        overall->finalize(std::move(finalize_handler));
+    });
 }
+
+template<typename Handler>
+void
+wrap_run_async(transactions& txns,
+               const couchbase::transactions::transaction_options& config,
+               std::size_t max_attempts,
+               Handler&& fn,
+               txn_complete_callback&& cb)
+{
+    auto overall = std::make_shared<transaction_context>(txns, config);
+    wrap_run_attempt(overall, std::make_shared<std::decay_t<Handler>>(std::forward<Handler>(fn)), max_attempts, std::move(cb));
+}
+
+void
+transactions::run(const couchbase::transactions::transaction_options& config, async_logic&& code, txn_complete_callback&& cb)
+{
+    wrap_run_async(*this, config, max_attempts_, std::move(code), std::move(cb));
+}
+
 void
 transactions::run(couchbase::transactions::async_txn_logic&& code,
                   couchbase::transactions::async_txn_complete_logic&& cb,
                   const couchbase::transactions::transaction_options& config)
 {
-    std::thread([this, config, code = std::move(code), cb = std::move(cb)]() {
-        try {
-            auto result = wrap_run(*this, config, max_attempts_, std::move(code));
-            return cb({}, result);
-        } catch (const transaction_exception& e) {
-            auto [ctx, res] = e.get_transaction_result();
-            return cb(ctx, res);
-        }
-    }).detach();
+    wrap_run_async(*this,
+                   config,
+                   max_attempts_,
+                   std::move(code),
+                   [cb = std::move(cb)](std::optional<transaction_exception> err,
+                                        std::optional<couchbase::transactions::transaction_result> result) {
+                       if (err) {
+                           auto [ctx, res] = err->get_transaction_result();
+                           return cb(ctx, res);
+                       }
+                       cb({}, result.value_or(couchbase::transactions::transaction_result{}));
+                   });
 }
 
 void
@@ -26,9 +26,14 @@
 #include "internal/transactions_cleanup.hxx"
 #include "internal/utils.hxx"
 
+#include "core/cluster.hxx"
+
 #include <algorithm>
 #include <chrono>
 #include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
 
 namespace couchbase::core::transactions
 {
@@ -51,6 +56,9 @@ transactions_cleanup::transactions_cleanup(std::shared_ptr<core::cluster> cluste
     if (config.cleanup_config.cleanup_client_attempts) {
         cleanup_thr_ = std::thread(std::bind(&transactions_cleanup::attempts_loop, this));
     }
+    if (config.cleanup_config.cleanup_lost_attempts) {
+        lost_attempts_thr_ = std::thread(std::bind(&transactions_cleanup::lost_attempts_loop, this));
+    }
     if (config_.metadata_collection) {
         add_collection(
           { config_.metadata_collection->bucket, config_.metadata_collection->scope, config_.metadata_collection->collection });
@@ -104,6 +112,7 @@ static const std::string FIELD_OVERRIDE = "override";
 static const std::string FIELD_OVERRIDE_EXPIRES = "expires";
 static const std::string FIELD_OVERRIDE_ENABLED = "enabled";
 static const std::string FIELD_NUM_ATRS = "num_atrs";
+static const std::string WINDOW_UTILISATION_METER_NAME = "db.couchbase.transactions.cleanup.window_utilisation";
 
 #define SAFETY_MARGIN_EXPIRY_MS 2000
 
@@ -120,111 +129,230 @@ transactions_cleanup::interruptable_wait(std::chrono::duration<R, P> delay)
     return running_;
 }
 
+bool
+transactions_cleanup::wait_for_lost_attempts_batch(std::chrono::steady_clock::time_point deadline, std::size_t known_collections)
+{
+    // wait until the next batch is due, _or_ we are closed, _or_ a new collection needs to be scanned
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_until(lock, deadline, [&]() { return !running_ || collections_.size() != known_collections; });
+    return running_;
+}
+
 void
-transactions_cleanup::clean_collection(const couchbase::transactions::transaction_keyspace& keyspace)
+transactions_cleanup::lost_attempts_loop()
 {
-    // first make sure the collection is in the list
+    CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("lost attempts loop starting...");
+    std::list<lost_attempts_collection_state> states;
     while (is_running()) {
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (collections_.end() == std::find(collections_.begin(), collections_.end(), keyspace)) {
-                CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("cleanup for {} ending, no longer in collection cleanup list", keyspace);
-                return;
+        for (auto& keyspace : collections()) {
+            if (std::none_of(states.begin(), states.end(), [&keyspace](const auto& state) { return keyspace == state.keyspace; })) {
+                CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("cleanup for {} starting", keyspace);
+                states.push_back({ keyspace });
             }
         }
-        CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("cleanup for {} starting", keyspace);
-        // we are running, and collection is in the list, so lets clean it.
-        try {
-            auto details = get_active_clients(keyspace, client_uuid_);
-
-            auto all_atrs = atr_ids::all();
+        auto now = std::chrono::steady_clock::now();
+        auto state = std::min_element(
+          states.begin(), states.end(), [](const auto& lhs, const auto& rhs) { return lhs.next_batch < rhs.next_batch; });
+        auto deadline = state == states.end() ? now + config_.cleanup_config.cleanup_window : state->next_batch;
+        if (deadline > now && !wait_for_lost_attempts_batch(deadline, states.size())) {
+            break;
+        }
+        if (state == states.end() || std::chrono::steady_clock::now() < state->next_batch) {
+            // woken up early by a new collection, pick it up before going on
+            continue;
+        }
+        clean_lost_attempts_batch(*state);
+    }
+    CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("lost attempts loop stopping");
+}
 
-            std::chrono::microseconds cleanup_window =
-              std::chrono::duration_cast<std::chrono::microseconds>(config_.cleanup_config.cleanup_window);
-            auto start = std::chrono::steady_clock::now();
-            CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("{} active clients (including this one), {} ATRs to check in {}ms",
+void
+transactions_cleanup::clean_lost_attempts_batch(lost_attempts_collection_state& state)
+{
+    auto batch_start = std::chrono::steady_clock::now();
+    try {
+        if (state.next_atr == 0) {
+            // start of a cleanup window: heartbeat our client record, and work out which ATRs are ours to check
+            auto details = get_active_clients(state.keyspace, client_uuid_);
+            const auto& all_atrs = atr_ids::all();
+            state.atrs.clear();
+            for (std::size_t idx = details.index_of_this_client; idx < all_atrs.size();
+                 idx += std::max<std::size_t>(1, details.num_active_clients)) {
+                state.atrs.push_back(all_atrs[idx]);
+            }
+            order_atrs_by_node(state.keyspace.bucket, state.atrs);
+            state.window_start = batch_start;
+            state.busy = std::chrono::microseconds::zero();
+            CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("{} active clients (including this one), {} of {} ATRs to check in {}ms",
                                              details.num_active_clients,
+                                             state.atrs.size(),
                                              all_atrs.size(),
                                              config_.cleanup_config.cleanup_window.count());
+        }
+    } catch (const std::exception& ex) {
+        CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup failed with {}, trying again in 3 sec...", ex.what());
+        // we must have gotten an exception trying to get the client records.   Let's wait 3 sec and try again
+        state.next_batch = batch_start + std::chrono::seconds(3);
+        return;
+    }
 
-            for (auto it = all_atrs.begin() + details.index_of_this_client; it < all_atrs.end(); it += details.num_active_clients) {
-                auto atrs_left_for_this_client =
-                  std::distance(it, all_atrs.end()) / std::max<decltype(it)::difference_type>(1, details.num_active_clients);
-                auto now = std::chrono::steady_clock::now();
-                std::chrono::microseconds elapsed_in_cleanup_window = std::chrono::duration_cast<std::chrono::microseconds>(now - start);
-                std::chrono::microseconds remaining_in_cleanup_window = cleanup_window - elapsed_in_cleanup_window;
-                std::chrono::microseconds budget_for_this_atr = std::chrono::microseconds(
-                  remaining_in_cleanup_window.count() / std::max<decltype(it)::difference_type>(1, atrs_left_for_this_client));
-                // clean the ATR entry
-                std::string atr_id = *it;
-                if (!is_running()) {
-                    CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("cleanup of {} complete", keyspace);
-                    return;
-                }
+    auto cleanup_window = std::chrono::duration_cast<std::chrono::microseconds>(config_.cleanup_config.cleanup_window);
+    auto remaining_in_cleanup_window =
+      cleanup_window - std::chrono::duration_cast<std::chrono::microseconds>(batch_start - state.window_start);
+    auto atrs_left_for_this_client = state.atrs.size() - state.next_atr;
+    auto batches_left_for_this_client = (atrs_left_for_this_client + DEFAULT_LOST_ATTEMPTS_BATCH_SIZE - 1) / DEFAULT_LOST_ATTEMPTS_BATCH_SIZE;
 
-                try {
-                    handle_atr_cleanup({ keyspace.bucket, keyspace.scope, keyspace.collection, atr_id });
-                } catch (const std::exception& e) {
-                    CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of atr {} failed with {}, moving on", atr_id, e.what());
-                }
+    // the lookups of one batch are all in flight together, and as the ATRs are ordered by node they mostly go to the same one
+    std::vector<core::document_id> batch;
+    for (; state.next_atr < state.atrs.size() && batch.size() < DEFAULT_LOST_ATTEMPTS_BATCH_SIZE; ++state.next_atr) {
+        batch.emplace_back(state.keyspace.bucket, state.keyspace.scope, state.keyspace.collection, state.atrs[state.next_atr]);
+    }
+    for (const auto& [atr_id, atr] : fetch_atrs(batch)) {
+        if (!is_running()) {
+            CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("cleanup of {} complete", state.keyspace);
+            return;
+        }
+        try {
+            clean_atr(atr_id, atr);
+        } catch (const std::exception& e) {
+            CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of atr {} failed with {}, moving on", atr_id.key(), e.what());
+        }
+    }
 
-                auto atr_end = std::chrono::steady_clock::now();
-                std::chrono::microseconds atr_used = std::chrono::duration_cast<std::chrono::microseconds>(atr_end - now);
-                std::chrono::microseconds atr_left = budget_for_this_atr - atr_used;
-
-                // Too verbose to log, but leaving here commented as it may be useful later for internal debugging
-                /*CB_LOST_ATTEMPT_CLEANUP_LOG_INFO("{} {} atrs_left_for_this_client={} elapsed_in_cleanup_window={}us "
-                                            "remaining_in_cleanup_window={}us budget_for_this_atr={}us atr_used={}us atr_left={}us",
-                                            bucket_name,
-                                            atr_id,
-                                            atrs_left_for_this_client,
-                                            elapsed_in_cleanup_window.count(),
-                                            remaining_in_cleanup_window.count(),
-                                            budget_for_this_atr.count(),
-                                            atr_used.count(),
-                                            atr_left.count());*/
-
-                if (atr_left.count() > 0 && atr_left.count() < 1000000000) { // safety check protects against bugs
-                    if (!interruptable_wait(atr_left)) {
-                        return;
-                    }
-                }
-            }
-        } catch (const std::exception& ex) {
-            CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup failed with {}, trying again in 3 sec...", ex.what());
-            // we must have gotten an exception trying to get the client records.   Let's wait 3 sec and try again
-            std::this_thread::sleep_for(std::chrono::seconds(3));
+    auto batch_end = std::chrono::steady_clock::now();
+    state.busy += std::chrono::duration_cast<std::chrono::microseconds>(batch_end - batch_start);
+    if (state.next_atr >= state.atrs.size()) {
+        record_window_utilisation(state);
+        state.next_atr = 0;
+        state.next_batch = std::max(batch_end, state.window_start + cleanup_window);
+        return;
+    }
+    // spread whatever is left of the window evenly over the remaining batches
+    auto budget_for_this_batch = std::chrono::microseconds(
+      std::max<std::int64_t>(0, remaining_in_cleanup_window.count()) / std::max<std::int64_t>(1, batches_left_for_this_client));
+    state.next_batch = std::max(batch_end, batch_start + std::min(budget_for_this_batch, cleanup_window));
+}
+
+void
+transactions_cleanup::record_window_utilisation(const lost_attempts_collection_state& state)
+{
+    // percentage of the cleanup window this client actually spent checking and cleaning ATRs.  Above 100 means
+    // the window is too short for the number of ATRs this client is responsible for.
+    auto cleanup_window = std::chrono::duration_cast<std::chrono::microseconds>(config_.cleanup_config.cleanup_window);
+    auto utilisation = 100 * state.busy.count() / std::max<std::int64_t>(1, cleanup_window.count());
+    CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG(
+      "cleanup window of {} complete, checked {} ATRs in {}us, {}% utilised", state.keyspace, state.atrs.size(), state.busy.count(), utilisation);
+    if (auto meter = cluster_->meter(); meter) {
+        meter
+          ->get_value_recorder(WINDOW_UTILISATION_METER_NAME,
+                               {
+                                 { "db.couchbase.service", "transactions" },
+                                 { "db.name", state.keyspace.bucket },
+                                 { "db.couchbase.scope", state.keyspace.scope },
+                                 { "db.couchbase.collection", state.keyspace.collection },
+                               })
+          ->record_value(utilisation);
+    }
+}
+
+void
+transactions_cleanup::order_atrs_by_node(const std::string& bucket_name, std::vector<std::string>& atrs)
+{
+    auto barrier = std::make_shared<std::promise<std::optional<topology::configuration>>>();
+    auto f = barrier->get_future();
+    cluster_->with_bucket_configuration(bucket_name, [barrier](std::error_code ec, const topology::configuration& config) {
+        if (ec) {
+            return barrier->set_value({});
         }
+        barrier->set_value(config);
+    });
+    auto config = f.get();
+    if (!config) {
+        // no configuration to map with, the ATRs will just be checked in their natural order
+        return;
+    }
+    std::vector<std::pair<std::size_t, std::string>> by_node;
+    by_node.reserve(atrs.size());
+    for (auto& atr : atrs) {
+        auto [vbucket, node] = config->map_key(atr, 0);
+        by_node.emplace_back(node.value_or(std::numeric_limits<std::size_t>::max()), std::move(atr));
+    }
+    std::stable_sort(by_node.begin(), by_node.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    atrs.clear();
+    for (auto& [node, atr] : by_node) {
+        atrs.emplace_back(std::move(atr));
     }
 }
 
+std::vector<std::pair<core::document_id, active_transaction_record>>
+transactions_cleanup::fetch_atrs(const std::vector<core::document_id>& atr_ids)
+{
+    struct batch_state {
+        std::mutex mutex{};
+        std::size_t outstanding{ 0 };
+        std::vector<std::pair<core::document_id, active_transaction_record>> found{};
+        std::promise<void> barrier{};
+    };
+    if (atr_ids.empty()) {
+        return {};
+    }
+    auto batch = std::make_shared<batch_state>();
+    batch->outstanding = atr_ids.size();
+    auto f = batch->barrier.get_future();
+    for (const auto& atr_id : atr_ids) {
+        active_transaction_record::get_atr(
+          cluster_, atr_id, [batch, atr_id](std::error_code ec, std::optional<active_transaction_record> atr) {
+              std::unique_lock<std::mutex> lock(batch->mutex);
+              if (ec) {
+                  CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of atr {} failed with {}, moving on", atr_id.key(), ec.message());
+              } else if (atr) {
+                  batch->found.emplace_back(atr_id, std::move(*atr));
+              }
+              if (--batch->outstanding == 0) {
+                  lock.unlock();
+                  batch->barrier.set_value();
+              }
+          });
+    }
+    f.get();
+    return std::move(batch->found);
+}
+
 const atr_cleanup_stats
 transactions_cleanup::handle_atr_cleanup(const core::document_id& atr_id, std::vector<transactions_cleanup_attempt>* results)
+{
+    if (auto atr = active_transaction_record::get_atr(cluster_, atr_id); atr) {
+        return clean_atr(atr_id, *atr, results);
+    }
+    return {};
+}
+
+const atr_cleanup_stats
+transactions_cleanup::clean_atr(const core::document_id& atr_id,
+                                const active_transaction_record& atr,
+                                std::vector<transactions_cleanup_attempt>* results)
 {
     atr_cleanup_stats stats;
-    auto atr = active_transaction_record::get_atr(cluster_, atr_id);
-    if (atr) {
-        // ok, loop through the attempts and clean them all.  The entry will
-        // check if expired, nothing much to do here except call clean.
-        stats.exists = true;
-        stats.num_entries = atr->entries().size();
-        for (const auto& entry : atr->entries()) {
-            // If we were passed results, then we are testing, and want to set the
-            // check_if_expired to false.
-            atr_cleanup_entry cleanup_entry(entry, atr_id, *this, results == nullptr);
-            try {
-                if (results != nullptr) {
-                    results->emplace_back(cleanup_entry);
-                }
-                cleanup_entry.clean(results != nullptr ? &results->back() : nullptr);
-                if (results != nullptr) {
-                    results->back().success(true);
-                }
-            } catch (const std::exception& e) {
-                CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of {} failed: {}, moving on", cleanup_entry, e.what());
-                if (results != nullptr) {
-                    results->back().success(false);
-                }
+    // ok, loop through the attempts and clean them all.  The entry will
+    // check if expired, nothing much to do here except call clean.
+    stats.exists = true;
+    stats.num_entries = atr.entries().size();
+    for (const auto& entry : atr.entries()) {
+        // If we were passed results, then we are testing, and want to set the
+        // check_if_expired to false.
+        atr_cleanup_entry cleanup_entry(entry, atr_id, *this, results == nullptr);
+        try {
+            if (results != nullptr) {
+                results->emplace_back(cleanup_entry);
+            }
+            cleanup_entry.clean(results != nullptr ? &results->back() : nullptr);
+            if (results != nullptr) {
+                results->back().success(true);
+            }
+        } catch (const std::exception& e) {
+            CB_LOST_ATTEMPT_CLEANUP_LOG_ERROR("cleanup of {} failed: {}, moving on", cleanup_entry, e.what());
+            if (results != nullptr) {
+                results->back().success(false);
             }
         }
     }
@@ -543,9 +671,9 @@ transactions_cleanup::add_collection(couchbase::transactions::transaction_keyspa
 
         auto it = std::find(collections_.begin(), collections_.end(), keyspace);
         if (it == collections_.end()) {
-            collections_.emplace_back(std::move(keyspace));
+            collections_.emplace_back(keyspace);
             // start cleaning right away
-            lost_attempt_cleanup_workers_.emplace_back([this, keyspace = collections_.back()]() { this->clean_collection(keyspace); });
+            cv_.notify_all();
         }
         lock.unlock();
         CB_ATTEMPT_CLEANUP_LOG_DEBUG("added {} to lost transaction cleanup", keyspace);
@@ -564,13 +692,10 @@ transactions_cleanup::close()
         cleanup_thr_.join();
         CB_ATTEMPT_CLEANUP_LOG_DEBUG("cleanup attempt thread closed");
     }
-    for (auto& t : lost_attempt_cleanup_workers_) {
-        CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("shutting down all lost attempt threads...");
-        if (t.joinable()) {
-            t.join();
-        }
+    if (lost_attempts_thr_.joinable()) {
+        lost_attempts_thr_.join();
+        CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("lost attempts cleanup thread closed");
     }
-    CB_LOST_ATTEMPT_CLEANUP_LOG_DEBUG("all lost attempt cleanup threads closed");
     remove_client_record_from_all_buckets(client_uuid_);
 }
 
@@ -67,6 +67,13 @@ result
 wrap_operation_future(std::future<result>& fut, bool ignore_subdoc_errors)
 {
     auto res = fut.get();
+    validate_operation_result(res, ignore_subdoc_errors);
+    return res;
+}
+
+void
+validate_operation_result(result& res, bool ignore_subdoc_errors)
+{
     if (!res.is_success()) {
         throw client_error(res);
     }
@@ -83,7 +90,6 @@ wrap_operation_future(std::future<result>& fut, bool ignore_subdoc_errors)
             }
         }
     }
-    return res;
 }
 
 template<>
@@ -19,7 +19,9 @@
 #include "internal/logging.hxx"
 
 #include <condition_variable>
+#include <functional>
 #include <mutex>
+#include <vector>
 
 namespace couchbase::core::transactions
 {
@@ -74,6 +76,18 @@ class waitable_op_list
         // we have the lock.  Block all further ops
         allow_ops_ = false;
     }
+    // same as above, but calls the handler once the ops are done instead of blocking the calling thread
+    void wait_and_block_ops(std::function<void()>&& handler)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (0 != count_) {
+            waiters_.emplace_back(std::move(handler));
+            return;
+        }
+        allow_ops_ = false;
+        lock.unlock();
+        handler();
+    }
     attempt_mode get_mode()
     {
         std::unique_lock<std::mutex> lock(mutex_);
@@ -156,7 +170,7 @@ class waitable_op_list
   private:
     void change_count(int32_t val)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_lock<std::mutex> lock(mutex_);
         if (allow_ops_) {
             count_ += val;
             if (val > 0) {
@@ -165,12 +179,21 @@ class waitable_op_list
             CB_TXN_LOG_TRACE("op count changed by {} to {}, {} in_flight", val, count_, in_flight_);
             assert(count_ >= 0);
             assert(in_flight_ >= 0);
-            if (0 == count_) {
-                cv_ops_.notify_all();
-            }
             if (0 == in_flight_) {
                 cv_in_flight_.notify_all();
             }
+            if (0 == count_) {
+                cv_ops_.notify_all();
+                if (!waiters_.empty()) {
+                    allow_ops_ = false;
+                    auto waiters = std::move(waiters_);
+                    waiters_.clear();
+                    lock.unlock();
+                    for (auto& waiter : waiters) {
+                        waiter();
+                    }
+                }
+            }
         } else {
             CB_TXN_LOG_ERROR("operation attempted after commit/rollback");
             throw async_operation_conflict("Operation attempted after commit or rollback");
@@ -185,6 +208,7 @@ class waitable_op_list
     std::condition_variable cv_ops_;
     std::condition_variable cv_query_;
     std::condition_variable cv_in_flight_;
+    std::vector<std::function<void()>> waiters_;
     std::mutex mutex_;
 };
 } // namespace couchbase::core::transactions
@@ -213,6 +213,19 @@ parse_option(tls_verify_mode& receiver, const std::string& name, const std::stri
     }
 }
 
+void
+parse_option(http_node_selection_policy& receiver, const std::string& name, const std::string& value, std::vector<std::string>& warnings)
+{
+    if (value == "round_robin") {
+        receiver = http_node_selection_policy::round_robin;
+    } else if (value == "power_of_two_choices") {
+        receiver = http_node_selection_policy::power_of_two_choices;
+    } else {
+        warnings.push_back(fmt::format(
+          R"(unable to parse "{}" parameter in connection string (value "{}" is not a valid HTTP node selection policy))", name, value));
+    }
+}
+
 void
 parse_option(io::ip_protocol& receiver, const std::string& name, const std::string& value, std::vector<std::string>& warnings)
 {
@@ -353,6 +366,23 @@ extract_options(connection_string& connstr)
              * connections are permitted.
              */
             parse_option(connstr.options.max_http_connections, name, value, connstr.warnings);
+        } else if (name == "min_idle_http_connections") {
+            /**
+             * The number of idle HTTP connections kept open for each of query, search and analytics services. They are established
+             * as soon as the configuration is known, and pinged before idle_http_connection_timeout expires. 0 disables warm-up.
+             */
+            parse_option(connstr.options.min_idle_http_connections, name, value, connstr.warnings);
+        } else if (name == "http_node_selection") {
+            /**
+             * How to pick the node for HTTP requests: "round_robin" (default) or "power_of_two_choices"
+             */
+            parse_option(connstr.options.http_node_selection, name, value, connstr.warnings);
+        } else if (name == "enable_http_pipelining") {
+            /**
+             * Send idempotent GET requests of management, search and analytics services over shared HTTP connections, without
+             * waiting for the responses of the preceding requests (default false)
+             */
+            parse_option(connstr.options.enable_http_pipelining, name, value, connstr.warnings);
         } else if (name == "idle_http_connection_timeout") {
             /**
              * The period of time an HTTP connection can be idle before it is forcefully disconnected.
@@ -377,6 +407,11 @@ extract_options(connection_string& connstr)
                   name,
                   value));
             }
+        } else if (name == "enable_parallel_bootstrap") {
+            /**
+             * Connect to all bootstrap nodes at once and use the first one to deliver the configuration (default false)
+             */
+            parse_option(connstr.options.enable_parallel_bootstrap, name, value, connstr.warnings);
         } else if (name == "network") {
             connstr.options.network = value; /* current known values are "auto", "default" and "external" */
         } else if (name == "show_queries") {
@@ -19,6 +19,7 @@
 
 #include <tao/json.hpp>
 #include <tao/json/contrib/traits.hpp>
+#include <tao/json/events/virtual_ref.hpp>
 
 #include <gsl/span>
 
@@ -291,4 +292,14 @@ generate_binary(const tao::json::value& object)
     tao::json::events::from_value(consumer, object);
     return out;
 }
+
+std::vector<std::byte>
+generate_binary(const std::function<void(tao::json::events::virtual_base&)>& producer)
+{
+    std::vector<std::byte> out;
+    to_byte_vector consumer(out);
+    tao::json::events::virtual_ref<to_byte_vector> events(consumer);
+    producer(events);
+    return out;
+}
 } // namespace couchbase::core::utils::json
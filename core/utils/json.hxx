@@ -19,8 +19,11 @@
 
 #include "core/json_string.hxx"
 
+#include <tao/json/events/virtual_base.hpp>
 #include <tao/json/value.hpp>
 
+#include <functional>
+
 namespace couchbase::core::utils::json
 {
 tao::json::value
@@ -40,4 +43,10 @@ parse_binary(const std::vector<std::byte>& input);
 
 std::vector<std::byte>
 generate_binary(const tao::json::value& object);
+
+/**
+ * Writes the events emitted by @p producer, e.g. from tao::json::events::produce(), without building a tao::json::value.
+ */
+std::vector<std::byte>
+generate_binary(const std::function<void(tao::json::events::virtual_base&)>& producer);
 } // namespace couchbase::core::utils::json
@@ -22,10 +22,109 @@
 
 #include <stdexcept>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COUCHBASE_CXX_CLIENT_JSON_SCAN_SSE2
+#elif defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define COUCHBASE_CXX_CLIENT_JSON_SCAN_NEON
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace couchbase::core::utils::json
 {
+static std::error_code
+convert_status(jsonsl_error_t error);
+
 namespace detail
 {
+#if defined(__AVX2__) || defined(COUCHBASE_CXX_CLIENT_JSON_SCAN_SSE2) || defined(COUCHBASE_CXX_CLIENT_JSON_SCAN_NEON)
+static std::size_t
+count_trailing_zeros(std::uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index{};
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask)) != 0) {
+        return index;
+    }
+    _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+    return index + 32;
+#else
+    return static_cast<std::size_t>(__builtin_ctzll(mask));
+#endif
+}
+#endif
+
+/**
+ * Returns position of the first byte in @p data starting from @p offset, which is equal to one of the @p Characters, or
+ * size of the data if there is none.
+ *
+ * Compares 32 (AVX2) or 16 (SSE2, NEON) bytes at once, and falls back to the byte-by-byte loop for the tail, and on other
+ * platforms.
+ */
+template<char... Characters>
+static std::size_t
+find_first_of(std::string_view data, std::size_t offset)
+{
+    const char* begin = data.data();
+    const char* p = begin + offset;
+    const char* end = begin + data.size();
+
+#if defined(__AVX2__)
+    for (; end - p >= 32; p += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i matches = _mm256_setzero_si256();
+        ((matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(Characters)))), ...);
+        if (auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(matches)); mask != 0) {
+            return static_cast<std::size_t>(p - begin) + count_trailing_zeros(mask);
+        }
+    }
+#elif defined(COUCHBASE_CXX_CLIENT_JSON_SCAN_SSE2)
+    for (; end - p >= 16; p += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i matches = _mm_setzero_si128();
+        ((matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, _mm_set1_epi8(Characters)))), ...);
+        if (auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(matches)); mask != 0) {
+            return static_cast<std::size_t>(p - begin) + count_trailing_zeros(mask);
+        }
+    }
+#elif defined(COUCHBASE_CXX_CLIENT_JSON_SCAN_NEON)
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t block = vld1q_u8(reinterpret_cast<const std::uint8_t*>(p));
+        uint8x16_t matches = vdupq_n_u8(0);
+        ((matches = vorrq_u8(matches, vceqq_u8(block, vdupq_n_u8(static_cast<std::uint8_t>(Characters))))), ...);
+        /* narrow every byte of the comparison to four bits, as NEON does not have movemask */
+        const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+        if (auto mask = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0); mask != 0) {
+            return static_cast<std::size_t>(p - begin) + count_trailing_zeros(mask) / 4;
+        }
+    }
+#endif
+
+    for (; p != end; ++p) {
+        if (((*p == Characters) || ...)) {
+            return static_cast<std::size_t>(p - begin);
+        }
+    }
+    return data.size();
+}
+
+static bool
+is_whitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static bool
+is_special_end(char c)
+{
+    return is_whitespace(c) || c == ',' || c == ']' || c == '}' || c == ':';
+}
 
 static void
 noop_on_complete(std::error_code /* ec */, std::size_t /* number_of_rows */, std::string&& /* meta */)
@@ -38,6 +137,15 @@ noop_on_row(std::string&& /* row */)
     return stream_control::next_row;
 }
 
+static int
+row_error_callback(jsonsl_t validator, jsonsl_error_t error, struct jsonsl_state_st* /* state */, jsonsl_char_t* /* at */)
+{
+    if (auto* row_error = static_cast<jsonsl_error_t*>(validator->data); *row_error == JSONSL_ERROR_SUCCESS) {
+        *row_error = error;
+    }
+    return 0;
+}
+
 #define STATE_MARKER_ROOT (reinterpret_cast<void*>(1))
 #define STATE_MARKER_ROWSET (reinterpret_cast<void*>(2))
 
@@ -45,7 +153,10 @@ struct streaming_lexer_impl {
     streaming_lexer_impl(jsonsl_t lexer, jsonsl_jpr_t pointer)
       : lexer_(lexer)
       , pointer_(pointer)
+      , row_validator_(jsonsl_new(512))
     {
+        row_validator_->data = &row_error_;
+        row_validator_->error_callback = row_error_callback;
     }
 
     streaming_lexer_impl(streaming_lexer_impl& other) = delete;
@@ -58,6 +169,7 @@ struct streaming_lexer_impl {
         jsonsl_jpr_destroy(pointer_);
         jsonsl_jpr_match_state_cleanup(lexer_);
         jsonsl_destroy(lexer_);
+        jsonsl_destroy(row_validator_);
     }
 
     void validate_root(struct jsonsl_state_st* state, jsonsl_jpr_match_t match)
@@ -99,6 +211,227 @@ struct streaming_lexer_impl {
         return { ret, len };
     }
 
+    void fail(std::error_code ec)
+    {
+        error_ = ec;
+        on_complete_(error_, number_of_rows_, {});
+        on_complete_ = noop_on_complete;
+    }
+
+    void begin_row(std::string_view data, std::size_t data_pos, std::size_t index)
+    {
+        row_open_ = true;
+        row_begin_ = data_pos + index;
+        if (!meta_header_complete_) {
+            /* everything until the first row, the buffer still holds the response from the beginning */
+            meta_buffer_.append(buffer_);
+            meta_buffer_.append(data.substr(0, index));
+            meta_header_length_ = row_begin_;
+            meta_header_complete_ = true;
+        }
+    }
+
+    /**
+     * @return false if the row is not valid JSON
+     */
+    bool end_row(std::string_view data, std::size_t data_pos, std::size_t index)
+    {
+        row_open_ = false;
+        in_special_ = false;
+        expecting_row_ = false;
+        after_comma_ = false;
+        number_of_rows_++;
+        if (!emit_next_row_) {
+            return true;
+        }
+
+        std::string row{};
+        if (row_begin_ < data_pos) {
+            /* the row has started in one of the previous chunks */
+            row.reserve(data_pos - row_begin_ + index);
+            row.append(buffer_, row_begin_ - min_pos_, data_pos - row_begin_);
+            row.append(data.substr(0, index));
+        } else {
+            row.assign(data.substr(row_begin_ - data_pos, index - (row_begin_ - data_pos)));
+        }
+        if (auto ec = validate_row(row); ec) {
+            fail(ec);
+            return false;
+        }
+        auto rc = on_row_(std::move(row));
+        emit_next_row_ = rc == stream_control::next_row;
+        if (!emit_next_row_) {
+            on_row_ = noop_on_row;
+        }
+        return true;
+    }
+
+    /**
+     * Runs jsonsl over the row located by scan_rows(), which only checks the strings and the brackets. The row is wrapped
+     * into the array, because jsonsl does not accept strings, numbers, booleans and nulls at the top level.
+     */
+    std::error_code validate_row(std::string_view row)
+    {
+        jsonsl_reset(row_validator_);
+        row_error_ = JSONSL_ERROR_SUCCESS;
+        jsonsl_feed(row_validator_, "[", 1);
+        jsonsl_feed(row_validator_, row.data(), row.size());
+        jsonsl_feed(row_validator_, "]", 1);
+        if (row_error_ != JSONSL_ERROR_SUCCESS) {
+            return convert_status(row_error_);
+        }
+        if (row_validator_->level != 0) {
+            return errc::streaming_json_lexer::missing_token;
+        }
+        return {};
+    }
+
+    /**
+     * Locates the rows in @p data without running the jsonsl state machine over them. Only the strings and the nesting
+     * of the rows are tracked, and the structural characters are found with find_first_of().
+     *
+     * @param data_pos absolute position of the first byte of the data
+     * @return position of the closing bracket of the rowset in the data, or std::string_view::npos
+     */
+    std::size_t scan_rows(std::string_view data, std::size_t data_pos)
+    {
+        std::size_t i = 0;
+        while (i < data.size()) {
+            if (in_escape_) {
+                in_escape_ = false;
+                ++i;
+                continue;
+            }
+
+            if (in_string_) {
+                i = find_first_of<'"', '\\'>(data, i);
+                if (i == data.size()) {
+                    break;
+                }
+                if (data[i++] == '\\') {
+                    in_escape_ = true;
+                    continue;
+                }
+                in_string_ = false;
+                if (brackets_.empty() && !end_row(data, data_pos, i)) {
+                    return std::string_view::npos;
+                }
+                continue;
+            }
+
+            if (!brackets_.empty()) {
+                i = find_first_of<'"', '{', '}', '[', ']'>(data, i);
+                if (i == data.size()) {
+                    break;
+                }
+                const char c = data[i++];
+                if (c == '"') {
+                    in_string_ = true;
+                } else if (c == '{' || c == '[') {
+                    brackets_.push_back(c);
+                } else if (brackets_.back() != (c == '}' ? '{' : '[')) {
+                    fail(errc::streaming_json_lexer::bracket_mismatch);
+                    return std::string_view::npos;
+                } else {
+                    brackets_.pop_back();
+                    if (brackets_.empty() && !end_row(data, data_pos, i)) {
+                        return std::string_view::npos;
+                    }
+                }
+                continue;
+            }
+
+            if (in_special_) {
+                /* numbers, booleans and nulls end with the first delimiter */
+                while (i < data.size() && !is_special_end(data[i])) {
+                    ++i;
+                }
+                if (i == data.size()) {
+                    break;
+                }
+                if (!end_row(data, data_pos, i)) {
+                    return std::string_view::npos;
+                }
+            }
+
+            const char c = data[i];
+
+            if (is_whitespace(c)) {
+                ++i;
+            } else if (c == ']') {
+                if (after_comma_) {
+                    fail(errc::streaming_json_lexer::trailing_comma);
+                    return std::string_view::npos;
+                }
+                return i;
+            } else if (c == ':') {
+                fail(errc::streaming_json_lexer::stray_token);
+                return std::string_view::npos;
+            } else if (c == '}') {
+                fail(after_comma_ ? errc::streaming_json_lexer::trailing_comma : errc::streaming_json_lexer::bracket_mismatch);
+                return std::string_view::npos;
+            } else if (!expecting_row_) {
+                if (c != ',') {
+                    fail(errc::streaming_json_lexer::cannot_insert);
+                    return std::string_view::npos;
+                }
+                expecting_row_ = true;
+                after_comma_ = true;
+                ++i;
+            } else if (c == ',') {
+                fail(errc::streaming_json_lexer::stray_token);
+                return std::string_view::npos;
+            } else {
+                begin_row(data, data_pos, i);
+                if (c == '{' || c == '[') {
+                    brackets_.push_back(c);
+                } else if (c == '"') {
+                    in_string_ = true;
+                } else {
+                    in_special_ = true;
+                }
+                ++i;
+            }
+        }
+        return std::string_view::npos;
+    }
+
+    void feed_rows(std::string_view data)
+    {
+        const std::size_t data_pos = min_pos_ + buffer_.size();
+        const std::size_t rowset_end = scan_rows(data, data_pos);
+        if (error_) {
+            return;
+        }
+        const std::size_t consumed = rowset_end == std::string_view::npos ? data.size() : rowset_end;
+
+        /* keep the beginning of the unfinished row, or everything until the first row is seen */
+        std::size_t keep_from = data_pos + consumed;
+        if (row_open_) {
+            keep_from = row_begin_;
+        } else if (!meta_header_complete_) {
+            keep_from = min_pos_;
+        }
+        if (keep_from < data_pos) {
+            buffer_.erase(0, keep_from - min_pos_);
+            buffer_.append(data.substr(0, consumed));
+        } else {
+            buffer_.assign(data.substr(keep_from - data_pos, data_pos + consumed - keep_from));
+        }
+        min_pos_ = keep_from;
+        keep_position_ = keep_from;
+
+        if (rowset_end == std::string_view::npos) {
+            return;
+        }
+
+        /* the metadata trailer is handled by jsonsl again, starting from the closing bracket of the rowset */
+        scanning_rows_ = false;
+        buffer_.append(data.substr(consumed));
+        lexer_->pos = data_pos + consumed;
+        jsonsl_feed(lexer_, data.data() + consumed, data.size() - consumed);
+    }
+
     jsonsl_t lexer_{};
     jsonsl_jpr_t pointer_{};
     std::string meta_buffer_{};
@@ -111,6 +444,8 @@ struct streaming_lexer_impl {
 
     bool meta_complete_{ false };
 
+    bool meta_header_complete_{ false };
+
     /**
      * size of the metadata header chunk (i.e. everything until the opening
      * bracket of "rows" [
@@ -135,6 +470,26 @@ struct streaming_lexer_impl {
     std::function<void(std::error_code, std::size_t, std::string&&)> on_complete_{ noop_on_complete };
     std::function<stream_control(std::string&&)> on_row_{ noop_on_row };
     bool root_has_been_validated_{ false };
+
+    /**
+     * the rows are being located by scan_rows(), jsonsl has been stopped at the opening bracket of the rowset
+     */
+    bool scanning_rows_{ false };
+    bool row_open_{ false };
+    /** absolute position of the first byte of the current row */
+    std::size_t row_begin_{};
+    /** the brackets of the current row, which are not closed yet */
+    std::string brackets_{};
+    bool in_string_{ false };
+    bool in_escape_{ false };
+    /** the current row is a number, boolean or null */
+    bool in_special_{ false };
+    bool expecting_row_{ true };
+    bool after_comma_{ false };
+
+    /** validates the emitted rows, see validate_row() */
+    jsonsl_t row_validator_{};
+    jsonsl_error_t row_error_{ JSONSL_ERROR_SUCCESS };
 };
 } // namespace detail
 
@@ -241,16 +596,6 @@ error_callback(jsonsl_t lexer, jsonsl_error_t error, struct jsonsl_state_st* /*
     return 0;
 }
 
-static void
-meta_header_complete_callback(jsonsl_t lexer, jsonsl_action_t /* action */, struct jsonsl_state_st* state, const jsonsl_char_t* /* at */)
-{
-    auto* impl = static_cast<detail::streaming_lexer_impl*>(lexer->data);
-
-    impl->meta_buffer_.append(impl->buffer_.c_str(), state->pos_begin);
-    impl->meta_header_length_ = state->pos_begin;
-    lexer->action_callback_PUSH = nullptr;
-}
-
 static void
 trailer_pop_callback(jsonsl_t lexer, jsonsl_action_t /* action */, struct jsonsl_state_st* state, const jsonsl_char_t* /* at */)
 {
@@ -271,41 +616,22 @@ trailer_pop_callback(jsonsl_t lexer, jsonsl_action_t /* action */, struct jsonsl
 }
 
 static void
-row_pop_callback(jsonsl_t lexer, jsonsl_action_t /* action */, struct jsonsl_state_st* state, const jsonsl_char_t* /* at */)
+rowset_pop_callback(jsonsl_t lexer, jsonsl_action_t /* action */, struct jsonsl_state_st* state, const jsonsl_char_t* /* at */)
 {
     auto* impl = static_cast<detail::streaming_lexer_impl*>(lexer->data);
 
-    if (impl->error_) {
+    if (impl->error_ || state->data != STATE_MARKER_ROWSET) {
         return;
     }
 
     impl->keep_position_ = lexer->pos;
     impl->last_row_end_position_ = lexer->pos;
-
-    if (state->data == STATE_MARKER_ROWSET) {
-        lexer->action_callback_POP = trailer_pop_callback;
-        lexer->action_callback_PUSH = nullptr;
-        if (impl->number_of_rows_ == 0) {
-            /* While the entire meta is available to us, the _closing_ part
-             * of the meta is handled in a different callback. */
-            impl->meta_buffer_.append(impl->buffer_.c_str(), lexer->pos);
-            impl->meta_header_length_ = lexer->pos;
-        }
-        return;
-    }
-
-    impl->number_of_rows_++;
-    if (impl->meta_complete_) {
-        return;
-    }
-
-    if (impl->emit_next_row_) {
-        auto row = impl->get_buffer_region(state->pos_begin, lexer->pos - state->pos_begin + (state->type == JSONSL_T_SPECIAL ? 0 : 1));
-        auto rc = impl->on_row_(std::string(row));
-        impl->emit_next_row_ = rc == stream_control::next_row;
-        if (!impl->emit_next_row_) {
-            impl->on_row_ = detail::noop_on_row;
-        }
+    lexer->action_callback_POP = trailer_pop_callback;
+    if (impl->number_of_rows_ == 0) {
+        /* While the entire meta is available to us, the _closing_ part
+         * of the meta is handled in a different callback. */
+        impl->meta_buffer_.append(impl->buffer_.c_str(), lexer->pos);
+        impl->meta_header_length_ = lexer->pos;
     }
 }
 
@@ -343,10 +669,12 @@ initial_action_push_callback(jsonsl_t lexer, jsonsl_action_t /* action */, struc
     }
     impl->validate_root(state, match);
     if (state->type == JSONSL_T_LIST && match == JSONSL_MATCH_POSSIBLE) {
-        /* we have a match, e.g. "rows:[]" */
-        lexer->action_callback_POP = row_pop_callback;
-        lexer->action_callback_PUSH = meta_header_complete_callback;
+        /* we have a match, e.g. "rows:[]", the rows are located by streaming_lexer_impl::scan_rows() */
+        lexer->action_callback_POP = rowset_pop_callback;
+        lexer->action_callback_PUSH = nullptr;
         state->data = STATE_MARKER_ROWSET;
+        impl->scanning_rows_ = true;
+        jsonsl_stop(lexer);
     }
 }
 
@@ -374,8 +702,22 @@ json::streaming_lexer::streaming_lexer(const std::string& pointer_expression, st
 void
 streaming_lexer::feed(std::string_view data)
 {
-    impl_->buffer_.append(data);
-    jsonsl_feed(impl_->lexer_, data.data(), data.size());
+    if (!impl_->scanning_rows_) {
+        const std::size_t data_pos = impl_->min_pos_ + impl_->buffer_.size();
+        impl_->buffer_.append(data);
+        jsonsl_feed(impl_->lexer_, data.data(), data.size());
+        if (impl_->scanning_rows_ && !impl_->error_) {
+            /* jsonsl has been stopped before advancing past the opening bracket of the rowset */
+            const std::size_t consumed = impl_->lexer_->pos + 1 - data_pos;
+            impl_->buffer_.resize(impl_->buffer_.size() - (data.size() - consumed));
+            impl_->lexer_->stopfl = 0;
+            impl_->lexer_->tok_last = 0;
+            impl_->lexer_->pos++;
+            impl_->feed_rows(data.substr(consumed));
+        }
+    } else if (!impl_->error_) {
+        impl_->feed_rows(data);
+    }
 
     /* Do we need to cut off some bytes? */
     if (impl_->keep_position_ > impl_->min_pos_) {
@@ -0,0 +1,135 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+/**
+ * Defined when the compiler and the standard library support C++20 coroutines, and the awaitable overloads of the
+ * asynchronous operations are available.
+ */
+#define COUCHBASE_CXX_CLIENT_HAS_COROUTINES 1
+#endif
+#endif
+
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace couchbase
+{
+/**
+ * Type of the @ref use_awaitable completion token.
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+struct use_awaitable_t {
+    constexpr explicit use_awaitable_t() = default;
+};
+
+/**
+ * Completion token, which makes an asynchronous operation return an awaitable instead of invoking a handler.
+ *
+ * @snippet{trimleft} test/test_unit_awaitable.cxx awaitable-kv
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+inline constexpr use_awaitable_t use_awaitable{};
+
+/**
+ * Awaitable, which starts the operation when the awaiting coroutine suspends, and resumes the coroutine with the pair of the error
+ * context and the result of the operation.
+ *
+ * The coroutine is resumed on the thread, which completed the operation, i.e. on one of the threads running the `asio::io_context` of
+ * the cluster, so it should not block there. If the operation completes before the initiation returns, the coroutine continues without
+ * suspending. The result is stored in the awaitable itself, which lives in the frame of the coroutine, so awaiting does not allocate
+ * apart from what the operation itself needs.
+ *
+ * The object that returned the awaitable (e.g. the @ref collection) must stay alive until the awaitable is awaited.
+ *
+ * @tparam ErrorContext type of the error context of the operation
+ * @tparam Result type of the result of the operation
+ * @tparam Initiate callable, which starts the operation with the given completion handler
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+template<typename ErrorContext, typename Result, typename Initiate>
+class awaitable_operation
+{
+  public:
+    explicit awaitable_operation(Initiate initiate)
+      : initiate_{ std::move(initiate) }
+    {
+    }
+
+    awaitable_operation(const awaitable_operation&) = delete;
+    awaitable_operation(awaitable_operation&&) = delete;
+    awaitable_operation& operator=(const awaitable_operation&) = delete;
+    awaitable_operation& operator=(awaitable_operation&&) = delete;
+    ~awaitable_operation() = default;
+
+    [[nodiscard]] auto await_ready() const noexcept -> bool
+    {
+        return false;
+    }
+
+    auto await_suspend(std::coroutine_handle<> continuation) -> bool
+    {
+        continuation_ = continuation;
+        // the handler captures only the pointer, so it fits into the small buffer of std::function
+        std::move(initiate_)([this](ErrorContext ctx, Result result) {
+            result_.emplace(std::move(ctx), std::move(result));
+            if (completed_.exchange(true, std::memory_order_acq_rel)) {
+                continuation_.resume();
+            }
+        });
+        // whoever comes second, the handler or the initiation, continues the coroutine
+        return !completed_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    auto await_resume() -> std::pair<ErrorContext, Result>
+    {
+        return std::move(result_).value();
+    }
+
+  private:
+    Initiate initiate_;
+    std::coroutine_handle<> continuation_{};
+    std::optional<std::pair<ErrorContext, Result>> result_{};
+    std::atomic_bool completed_{ false };
+};
+
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+namespace core::impl
+{
+template<typename ErrorContext, typename Result, typename Initiate>
+auto
+make_awaitable_operation(Initiate&& initiate) -> awaitable_operation<ErrorContext, Result, std::decay_t<Initiate>>
+{
+    return awaitable_operation<ErrorContext, Result, std::decay_t<Initiate>>{ std::forward<Initiate>(initiate) };
+}
+} // namespace core::impl
+#endif
+} // namespace couchbase
+#endif
@@ -0,0 +1,107 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace couchbase
+{
+/**
+ * Type of the @ref use_blocking completion token.
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+struct use_blocking_t {
+    constexpr explicit use_blocking_t() = default;
+};
+
+/**
+ * Completion token, which makes an operation block the calling thread until it completes, and return the pair of the error context and
+ * the result directly.
+ *
+ * Unlike the overloads returning `std::future`, the blocking overloads keep the result on the stack of the caller, and do not allocate
+ * the shared state of the promise.
+ *
+ * @snippet{trimleft} test/test_unit_blocking.cxx blocking-kv
+ *
+ * @since 1.0.0
+ * @volatile
+ */
+inline constexpr use_blocking_t use_blocking{};
+
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+namespace core::impl
+{
+/**
+ * Event, which is signalled once by one thread and waited for by another one.
+ *
+ * Waiting parks the thread on the address of the event (futex on Linux), so the event needs neither a mutex nor a condition variable of
+ * its own. The event might be destroyed as soon as wait() returns, even if notify() has not returned yet.
+ */
+class one_shot_event
+{
+  public:
+    one_shot_event() = default;
+    one_shot_event(const one_shot_event&) = delete;
+    one_shot_event(one_shot_event&&) = delete;
+    one_shot_event& operator=(const one_shot_event&) = delete;
+    one_shot_event& operator=(one_shot_event&&) = delete;
+    ~one_shot_event() = default;
+
+    void notify();
+    void wait();
+
+  private:
+    std::atomic<std::uint32_t> state_{ 0 };
+};
+
+/**
+ * Collects the result of the operation, and blocks the caller until it is available.
+ */
+template<typename ErrorContext, typename Result>
+class blocking_waiter
+{
+  public:
+    /**
+     * @return handler, which captures only the pointer to the waiter, so it fits into the small buffer of std::function
+     */
+    [[nodiscard]] auto handler()
+    {
+        return [this](ErrorContext ctx, Result result) {
+            result_.emplace(std::move(ctx), std::move(result));
+            event_.notify();
+        };
+    }
+
+    [[nodiscard]] auto wait() -> std::pair<ErrorContext, Result>
+    {
+        event_.wait();
+        return std::move(result_).value();
+    }
+
+  private:
+    std::optional<std::pair<ErrorContext, Result>> result_{};
+    one_shot_event event_{};
+};
+} // namespace core::impl
+#endif
+} // namespace couchbase
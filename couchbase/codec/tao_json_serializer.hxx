@@ -21,8 +21,15 @@
 #include <couchbase/codec/serializer_traits.hxx>
 #include <couchbase/error_codes.hxx>
 
+#include <tao/json/events/produce.hpp>
+#include <tao/json/events/virtual_base.hpp>
 #include <tao/json/value.hpp>
 
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
 namespace couchbase
 {
 #ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
@@ -31,6 +38,9 @@ namespace core::utils::json
 std::vector<std::byte>
 generate_binary(const tao::json::value& object);
 
+std::vector<std::byte>
+generate_binary(const std::function<void(tao::json::events::virtual_base&)>& producer);
+
 tao::json::value
 parse_binary(const std::vector<std::byte>& input);
 } // namespace core::utils::json
@@ -38,16 +48,97 @@ parse_binary(const std::vector<std::byte>& input);
 
 namespace codec
 {
+#ifndef COUCHBASE_CXX_CLIENT_DOXYGEN
+namespace internal
+{
+/*
+ * The generic traits of tao::json for containers, optionals and smart pointers declare `produce` for any element type,
+ * so the elements are checked too. Otherwise a container of a type with `assign`-only traits would be
+ * detected as streamable, and fail to compile.
+ */
+template<typename T, typename = void>
+struct tao_json_value_type {
+    using type = void;
+};
+
+template<typename T>
+struct tao_json_value_type<T, std::void_t<typename T::value_type>> {
+    using type = typename T::value_type;
+};
+
+template<typename T, typename = void>
+struct tao_json_mapped_type : tao_json_value_type<T> {
+};
+
+template<typename T>
+struct tao_json_mapped_type<T, std::void_t<typename T::mapped_type>> {
+    using type = typename T::mapped_type;
+};
+
+template<typename T, typename = void>
+struct tao_json_element : tao_json_mapped_type<T> {
+};
+
+template<typename T>
+struct tao_json_element<T, std::void_t<typename T::element_type>> {
+    using type = typename T::element_type;
+};
+
+// strings and binary data are leaves
+template<typename T>
+using tao_json_element_t = std::conditional_t<std::is_convertible_v<const T&, std::string_view> ||
+                                                std::is_same_v<std::remove_cv_t<typename tao_json_element<T>::type>, std::byte>,
+                                              void,
+                                              typename tao_json_element<T>::type>;
+
+template<typename T, typename = void>
+struct declares_tao_json_produce : std::false_type {
+};
+
+template<typename T>
+struct declares_tao_json_produce<T,
+                                 std::void_t<decltype(tao::json::traits<T>::template produce<tao::json::traits>(
+                                   std::declval<tao::json::events::virtual_base&>(), std::declval<const T&>()))>> : std::true_type {
+};
+
+template<typename T>
+constexpr bool
+has_tao_json_produce()
+{
+    if constexpr (!declares_tao_json_produce<T>::value) {
+        return false;
+    } else if constexpr (std::is_void_v<tao_json_element_t<T>>) {
+        return true;
+    } else {
+        return has_tao_json_produce<std::remove_const_t<tao_json_element_t<T>>>();
+    }
+}
+} // namespace internal
+#endif
+
+/**
+ * Uses the tao::json traits of the document type.
+ *
+ * When the traits implement `produce`, the document is written as a stream of events without building a tao::json::value
+ * first. Documents are always read through tao::json::value, so duplicate keys resolve to the last one, and numbers convert
+ * as in tao::json::value.
+ */
 class tao_json_serializer
 {
   public:
     using document_type = tao::json::value;
 
     template<typename Document>
-    static auto serialize([[maybe_unused]] Document document) -> binary
+    static auto serialize([[maybe_unused]] const Document& document) -> binary
     {
-        if constexpr (std::is_null_pointer_v<Document>) {
+        using value_type = std::decay_t<Document>;
+        if constexpr (std::is_null_pointer_v<value_type>) {
             return core::utils::json::generate_binary(tao::json::null);
+        } else if constexpr (std::is_same_v<value_type, tao::json::value>) {
+            return core::utils::json::generate_binary(document);
+        } else if constexpr (internal::has_tao_json_produce<value_type>()) {
+            return core::utils::json::generate_binary(
+              [&document](tao::json::events::virtual_base& consumer) { tao::json::events::produce(consumer, document); });
         } else {
             return core::utils::json::generate_binary(tao::json::value(document));
         }
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <couchbase/awaitable.hxx>
 #include <couchbase/binary_collection.hxx>
+#include <couchbase/blocking.hxx>
 #include <couchbase/codec/default_json_transcoder.hxx>
 #include <couchbase/collection_query_index_manager.hxx>
 #include <couchbase/exists_options.hxx>
@@ -174,6 +176,55 @@ class collection
         return future;
     }
 
+    /**
+     * Fetches the full document from this collection.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param options options to customize the get request.
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto get(std::string document_id, const get_options& options, use_blocking_t /* token */) const
+      -> std::pair<key_value_error_context, get_result>
+    {
+        core::impl::blocking_waiter<key_value_error_context, get_result> waiter;
+        get(std::move(document_id), options, waiter.handler());
+        return waiter.wait();
+    }
+
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+    /**
+     * Fetches the full document from this collection.
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param options options to customize the get request.
+     * @return awaitable, which resumes the coroutine with the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto get(std::string document_id, const get_options& options, use_awaitable_t /* token */) const
+    {
+        return core::impl::make_awaitable_operation<key_value_error_context, get_result>(
+          [this, document_id = std::move(document_id), options = options.build()](get_handler&& handler) mutable {
+              core::impl::initiate_get_operation(
+                core_, bucket_name_, scope_name_, name_, std::move(document_id), std::move(options), std::move(handler));
+          });
+    }
+#endif
+
     /**
      * Fetches a full document and resets its expiration time to the value provided.
      *
@@ -578,6 +629,76 @@ class collection
         return future;
     }
 
+    /**
+     * Upserts a full document which might or might not exist yet with custom options.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @tparam Transcoder type of the transcoder that will be used to encode the document
+     * @tparam Document type of the document
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param document the document content to upsert.
+     * @param options custom options to customize the upsert behavior.
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    template<typename Transcoder = codec::default_json_transcoder, typename Document>
+    [[nodiscard]] auto upsert(std::string document_id,
+                              const Document& document,
+                              const upsert_options& options,
+                              use_blocking_t /* token */) const
+      -> std::pair<key_value_error_context, mutation_result>
+    {
+        core::impl::blocking_waiter<key_value_error_context, mutation_result> waiter;
+        upsert<Transcoder>(std::move(document_id), document, options, waiter.handler());
+        return waiter.wait();
+    }
+
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+    /**
+     * Upserts a full document which might or might not exist yet with custom options.
+     *
+     * The document is encoded before the function returns, so it does not have to outlive the awaitable.
+     *
+     * @tparam Transcoder type of the transcoder that will be used to encode the document
+     * @tparam Document type of the document
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param document the document content to upsert.
+     * @param options custom options to customize the upsert behavior.
+     * @return awaitable, which resumes the coroutine with the error context and the result of the operation
+     *
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    template<typename Transcoder = codec::default_json_transcoder, typename Document>
+    [[nodiscard]] auto upsert(std::string document_id, const Document& document, const upsert_options& options, use_awaitable_t /* token */)
+      const
+    {
+        return core::impl::make_awaitable_operation<key_value_error_context, mutation_result>(
+          [this, document_id = std::move(document_id), encoded = Transcoder::encode(document), options = options.build()](
+            upsert_handler&& handler) mutable {
+              core::impl::initiate_upsert_operation(core_,
+                                                    bucket_name_,
+                                                    scope_name_,
+                                                    name_,
+                                                    std::move(document_id),
+                                                    std::move(encoded),
+                                                    std::move(options),
+                                                    std::move(handler));
+          });
+    }
+#endif
+
     /**
      * Inserts a full document which does not exist yet with custom options.
      *
@@ -640,6 +761,38 @@ class collection
         return future;
     }
 
+    /**
+     * Inserts a full document which does not exist yet with custom options.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @tparam Transcoder type of the transcoder that will be used to encode the document
+     * @tparam Document type of the document
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param document the document content to insert.
+     * @param options custom options to customize the insert behavior.
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_exists the given document id is already present in the collection.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    template<typename Transcoder = codec::default_json_transcoder, typename Document>
+    [[nodiscard]] auto insert(std::string document_id,
+                              const Document& document,
+                              const insert_options& options,
+                              use_blocking_t /* token */) const
+      -> std::pair<key_value_error_context, mutation_result>
+    {
+        core::impl::blocking_waiter<key_value_error_context, mutation_result> waiter;
+        insert<Transcoder>(std::move(document_id), document, options, waiter.handler());
+        return waiter.wait();
+    }
+
     /**
      * Replaces a full document which already exists.
      *
@@ -704,6 +857,39 @@ class collection
         return future;
     }
 
+    /**
+     * Replaces a full document which already exists.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @tparam Transcoder type of the transcoder that will be used to encode the document
+     * @tparam Document type of the document
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param document the document content to replace.
+     * @param options custom options to customize the replace behavior.
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    template<typename Transcoder = codec::default_json_transcoder, typename Document>
+    [[nodiscard]] auto replace(std::string document_id,
+                               const Document& document,
+                               const replace_options& options,
+                               use_blocking_t /* token */) const
+      -> std::pair<key_value_error_context, mutation_result>
+    {
+        core::impl::blocking_waiter<key_value_error_context, mutation_result> waiter;
+        replace<Transcoder>(std::move(document_id), document, options, waiter.handler());
+        return waiter.wait();
+    }
+
     /**
      * Removes a Document from a collection.
      *
@@ -754,6 +940,31 @@ class collection
         return future;
     }
 
+    /**
+     * Removes a Document from a collection.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param options custom options to customize the remove behavior.
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto remove(std::string document_id, const remove_options& options, use_blocking_t /* token */) const
+      -> std::pair<key_value_error_context, mutation_result>
+    {
+        core::impl::blocking_waiter<key_value_error_context, mutation_result> waiter;
+        remove(std::move(document_id), options, waiter.handler());
+        return waiter.wait();
+    }
+
     /**
      * Performs mutations to document fragments
      *
@@ -808,6 +1019,68 @@ class collection
         return future;
     }
 
+    /**
+     * Performs mutations to document fragments
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param specs the spec which specifies the type of mutations to perform.
+     * @param options custom options to customize the mutate_in behavior.
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::key_value::document_exists the given document id is already present in the collection and insert is was selected.
+     * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto mutate_in(std::string document_id,
+                                 mutate_in_specs specs,
+                                 const mutate_in_options& options,
+                                 use_blocking_t /* token */) const
+      -> std::pair<subdocument_error_context, mutate_in_result>
+    {
+        core::impl::blocking_waiter<subdocument_error_context, mutate_in_result> waiter;
+        mutate_in(std::move(document_id), std::move(specs), options, waiter.handler());
+        return waiter.wait();
+    }
+
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+    /**
+     * Performs mutations to document fragments
+     *
+     * @param document_id the document id which is used to uniquely identify it.
+     * @param specs the spec which specifies the type of mutations to perform.
+     * @param options custom options to customize the mutate_in behavior.
+     * @return awaitable, which resumes the coroutine with the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::key_value::document_exists the given document id is already present in the collection and insert is was selected.
+     * @exception errc::common::cas_mismatch if the document has been concurrently modified on the server.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto mutate_in(std::string document_id,
+                                 mutate_in_specs specs,
+                                 const mutate_in_options& options,
+                                 use_awaitable_t /* token */) const
+    {
+        return core::impl::make_awaitable_operation<subdocument_error_context, mutate_in_result>(
+          [this, document_id = std::move(document_id), specs = std::move(specs), options = options.build()](
+            mutate_in_handler&& handler) mutable {
+              core::impl::initiate_mutate_in_operation(
+                core_, bucket_name_, scope_name_, name_, std::move(document_id), specs.specs(), std::move(options), std::move(handler));
+          });
+    }
+#endif
+
     /**
      * Performs lookups to document fragments with default options.
      *
@@ -858,6 +1131,64 @@ class collection
         return future;
     }
 
+    /**
+     * Performs lookups to document fragments with default options.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @param document_id the outer document ID
+     * @param specs an object that specifies the types of lookups to perform
+     * @param options custom options to modify the lookup options
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto lookup_in(std::string document_id,
+                                 lookup_in_specs specs,
+                                 const lookup_in_options& options,
+                                 use_blocking_t /* token */) const
+      -> std::pair<subdocument_error_context, lookup_in_result>
+    {
+        core::impl::blocking_waiter<subdocument_error_context, lookup_in_result> waiter;
+        lookup_in(std::move(document_id), std::move(specs), options, waiter.handler());
+        return waiter.wait();
+    }
+
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+    /**
+     * Performs lookups to document fragments with default options.
+     *
+     * @param document_id the outer document ID
+     * @param specs an object that specifies the types of lookups to perform
+     * @param options custom options to modify the lookup options
+     * @return awaitable, which resumes the coroutine with the error context and the result of the operation
+     *
+     * @exception errc::key_value::document_not_found the given document id is not found in the collection.
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto lookup_in(std::string document_id,
+                                 lookup_in_specs specs,
+                                 const lookup_in_options& options,
+                                 use_awaitable_t /* token */) const
+    {
+        return core::impl::make_awaitable_operation<subdocument_error_context, lookup_in_result>(
+          [this, document_id = std::move(document_id), specs = std::move(specs), options = options.build()](
+            lookup_in_handler&& handler) mutable {
+              core::impl::initiate_lookup_in_operation(
+                core_, bucket_name_, scope_name_, name_, std::move(document_id), specs.specs(), std::move(options), std::move(handler));
+          });
+    }
+#endif
+
     /**
      * Performs lookups to document fragments with default options from all replicas and the active node and returns the result as a vector.
      *
@@ -1110,6 +1441,29 @@ class collection
         return future;
     }
 
+    /**
+     * Checks if the document exists on the server.
+     *
+     * Blocks the calling thread until the operation completes.
+     *
+     * @param document_id the id of the document
+     * @param options the options to customize
+     * @return the error context and the result of the operation
+     *
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto exists(std::string document_id, const exists_options& options, use_blocking_t /* token */) const
+      -> std::pair<key_value_error_context, exists_result>
+    {
+        core::impl::blocking_waiter<key_value_error_context, exists_result> waiter;
+        exists(std::move(document_id), options, waiter.handler());
+        return waiter.wait();
+    }
+
     [[nodiscard]] auto query_indexes() const -> collection_query_index_manager
     {
         return collection_query_index_manager(core_, bucket_name_, scope_name_, name_);
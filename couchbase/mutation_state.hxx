@@ -20,6 +20,7 @@
 #include <couchbase/mutation_result.hxx>
 #include <couchbase/mutation_token.hxx>
 
+#include <algorithm>
 #include <vector>
 
 namespace couchbase
@@ -42,6 +43,9 @@ class mutation_state
     /**
      * Copies mutation token from the given mutation result.
      *
+     * The state keeps only one token for every partition of the bucket, the one with the highest sequence number, so
+     * its size does not grow beyond number of partitions no matter how many mutations have been added.
+     *
      * @param result mutation result
      *
      * @since 1.0.0
@@ -50,12 +54,51 @@ class mutation_state
     void add(const mutation_result& result)
     {
         if (result.mutation_token().has_value()) {
-            tokens_.push_back(result.mutation_token().value());
+            add(result.mutation_token().value());
         }
     }
 
     /**
-     * List of the mutation tokens
+     * Merges tokens of another state into this one, for example to combine states collected by several threads.
+     *
+     * @param other mutation state
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    void add(const mutation_state& other)
+    {
+        if (other.tokens_.empty()) {
+            return;
+        }
+        if (tokens_.empty()) {
+            tokens_ = other.tokens_;
+            return;
+        }
+
+        /* both lists are sorted, so the merge is linear */
+        std::vector<mutation_token> merged{};
+        merged.reserve(tokens_.size() + other.tokens_.size());
+        auto lhs = tokens_.begin();
+        auto rhs = other.tokens_.begin();
+        while (lhs != tokens_.end() && rhs != other.tokens_.end()) {
+            if (ordered_before(*lhs, *rhs)) {
+                merged.push_back(*lhs++);
+            } else if (ordered_before(*rhs, *lhs)) {
+                merged.push_back(*rhs++);
+            } else {
+                merged.push_back(lhs->sequence_number() < rhs->sequence_number() ? *rhs : *lhs);
+                ++lhs;
+                ++rhs;
+            }
+        }
+        merged.insert(merged.end(), lhs, tokens_.end());
+        merged.insert(merged.end(), rhs, other.tokens_.end());
+        tokens_ = std::move(merged);
+    }
+
+    /**
+     * List of the mutation tokens, at most one for every partition, ordered by bucket name and partition.
      *
      * @return tokens
      *
@@ -68,6 +111,25 @@ class mutation_state
     }
 
   private:
-    std::vector<mutation_token> tokens_{ 0 };
+    static auto ordered_before(const mutation_token& lhs, const mutation_token& rhs) -> bool
+    {
+        if (auto order = lhs.bucket_name().compare(rhs.bucket_name()); order != 0) {
+            return order < 0;
+        }
+        return lhs.partition_id() < rhs.partition_id();
+    }
+
+    void add(const mutation_token& token)
+    {
+        auto position = std::lower_bound(tokens_.begin(), tokens_.end(), token, ordered_before);
+        if (position == tokens_.end() || ordered_before(token, *position)) {
+            tokens_.insert(position, token);
+        } else if (position->sequence_number() < token.sequence_number()) {
+            *position = token;
+        }
+    }
+
+    /* sorted by bucket name and partition, with the highest sequence number for every partition */
+    std::vector<mutation_token> tokens_{};
 };
 } // namespace couchbase
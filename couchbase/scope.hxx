@@ -18,6 +18,7 @@
 #pragma once
 
 #include <couchbase/analytics_options.hxx>
+#include <couchbase/awaitable.hxx>
 #include <couchbase/collection.hxx>
 #include <couchbase/query_options.hxx>
 #include <couchbase/search_options.hxx>
@@ -136,6 +137,33 @@ class scope
         return future;
     }
 
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+    /**
+     * Performs a query against the query (N1QL) services.
+     *
+     * @param statement the N1QL query statement.
+     * @param options options to customize the query request.
+     * @return awaitable, which resumes the coroutine with the error context and the result of the operation
+     *
+     * @exception errc::common::ambiguous_timeout
+     * @exception errc::common::unambiguous_timeout
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto query(std::string statement, const query_options& options, use_awaitable_t /* token */) const
+    {
+        return core::impl::make_awaitable_operation<query_error_context, query_result>(
+          [this, statement = std::move(statement), options = options.build()](query_handler&& handler) mutable {
+              core::impl::initiate_query_operation(core_,
+                                                   std::move(statement),
+                                                   fmt::format("default:`{}`.`{}`", bucket_name_, name_),
+                                                   std::move(options),
+                                                   std::move(handler));
+          });
+    }
+#endif
+
     /**
      * Performs a query against the full text search services.
      *
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <couchbase/awaitable.hxx>
 #include <couchbase/transactions/async_attempt_context.hxx>
 #include <couchbase/transactions/attempt_context.hxx>
 #include <couchbase/transactions/transaction_options.hxx>
@@ -72,5 +73,26 @@ class transactions
     virtual void run(async_txn_logic&& logic,
                      async_txn_complete_logic&& complete_callback,
                      const transaction_options& cfg = transaction_options()) = 0;
+
+#ifdef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+    /**
+     * Run an asynchronous transaction, and resume the awaiting coroutine once it completes.
+     *
+     * @param logic a lambda or function which uses the yielded {@link async_attempt_context} to perform the desired transactional
+     * operations.
+     * @param cfg if passed in, these options override the defaults, or those set in the {@link cluster_options}.
+     * @return awaitable, which resumes the coroutine with the {@link transaction_error_context} and the {@link transaction_result}
+     *
+     * @since 1.0.0
+     * @volatile
+     */
+    [[nodiscard]] auto run(async_txn_logic&& logic, use_awaitable_t /* token */, const transaction_options& cfg = transaction_options())
+    {
+        return core::impl::make_awaitable_operation<transaction_error_context, transaction_result>(
+          [this, logic = std::move(logic), cfg](async_txn_complete_logic&& complete_callback) mutable {
+              run(std::move(logic), std::move(complete_callback), cfg);
+          });
+    }
+#endif
 };
 } // namespace couchbase::transactions
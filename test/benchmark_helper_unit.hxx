@@ -0,0 +1,155 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "test_helper.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <fmt/chrono.h>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace test::utils
+{
+/**
+ * Peak resident set size of the process in bytes, or zero if the platform does not report it.
+ */
+inline std::size_t
+peak_rss()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    // kilobytes on Linux and BSDs
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/**
+ * Latencies of the operations completed during a throughput run.
+ */
+struct throughput_result {
+    std::chrono::nanoseconds elapsed{};
+    std::vector<std::chrono::nanoseconds> latencies{};
+
+    [[nodiscard]] double operations_per_second() const
+    {
+        return static_cast<double>(latencies.size()) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    /**
+     * @param fraction of the operations, which completed faster than the result, e.g. 0.99 for p99
+     */
+    [[nodiscard]] std::chrono::microseconds percentile(double fraction) const
+    {
+        if (latencies.empty()) {
+            return {};
+        }
+        auto index = static_cast<std::size_t>(fraction * static_cast<double>(latencies.size() - 1));
+        return std::chrono::duration_cast<std::chrono::microseconds>(latencies[index]);
+    }
+
+    void report(const std::string& name) const
+    {
+        fmt::print("{}: {} ops in {}, {:.0f} ops/s, latency p50={}, p90={}, p99={}, p99.9={}, max={}\n",
+                   name,
+                   latencies.size(),
+                   std::chrono::duration_cast<std::chrono::milliseconds>(elapsed),
+                   operations_per_second(),
+                   percentile(0.5),
+                   percentile(0.9),
+                   percentile(0.99),
+                   percentile(0.999),
+                   percentile(1.0));
+    }
+};
+
+/**
+ * Keeps @p concurrency operations in flight until @p duration passes, and records the latency of every operation.
+ *
+ * @param operation starts the operation, and invokes the given callback once it completes
+ */
+inline throughput_result
+run_throughput(std::size_t concurrency,
+               std::chrono::milliseconds duration,
+               const std::function<void(std::function<void()>&&)>& operation)
+{
+    struct worker_state {
+        std::chrono::steady_clock::time_point deadline;
+        std::function<void(std::function<void()>&&)> operation;
+        std::vector<std::vector<std::chrono::nanoseconds>> latencies;
+        std::size_t running;
+        std::mutex mutex{};
+        std::promise<void> done{};
+    };
+    auto start = std::chrono::steady_clock::now();
+    auto state = std::make_shared<worker_state>();
+    state->deadline = start + duration;
+    state->operation = operation;
+    state->latencies.resize(concurrency);
+    state->running = concurrency;
+
+    // every worker runs its operations one after another, so it does not need to synchronize access to its latencies
+    std::function<void(std::size_t)> next = [state, &next](std::size_t worker) {
+        auto operation_start = std::chrono::steady_clock::now();
+        state->operation([state, worker, operation_start, &next]() {
+            auto now = std::chrono::steady_clock::now();
+            state->latencies[worker].emplace_back(now - operation_start);
+            if (now < state->deadline) {
+                return next(worker);
+            }
+            std::scoped_lock lock(state->mutex);
+            if (--state->running == 0) {
+                state->done.set_value();
+            }
+        });
+    };
+    for (std::size_t worker = 0; worker < concurrency; ++worker) {
+        next(worker);
+    }
+    state->done.get_future().wait();
+
+    throughput_result result{};
+    result.elapsed = std::chrono::steady_clock::now() - start;
+    for (auto& latencies : state->latencies) {
+        result.latencies.insert(result.latencies.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+} // namespace test::utils
@@ -0,0 +1,83 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_integration.hxx"
+
+namespace
+{
+void
+time_to_first_operation(Catch::Benchmark::Chronometer meter,
+                        test::utils::integration_test_guard& integration,
+                        const couchbase::core::document_id& id,
+                        bool parallel_bootstrap)
+{
+    auto origin = integration.origin;
+    origin.options().enable_parallel_bootstrap = parallel_bootstrap;
+
+    std::vector<std::shared_ptr<couchbase::core::cluster>> clusters(static_cast<std::size_t>(meter.runs()));
+    for (auto& cluster : clusters) {
+        cluster = couchbase::core::cluster::create(integration.io);
+    }
+
+    meter.measure([&](int run) {
+        const auto& cluster = clusters[static_cast<std::size_t>(run)];
+        test::utils::open_cluster(cluster, origin);
+        test::utils::open_bucket(cluster, id.bucket());
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    });
+
+    // closing is not the part of the startup
+    for (const auto& cluster : clusters) {
+        test::utils::close_cluster(cluster);
+    }
+}
+} // namespace
+
+/*
+ * Measures the startup of the application: connect to the cluster, open the bucket and execute the first operation.
+ * The parallel bootstrap makes a difference only if the connection string lists several nodes.
+ */
+TEST_CASE("benchmark: time to the first operation", "[benchmark]")
+{
+    test::utils::integration_test_guard integration;
+
+    test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+
+    couchbase::core::document_id id{ integration.ctx.bucket, "_default", "_default", test::utils::uniq_id("foo") };
+
+    {
+        const tao::json::value value = {
+            { "a", 1.0 },
+            { "b", 2.0 },
+        };
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::json::generate_binary(value) };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    BENCHMARK_ADVANCED("sequential bootstrap")(Catch::Benchmark::Chronometer meter)
+    {
+        time_to_first_operation(meter, integration, id, false);
+    };
+
+    BENCHMARK_ADVANCED("parallel bootstrap")(Catch::Benchmark::Chronometer meter)
+    {
+        time_to_first_operation(meter, integration, id, true);
+    };
+}
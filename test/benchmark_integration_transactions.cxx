@@ -0,0 +1,72 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-Present Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_integration.hxx"
+
+#include "core/transactions.hxx"
+
+using namespace couchbase::core::transactions;
+
+TEST_CASE("benchmark: replace documents in a transaction", "[benchmark]")
+{
+    test::utils::integration_test_guard integration;
+
+    test::utils::open_bucket(integration.cluster, integration.ctx.bucket);
+
+    couchbase::transactions::transactions_config cfg{};
+    cfg.expiration_time(std::chrono::seconds(30));
+    transactions txn(integration.cluster, cfg);
+
+    const tao::json::value value = {
+        { "a", 1.0 },
+        { "b", 2.0 },
+    };
+
+    auto size = GENERATE(as<std::size_t>{}, 1, 10, 100, 500);
+
+    std::vector<couchbase::core::document_id> ids{};
+    ids.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        couchbase::core::document_id id{ integration.ctx.bucket, "_default", "_default", test::utils::uniq_id("txn") };
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::json::generate_binary(value) };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        ids.emplace_back(std::move(id));
+    }
+
+    BENCHMARK(fmt::format("replace {} documents", size))
+    {
+        txn.run([&ids, &value](attempt_context& ctx) {
+            for (const auto& id : ids) {
+                auto doc = ctx.get(id);
+                ctx.replace(doc, value);
+            }
+        });
+    };
+
+    BENCHMARK(fmt::format("replace {} documents and rollback", size))
+    {
+        REQUIRE_THROWS_AS(txn.run([&ids, &value](attempt_context& ctx) {
+                              for (const auto& id : ids) {
+                                  auto doc = ctx.get(id);
+                                  ctx.replace(doc, value);
+                              }
+                              throw std::runtime_error("rollback");
+                          }),
+                          transaction_exception);
+    };
+}
@@ -0,0 +1,148 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_unit.hxx"
+
+#include "utils/mock_cluster_guard.hxx"
+#include "utils/mock_http_server.hxx"
+
+#include "core/operations/document_analytics.hxx"
+#include "core/operations/document_query.hxx"
+#include "core/operations/document_search.hxx"
+
+#include <array>
+#include <atomic>
+
+namespace
+{
+constexpr std::chrono::seconds throughput_duration{ 2 };
+
+struct response_shape {
+    const char* name;
+    std::size_t number_of_rows;
+    std::size_t row_size;
+};
+
+constexpr std::array response_shapes{
+    response_shape{ "10 rows of 1KB", 10, 1024 },
+    response_shape{ "1000 rows of 128B", 1000, 128 },
+    response_shape{ "100 rows of 16KB", 100, 16 * 1024 },
+};
+
+void
+report_http(const std::string& name,
+            const test::utils::throughput_result& result,
+            std::size_t rows_per_operation,
+            const test::utils::mock_http_server::stats& before,
+            const test::utils::mock_http_server::stats& after)
+{
+    result.report(name);
+    auto seconds = std::chrono::duration<double>(result.elapsed).count();
+    fmt::print("{}: {:.0f} rows/s, {:.1f} MiB/s, {} new connections for {} requests, peak RSS {} MiB\n",
+               name,
+               static_cast<double>(result.latencies.size() * rows_per_operation) / seconds,
+               static_cast<double>(after.bytes_sent - before.bytes_sent) / seconds / (1024 * 1024),
+               after.connections - before.connections,
+               after.requests - before.requests,
+               test::utils::peak_rss() / (1024 * 1024));
+}
+
+couchbase::core::operations::query_request
+make_query_request()
+{
+    return couchbase::core::operations::query_request{ "SELECT 1" };
+}
+
+couchbase::core::operations::query_request
+make_streaming_query_request()
+{
+    couchbase::core::operations::query_request req{ "SELECT 1" };
+    req.row_callback = [](std::string&& /* row */) { return couchbase::core::utils::json::stream_control::next_row; };
+    return req;
+}
+
+couchbase::core::operations::analytics_request
+make_analytics_request()
+{
+    couchbase::core::operations::analytics_request req{};
+    req.statement = "SELECT 1";
+    return req;
+}
+
+couchbase::core::operations::search_request
+make_search_request()
+{
+    couchbase::core::operations::search_request req{};
+    req.index_name = "index";
+    req.query = couchbase::core::json_string{ R"({"match_all":{}})" };
+    return req;
+}
+} // namespace
+
+TEST_CASE("benchmark: query, analytics and search responses from the HTTP stand-in", "[benchmark]")
+{
+    test::utils::mock_http_server http;
+    test::utils::mock_mcbp_server::options server_options{};
+    server_options.services = http.services();
+    test::utils::mock_cluster_guard guard(server_options);
+
+    BENCHMARK("query")
+    {
+        auto resp = test::utils::execute(guard.cluster, make_query_request());
+        REQUIRE_SUCCESS(resp.ctx.ec);
+    };
+
+    BENCHMARK("search")
+    {
+        auto resp = test::utils::execute(guard.cluster, make_search_request());
+        REQUIRE_SUCCESS(resp.ctx.ec);
+    };
+
+    // the assertions are not thread-safe, so the callbacks only count failures
+    std::atomic<std::size_t> failures{ 0 };
+    for (const auto& shape : response_shapes) {
+        test::utils::mock_http_server::response_options response{};
+        response.number_of_rows = shape.number_of_rows;
+        response.row_size = shape.row_size;
+        http.set_response_options(response);
+
+        for (std::size_t concurrency : { 1, 16 }) {
+            auto measure = [&](const std::string& name, auto make_request) {
+                using response_type = typename decltype(make_request())::response_type;
+                auto before = http.statistics();
+                auto result = test::utils::run_throughput(concurrency, throughput_duration, [&](std::function<void()>&& done) {
+                    guard.cluster->execute(make_request(), [&failures, done = std::move(done)](response_type&& resp) {
+                        if (resp.ctx.ec) {
+                            ++failures;
+                        }
+                        done();
+                    });
+                });
+                report_http(fmt::format("{}, {}, {} in flight", name, shape.name, concurrency),
+                            result,
+                            shape.number_of_rows,
+                            before,
+                            http.statistics());
+            };
+            measure("query", make_query_request);
+            measure("streaming query", make_streaming_query_request);
+            measure("analytics", make_analytics_request);
+            measure("search", make_search_request);
+        }
+    }
+    REQUIRE(failures == 0);
+}
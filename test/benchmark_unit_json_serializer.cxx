@@ -0,0 +1,106 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/utils/json.hxx"
+
+#include <couchbase/codec/tao_json_serializer.hxx>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <fmt/core.h>
+
+#include <tao/json.hpp>
+#include <tao/json/contrib/traits.hpp>
+
+#include <algorithm>
+
+namespace
+{
+struct order_line {
+    std::string sku{};
+    std::string description{};
+    std::int64_t quantity{};
+    double price{};
+    bool gift{};
+    std::vector<std::string> tags{};
+};
+} // namespace
+
+template<>
+struct tao::json::traits<order_line>
+  : tao::json::binding::object<TAO_JSON_BIND_REQUIRED("sku", &order_line::sku),
+                               TAO_JSON_BIND_REQUIRED("description", &order_line::description),
+                               TAO_JSON_BIND_REQUIRED("quantity", &order_line::quantity),
+                               TAO_JSON_BIND_REQUIRED("price", &order_line::price),
+                               TAO_JSON_BIND_REQUIRED("gift", &order_line::gift),
+                               TAO_JSON_BIND_REQUIRED("tags", &order_line::tags)> {
+};
+
+namespace
+{
+/**
+ * Roughly @p size bytes of JSON, every order line takes about 130 bytes.
+ */
+std::vector<order_line>
+make_order(std::size_t size)
+{
+    std::vector<order_line> order{};
+    for (std::size_t index = 0; index < std::max<std::size_t>(size / 130, 1); ++index) {
+        order.push_back({
+          fmt::format("SKU-{:08}", index),
+          "Blue widget, \"large\"",
+          static_cast<std::int64_t>(index % 10 + 1),
+          19.99 + static_cast<double>(index),
+          index % 3 == 0,
+          { "hardware", "widgets", "sale" },
+        });
+    }
+    return order;
+}
+} // namespace
+
+TEST_CASE("benchmark: JSON serialization of user documents", "[benchmark]")
+{
+    using couchbase::codec::tao_json_serializer;
+
+    for (std::size_t size : { 1024, 10 * 1024, 100 * 1024 }) {
+        auto order = make_order(size);
+        auto encoded = tao_json_serializer::serialize(order);
+        REQUIRE(tao_json_serializer::deserialize<std::vector<order_line>>(encoded).size() == order.size());
+        // the members are written in the order of the binding, rather than sorted as in tao::json::value
+        REQUIRE(couchbase::core::utils::json::parse_binary(encoded) ==
+                couchbase::core::utils::json::parse_binary(couchbase::core::utils::json::generate_binary(tao::json::value(order))));
+        fmt::print("document of {} order lines, {} bytes\n", order.size(), encoded.size());
+
+        BENCHMARK(fmt::format("serialize {} bytes through tao::json::value", encoded.size()))
+        {
+            return couchbase::core::utils::json::generate_binary(tao::json::value(order));
+        };
+
+        BENCHMARK(fmt::format("serialize {} bytes as stream of events", encoded.size()))
+        {
+            return tao_json_serializer::serialize(order);
+        };
+
+        BENCHMARK(fmt::format("deserialize {} bytes through tao::json::value", encoded.size()))
+        {
+            return tao_json_serializer::deserialize<std::vector<order_line>>(encoded);
+        };
+    }
+}
@@ -0,0 +1,120 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/utils/json_streaming_lexer.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <fmt/core.h>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t payload_size{ 8 * 1024 * 1024 };
+constexpr std::size_t chunk_size{ 64 * 1024 };
+
+/**
+ * Query response with rows produced by @p make_row until the payload reaches payload_size.
+ */
+std::string
+make_payload(const std::function<std::string(std::size_t)>& make_row)
+{
+    std::string payload =
+      R"({"requestID":"2640a5b5-2e67-44e7-86ec-31cc388b7427","clientContextID":"730ecac3","signature":{"*":"*"},"results":[)";
+    for (std::size_t index = 0; payload.size() < payload_size; ++index) {
+        if (index > 0) {
+            payload.push_back(',');
+        }
+        payload.append(make_row(index));
+    }
+    payload.append(R"(],"status":"success","metrics":{"elapsedTime":"1.284307ms","executionTime":"1.231972ms"}})");
+    return payload;
+}
+
+std::size_t
+lex(const std::string& payload)
+{
+    couchbase::core::utils::json::streaming_lexer lexer("/results/^", 4);
+    std::size_t rows_size{ 0 };
+    std::error_code error{};
+    lexer.on_row([&rows_size](std::string&& row) {
+        rows_size += row.size();
+        return couchbase::core::utils::json::stream_control::next_row;
+    });
+    lexer.on_complete([&error](std::error_code ec, std::size_t /* number_of_rows */, std::string&& /* meta */) { error = ec; });
+    for (std::size_t offset = 0; offset < payload.size(); offset += chunk_size) {
+        lexer.feed(std::string_view(payload).substr(offset, chunk_size));
+    }
+    REQUIRE_SUCCESS(error);
+    return rows_size;
+}
+} // namespace
+
+TEST_CASE("benchmark: streaming JSON lexer throughput", "[benchmark]")
+{
+    const std::vector<std::pair<std::string, std::string>> shapes{
+        {
+          "small flat objects",
+          make_payload([](std::size_t index) {
+              return fmt::format(R"({{"id":"row-{:08}","type":"beer","abv":7.2,"ibu":0.0,"upc":{}}})", index, index);
+          }),
+        },
+        {
+          "documents with long strings",
+          make_payload([](std::size_t index) {
+              return fmt::format(R"({{"id":"row-{:08}","description":"{}","escaped":"quote \" and backslash \\ inside"}})",
+                                 index,
+                                 std::string(4096, 'x'));
+          }),
+        },
+        {
+          "nested objects and arrays",
+          make_payload([](std::size_t index) {
+              return fmt::format(R"({{"id":"row-{:08}","geo":{{"accuracy":"ROOFTOP","lat":37.7825,"lon":-122.393}},)"
+                                 R"("address":["563 Second Street",{{"city":"San Francisco","codes":[94107,94108]}}],)"
+                                 R"("tags":[["a","b"],["c",["d","e"]]]}})",
+                                 index);
+          }),
+        },
+        {
+          "scalars",
+          make_payload([](std::size_t index) { return index % 2 == 0 ? fmt::format("{}", index) : fmt::format(R"("row-{:08}")", index); }),
+        },
+    };
+
+    for (const auto& [name, payload] : shapes) {
+        auto start = std::chrono::steady_clock::now();
+        lex(payload);
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        fmt::print("{}: {} MiB in {:.1f} ms, {:.0f} MiB/s\n",
+                   name,
+                   payload.size() / (1024 * 1024),
+                   elapsed.count() * 1000,
+                   static_cast<double>(payload.size()) / (1024 * 1024) / elapsed.count());
+
+        BENCHMARK(fmt::format("lex {}", name))
+        {
+            return lex(payload);
+        };
+    }
+}
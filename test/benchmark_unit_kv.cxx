@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "benchmark_helper_unit.hxx"
+
+#include "utils/mock_cluster_guard.hxx"
+
+#include "core/cluster.hxx"
+#include "core/operations/document_get.hxx"
+#include "core/operations/document_lookup_in.hxx"
+#include "core/operations/document_upsert.hxx"
+#include "core/utils/binary.hxx"
+
+#include <couchbase/cluster.hxx>
+#include <couchbase/lookup_in_specs.hxx>
+
+#include <atomic>
+
+namespace
+{
+constexpr std::chrono::seconds throughput_duration{ 2 };
+} // namespace
+
+TEST_CASE("benchmark: key/value operations against the KV stand-in", "[benchmark]")
+{
+    test::utils::mock_cluster_guard guard;
+
+    couchbase::core::document_id id{ guard.bucket_name(), "_default", "_default", "foo" };
+    {
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary(R"({"a":1.0,"b":{"c":2.0}})") };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    BENCHMARK("get")
+    {
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    };
+
+    BENCHMARK("upsert")
+    {
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary(R"({"a":1.0,"b":{"c":2.0}})") };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    };
+
+    BENCHMARK("lookup_in")
+    {
+        couchbase::core::operations::lookup_in_request req{ id };
+        req.specs = couchbase::lookup_in_specs{ couchbase::lookup_in_specs::get("b.c") }.specs();
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    };
+
+    auto collection = couchbase::cluster(guard.cluster).bucket(guard.bucket_name()).default_collection();
+
+    BENCHMARK("get, waiting on std::future")
+    {
+        auto [ctx, result] = collection.get("foo", {}).get();
+        REQUIRE_SUCCESS(ctx.ec());
+    };
+
+    BENCHMARK("get, use_blocking")
+    {
+        auto [ctx, result] = collection.get("foo", {}, couchbase::use_blocking);
+        REQUIRE_SUCCESS(ctx.ec());
+    };
+
+    // the assertions are not thread-safe, so the callbacks only count failures
+    std::atomic<std::size_t> failures{ 0 };
+    for (std::size_t concurrency : { 1, 16, 128 }) {
+        auto result = test::utils::run_throughput(concurrency, throughput_duration, [&guard, &id, &failures](std::function<void()>&& done) {
+            couchbase::core::operations::get_request req{ id };
+            guard.cluster->execute(req, [&failures, done = std::move(done)](couchbase::core::operations::get_response&& resp) {
+                if (resp.ctx.ec()) {
+                    ++failures;
+                }
+                done();
+            });
+        });
+        result.report(fmt::format("get, {} in flight", concurrency));
+
+        result = test::utils::run_throughput(concurrency, throughput_duration, [&guard, &id, &failures](std::function<void()>&& done) {
+            couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary(R"({"a":1.0,"b":{"c":2.0}})") };
+            guard.cluster->execute(req, [&failures, done = std::move(done)](couchbase::core::operations::upsert_response&& resp) {
+                if (resp.ctx.ec()) {
+                    ++failures;
+                }
+                done();
+            });
+        });
+        result.report(fmt::format("upsert, {} in flight", concurrency));
+    }
+    REQUIRE(failures == 0);
+}
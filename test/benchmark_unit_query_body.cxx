@@ -0,0 +1,78 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/cluster_options.hxx"
+#include "core/operations/document_query.hxx"
+#include "core/topology/configuration.hxx"
+#include "core/utils/json.hxx"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <fmt/core.h>
+
+namespace
+{
+couchbase::core::operations::query_request
+make_request(std::size_t parameter)
+{
+    couchbase::core::operations::query_request req{ "SELECT * FROM `travel-sample`.inventory.airline WHERE id = $1 AND country = $2" };
+    req.readonly = true;
+    req.max_parallelism = 4;
+    req.scan_cap = 512;
+    req.pipeline_batch = 64;
+    req.scan_consistency = couchbase::query_scan_consistency::request_plus;
+    req.scan_wait = std::chrono::milliseconds{ 100 };
+    req.query_context = "default:`travel-sample`.`inventory`";
+    req.raw["numatrs"] = couchbase::core::json_string{ "2" };
+    req.positional_parameters.emplace_back(std::to_string(parameter));
+    req.positional_parameters.emplace_back(R"("United States")");
+    return req;
+}
+} // namespace
+
+TEST_CASE("benchmark: encode query request body", "[benchmark]")
+{
+    couchbase::core::topology::configuration config{};
+    couchbase::core::query_cache query_cache{};
+    couchbase::core::cluster_options cluster_options{};
+    std::string hostname{};
+    std::uint16_t port{};
+    couchbase::core::http_context ctx{ config, cluster_options, query_cache, hostname, port };
+
+    std::size_t parameter{ 0 };
+    BENCHMARK("full body")
+    {
+        auto req = make_request(++parameter);
+        couchbase::core::io::http_request http_req{};
+        http_req.client_context_id = fmt::format("{}", parameter);
+        http_req.timeout = std::chrono::milliseconds{ 75'000 };
+        return req.encode_to(http_req, ctx);
+    };
+
+    auto body_template = std::make_shared<couchbase::core::operations::query_body_template>();
+    BENCHMARK("body template")
+    {
+        auto req = make_request(++parameter);
+        req.body_template = body_template;
+        couchbase::core::io::http_request http_req{};
+        http_req.client_context_id = fmt::format("{}", parameter);
+        http_req.timeout = std::chrono::milliseconds{ 75'000 };
+        return req.encode_to(http_req, ctx);
+    };
+}
@@ -0,0 +1,75 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/platform/base64.h"
+#include "core/sasl/client.h"
+#include "core/sasl/scram-sha/salted_password_cache.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+namespace
+{
+constexpr std::size_t number_of_nodes{ 10 };
+
+/**
+ * Runs the client side of the SCRAM exchange up to the client-final-message (which is where the salted password is
+ * derived) for every node, like the KV sessions do while bootstrapping.
+ */
+void
+authenticate_with_every_node(bool cold_cache)
+{
+    using couchbase::core::sasl::mechanism::scram::SaltedPasswordCache;
+
+    for (std::size_t node = 0; node < number_of_nodes; ++node) {
+        if (cold_cache) {
+            SaltedPasswordCache::instance().clear();
+        }
+        couchbase::core::sasl::ClientContext client{ []() { return std::string{ "Administrator" }; },
+                                                     []() { return std::string{ "password" }; },
+                                                     { "SCRAM-SHA512" } };
+        auto [start_error, client_first_message] = client.start();
+        REQUIRE(start_error == couchbase::core::sasl::error::OK);
+        std::string client_nonce{ client_first_message.substr(client_first_message.find("r=") + 2) };
+        // every node of the cluster sends the same salt and iteration count for the user
+        std::string server_first_message = "r=" + client_nonce + "server-nonce,s=" + couchbase::core::base64::encode("cluster-wide-salt") +
+                                           ",i=15000";
+        auto [step_error, client_final_message] = client.step(server_first_message);
+        REQUIRE(step_error == couchbase::core::sasl::error::CONTINUE);
+    }
+}
+} // namespace
+
+TEST_CASE("benchmark: SCRAM-SHA512 authentication of a 10-node bootstrap", "[benchmark]")
+{
+    BENCHMARK("derive salted password on every node")
+    {
+        return authenticate_with_every_node(true);
+    };
+
+    BENCHMARK("share salted password across nodes")
+    {
+        couchbase::core::sasl::mechanism::scram::SaltedPasswordCache::instance().clear();
+        return authenticate_with_every_node(false);
+    };
+
+    BENCHMARK("reconnect with cached salted password")
+    {
+        return authenticate_with_every_node(false);
+    };
+}
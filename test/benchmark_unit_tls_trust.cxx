@@ -0,0 +1,55 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/capella_ca.hxx"
+#include "core/default_trust_store.hxx"
+#include "core/mozilla_ca_bundle.hxx"
+
+#include <asio/ssl.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <cstring>
+
+/*
+ * The part of cluster::connect with TLS that prepares the trusted CAs, which runs before the first byte is sent to the
+ * cluster.
+ */
+TEST_CASE("benchmark: trusted CAs of the TLS context on cluster connect", "[benchmark]")
+{
+    BENCHMARK("parse default CAs into every context")
+    {
+        asio::ssl::context tls{ asio::ssl::context::tls_client };
+        std::error_code ec{};
+        tls.set_default_verify_paths(ec);
+        tls.add_certificate_authority(
+          asio::const_buffer(couchbase::core::default_ca::capellaCaCert, strlen(couchbase::core::default_ca::capellaCaCert)), ec);
+        for (const auto& cert : couchbase::core::default_ca::mozilla_ca_certs()) {
+            tls.add_certificate_authority(asio::const_buffer(cert.body.data(), cert.body.size()), ec);
+        }
+        return SSL_CTX_get_cert_store(tls.native_handle());
+    };
+
+    BENCHMARK("share default trust store")
+    {
+        asio::ssl::context tls{ asio::ssl::context::tls_client };
+        SSL_CTX_set_cert_store(tls.native_handle(), couchbase::core::default_ca::default_trust_store(true));
+        return SSL_CTX_get_cert_store(tls.native_handle());
+    };
+}
@@ -126,7 +126,8 @@ assert_kv_op_span_ok(test::utils::integration_test_guard& guard,
     REQUIRE_FALSE(span->string_tags()["cb.local_id"].empty());
     REQUIRE_FALSE(span->string_tags()["cb.local_socket"].empty());
     REQUIRE_FALSE(span->string_tags()["cb.remote_socket"].empty());
-    REQUIRE_FALSE(span->string_tags()["cb.operation_id"].empty());
+    // the opaque of the KV command
+    REQUIRE(span->int_tags().count("cb.operation_id") == 1);
     REQUIRE(span->string_tags()["db.instance"] == guard.ctx.bucket);
     REQUIRE(span->parent() == parent);
     if (parent) {
@@ -420,6 +420,42 @@ TEST_CASE("transactions: can get replace objects", "[transactions]")
     }
 }
 
+TEST_CASE("transactions: can get projected and replace", "[transactions]")
+{
+    test::utils::integration_test_guard integration;
+    auto cluster = integration.cluster;
+
+    transactions txn(cluster, get_conf());
+    couchbase::core::document_id id{ integration.ctx.bucket, "_default", "_default", test::utils::uniq_id("txn") };
+    const tao::json::value initial{
+        { "name", "someone" },
+        { "address", { { "city", "somewhere" }, { "zip", "12345" } } },
+        { "notes", "a lot of text that we do not want to read" },
+    };
+    {
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::json::generate_binary(initial) };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    txn.run([id](attempt_context& ctx) {
+        auto doc = ctx.get_projected(id, { "name", "address.city" });
+        auto projected = couchbase::core::utils::json::parse_binary(doc.content());
+        REQUIRE(projected == tao::json::value{ { "name", "someone" }, { "address", { { "city", "somewhere" } } } });
+        ctx.replace(doc, tao::json::value{ { "name", "someone else" } });
+
+        // reading our own write is projected too
+        auto own_write = ctx.get_projected(id, { "name", "address" });
+        REQUIRE(couchbase::core::utils::json::parse_binary(own_write.content()) == tao::json::value{ { "name", "someone else" } });
+    });
+    {
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(integration.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(couchbase::core::utils::json::parse_binary(resp.value) == tao::json::value{ { "name", "someone else" } });
+    }
+}
+
 TEST_CASE("transactions: can get replace mixed object strings", "[transactions]")
 {
     test::utils::integration_test_guard integration;
@@ -0,0 +1,150 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_cluster_guard.hxx"
+
+#include <couchbase/awaitable.hxx>
+#include <couchbase/cluster.hxx>
+#include <couchbase/error_codes.hxx>
+#include <couchbase/lookup_in_specs.hxx>
+#include <couchbase/mutate_in_specs.hxx>
+
+#include <tao/json.hpp>
+
+#include <coroutine>
+#include <future>
+#include <string>
+
+// the target is built as C++20, and only when the compiler supports coroutines, see cmake/Testing.cmake
+#ifndef COUCHBASE_CXX_CLIENT_HAS_COROUTINES
+#error "test_unit_awaitable requires C++20 coroutines"
+#endif
+
+namespace
+{
+// coroutine, which starts eagerly and is not awaited by anyone
+struct detached_task {
+    struct promise_type {
+        detached_task get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+};
+
+struct awaited_results {
+    std::error_code upsert{};
+    couchbase::cas upsert_cas{};
+    std::error_code get{};
+    std::string value{};
+    std::error_code mutate_in{};
+    couchbase::cas mutate_in_cas{};
+    std::error_code lookup_in{};
+    std::int64_t field{};
+};
+
+detached_task
+run_awaited_operations(couchbase::collection collection, std::promise<awaited_results>& barrier)
+{
+    awaited_results results{};
+
+    //! [awaitable-kv]
+    auto [upsert_ctx, upsert_result] = co_await collection.upsert("foo", tao::json::value{ { "a", 1 } }, {}, couchbase::use_awaitable);
+    auto [get_ctx, get_result] = co_await collection.get("foo", {}, couchbase::use_awaitable);
+    //! [awaitable-kv]
+    results.upsert = upsert_ctx.ec();
+    results.upsert_cas = upsert_result.cas();
+    results.get = get_ctx.ec();
+    if (!get_ctx.ec()) {
+        results.value = tao::json::to_string(get_result.content_as<tao::json::value>());
+    }
+
+    auto [mutate_in_ctx, mutate_in_result] = co_await collection.mutate_in(
+      "foo", couchbase::mutate_in_specs{ couchbase::mutate_in_specs::upsert("b", 2) }, {}, couchbase::use_awaitable);
+    results.mutate_in = mutate_in_ctx.ec();
+    results.mutate_in_cas = mutate_in_result.cas();
+
+    auto [lookup_in_ctx, lookup_in_result] = co_await collection.lookup_in(
+      "foo", couchbase::lookup_in_specs{ couchbase::lookup_in_specs::get("b") }, {}, couchbase::use_awaitable);
+    results.lookup_in = lookup_in_ctx.ec();
+    if (!lookup_in_ctx.ec()) {
+        results.field = lookup_in_result.content_as<std::int64_t>(0);
+    }
+
+    barrier.set_value(std::move(results));
+}
+
+detached_task
+run_awaited_get(couchbase::collection collection, std::string id, std::promise<std::error_code>& barrier)
+{
+    auto [ctx, result] = co_await collection.get(std::move(id), {}, couchbase::use_awaitable);
+    barrier.set_value(ctx.ec());
+}
+} // namespace
+
+TEST_CASE("unit: KV operations can be awaited from coroutines", "[unit]")
+{
+    test::utils::mock_cluster_guard guard;
+    auto collection = couchbase::cluster(guard.cluster).bucket(guard.bucket_name()).default_collection();
+
+    // the coroutine resumes on the IO threads, where the assertions cannot be used
+    std::promise<awaited_results> barrier;
+    auto f = barrier.get_future();
+    run_awaited_operations(collection, barrier);
+    auto results = f.get();
+
+    REQUIRE_SUCCESS(results.upsert);
+    REQUIRE_FALSE(results.upsert_cas.empty());
+    REQUIRE_SUCCESS(results.get);
+    REQUIRE(results.value == R"({"a":1})");
+    REQUIRE_SUCCESS(results.mutate_in);
+    REQUIRE(results.mutate_in_cas != results.upsert_cas);
+    REQUIRE_SUCCESS(results.lookup_in);
+    REQUIRE(results.field == 2);
+}
+
+TEST_CASE("unit: awaited KV operations report errors in the context", "[unit]")
+{
+    test::utils::mock_cluster_guard guard;
+    auto collection = couchbase::cluster(guard.cluster).bucket(guard.bucket_name()).default_collection();
+
+    std::promise<std::error_code> barrier;
+    auto f = barrier.get_future();
+    run_awaited_get(collection, "missing", barrier);
+    REQUIRE(f.get() == couchbase::errc::key_value::document_not_found);
+}
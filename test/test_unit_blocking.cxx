@@ -0,0 +1,96 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_cluster_guard.hxx"
+
+#include <couchbase/blocking.hxx>
+#include <couchbase/cluster.hxx>
+#include <couchbase/error_codes.hxx>
+
+#include <tao/json.hpp>
+
+#include <system_error>
+#include <thread>
+
+TEST_CASE("unit: one-shot event", "[unit]")
+{
+    SECTION("notified before waiting")
+    {
+        couchbase::core::impl::one_shot_event event;
+        event.notify();
+        event.wait();
+    }
+
+    SECTION("notified from another thread")
+    {
+        // every round destroys the event right after the wait, while the notifier might still be inside notify()
+        for (std::size_t round = 0; round < 1'000; ++round) {
+            couchbase::core::impl::blocking_waiter<std::error_code, std::size_t> waiter;
+            std::thread notifier([handler = waiter.handler(), round]() mutable { handler({}, round); });
+            auto [ec, value] = waiter.wait();
+            notifier.join();
+            REQUIRE_SUCCESS(ec);
+            REQUIRE(value == round);
+        }
+    }
+}
+
+TEST_CASE("unit: blocking KV operations", "[unit]")
+{
+    test::utils::mock_cluster_guard guard;
+    auto collection = couchbase::cluster(guard.cluster).bucket(guard.bucket_name()).default_collection();
+
+    //! [blocking-kv]
+    auto [upsert_ctx, upsert_result] = collection.upsert("foo", tao::json::value{ { "a", 1 } }, {}, couchbase::use_blocking);
+    auto [get_ctx, get_result] = collection.get("foo", {}, couchbase::use_blocking);
+    //! [blocking-kv]
+    REQUIRE_SUCCESS(upsert_ctx.ec());
+    REQUIRE_SUCCESS(get_ctx.ec());
+    REQUIRE(get_result.cas() == upsert_result.cas());
+    REQUIRE(get_result.content_as<tao::json::value>() == tao::json::value{ { "a", 1 } });
+
+    {
+        auto [ctx, result] = collection.insert("foo", tao::json::value{ { "a", 2 } }, {}, couchbase::use_blocking);
+        REQUIRE(ctx.ec() == couchbase::errc::key_value::document_exists);
+    }
+
+    {
+        auto [ctx, result] = collection.mutate_in(
+          "foo", couchbase::mutate_in_specs{ couchbase::mutate_in_specs::upsert("b", 2) }, {}, couchbase::use_blocking);
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(result.cas() != upsert_result.cas());
+    }
+
+    {
+        auto [ctx, result] =
+          collection.lookup_in("foo", couchbase::lookup_in_specs{ couchbase::lookup_in_specs::get("b") }, {}, couchbase::use_blocking);
+        REQUIRE_SUCCESS(ctx.ec());
+        REQUIRE(result.content_as<std::int64_t>(0) == 2);
+    }
+
+    {
+        auto [ctx, result] = collection.remove("foo", {}, couchbase::use_blocking);
+        REQUIRE_SUCCESS(ctx.ec());
+    }
+
+    {
+        auto [ctx, result] = collection.get("foo", {}, couchbase::use_blocking);
+        REQUIRE(ctx.ec() == couchbase::errc::key_value::document_not_found);
+    }
+}
@@ -398,6 +398,20 @@ TEST_CASE("unit: connection string", "[unit]")
                                  });
             CHECK(spec.options.key_value_timeout == std::chrono::milliseconds(4002));
 
+            spec = couchbase::core::utils::parse_connection_string("couchbase://127.0.0.1,127.0.0.2?enable_parallel_bootstrap=true");
+            CHECK(spec.warnings.empty());
+            CHECK(spec.options.enable_parallel_bootstrap);
+
+            spec = couchbase::core::utils::parse_connection_string("couchbase://127.0.0.1?min_idle_http_connections=2");
+            CHECK(spec.options.min_idle_http_connections == 2);
+
+            spec = couchbase::core::utils::parse_connection_string("couchbase://127.0.0.1?http_node_selection=power_of_two_choices");
+            CHECK(spec.warnings.empty());
+            CHECK(spec.options.http_node_selection == couchbase::core::http_node_selection_policy::power_of_two_choices);
+
+            spec = couchbase::core::utils::parse_connection_string("couchbase://127.0.0.1?enable_http_pipelining=true");
+            CHECK(spec.options.enable_http_pipelining);
+
             spec = couchbase::core::utils::parse_connection_string(
               "couchbase://127.0.0.1?user_agent_extra=couchnode%2F4.1.1%20(node%2F12.11.1%3B%20v8%2F7.7.299.11-node.12%3B%20ssl%2F1.1.1c)");
             CHECK(spec.options.user_agent_extra == "couchnode/4.1.1 (node/12.11.1; v8/7.7.299.11-node.12; ssl/1.1.1c)");
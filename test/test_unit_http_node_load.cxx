@@ -0,0 +1,109 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/io/http_node_load.hxx"
+
+#include <map>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+std::map<std::string, std::size_t>
+count_choices(couchbase::core::io::http_node_load& load, const std::vector<std::string>& candidates, std::size_t rounds = 1000)
+{
+    std::map<std::string, std::size_t> choices{};
+    for (std::size_t i = 0; i < rounds; ++i) {
+        ++choices[candidates[load.choose(candidates)]];
+    }
+    return choices;
+}
+} // namespace
+
+TEST_CASE("unit: power of two choices prefers the cheaper endpoint", "[unit]")
+{
+    couchbase::core::io::http_node_load load{ 42 };
+    const std::vector<std::string> candidates{ "slow:8093", "fast:8093" };
+
+    SECTION("lower latency")
+    {
+        load.request_started("slow:8093");
+        load.request_completed("slow:8093", 10ms, true);
+        load.request_started("fast:8093");
+        load.request_completed("fast:8093", 1ms, true);
+        REQUIRE(count_choices(load, candidates)["fast:8093"] == 1000);
+    }
+
+    SECTION("fewer outstanding requests")
+    {
+        for (int i = 0; i < 5; ++i) {
+            load.request_started("slow:8093");
+        }
+        load.request_started("fast:8093");
+        REQUIRE(count_choices(load, candidates)["fast:8093"] == 1000);
+    }
+
+    SECTION("endpoint without measurements is tried")
+    {
+        load.request_started("slow:8093");
+        load.request_completed("slow:8093", 1ms, true);
+        REQUIRE(count_choices(load, candidates)["fast:8093"] == 1000);
+    }
+
+    SECTION("endpoint, which fails fast, is not preferred")
+    {
+        load.request_started("slow:8093");
+        load.request_completed("slow:8093", 50ms, true);
+        load.request_started("fast:8093");
+        load.request_completed("fast:8093", 1ms, false);
+        REQUIRE(count_choices(load, candidates)["slow:8093"] == 1000);
+    }
+}
+
+TEST_CASE("unit: power of two choices never picks the most expensive of three endpoints", "[unit]")
+{
+    couchbase::core::io::http_node_load load{ 42 };
+    const std::vector<std::string> candidates{ "a:8093", "b:8093", "c:8093" };
+    const std::map<std::string, std::chrono::milliseconds> latencies{ { "a:8093", 1ms }, { "b:8093", 2ms }, { "c:8093", 30ms } };
+    for (const auto& [endpoint, latency] : latencies) {
+        load.request_started(endpoint);
+        load.request_completed(endpoint, latency, true);
+    }
+
+    auto choices = count_choices(load, candidates);
+    REQUIRE(choices["c:8093"] == 0);
+    // "a" wins every pair it is part of, and "b" only wins against "c"
+    REQUIRE(choices["a:8093"] > choices["b:8093"]);
+    REQUIRE(choices["b:8093"] > 0);
+}
+
+TEST_CASE("unit: load of the endpoints, which left the cluster, is forgotten", "[unit]")
+{
+    couchbase::core::io::http_node_load load{ 42 };
+    load.request_started("a:8093");
+    load.request_started("b:8093");
+    REQUIRE(load.number_of_endpoints() == 2);
+
+    load.retain({ "b:8093" });
+    REQUIRE(load.number_of_endpoints() == 1);
+
+    // the request, which was in flight, does not bring the endpoint back
+    load.request_completed("a:8093", 1ms, true);
+    REQUIRE(load.number_of_endpoints() == 1);
+}
@@ -0,0 +1,63 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2020-2021 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/io/http_parser.hxx"
+
+#include <string>
+
+TEST_CASE("unit: http parser stops at the end of the response", "[unit]")
+{
+    const std::string first = "HTTP/1.1 200 OK\r\ncontent-length: 5\r\n\r\nfirst";
+    const std::string second = "HTTP/1.1 404 Not Found\r\ncontent-length: 6\r\n\r\nsecond";
+    const std::string input = first + second;
+
+    couchbase::core::io::http_parser first_parser;
+    auto res = first_parser.feed(input.data(), input.size());
+    REQUIRE_FALSE(res.failure);
+    REQUIRE(res.complete);
+    REQUIRE(res.bytes_parsed == first.size());
+    REQUIRE(first_parser.response.status_code == 200);
+    REQUIRE(first_parser.response.body.data() == "first");
+
+    couchbase::core::io::http_parser second_parser;
+    res = second_parser.feed(input.data() + res.bytes_parsed, input.size() - res.bytes_parsed);
+    REQUIRE_FALSE(res.failure);
+    REQUIRE(res.complete);
+    REQUIRE(res.bytes_parsed == second.size());
+    REQUIRE(second_parser.response.status_code == 404);
+    REQUIRE(second_parser.response.body.data() == "second");
+}
+
+TEST_CASE("unit: http parser consumes the response split into chunks", "[unit]")
+{
+    const std::string input = "HTTP/1.1 200 OK\r\ncontent-length: 5\r\n\r\nhello";
+    const auto split = input.size() - 3;
+
+    couchbase::core::io::http_parser parser;
+    auto res = parser.feed(input.data(), split);
+    REQUIRE_FALSE(res.failure);
+    REQUIRE_FALSE(res.complete);
+    REQUIRE(res.bytes_parsed == split);
+
+    res = parser.feed(input.data() + split, input.size() - split);
+    REQUIRE_FALSE(res.failure);
+    REQUIRE(res.complete);
+    REQUIRE(res.bytes_parsed == input.size() - split);
+    REQUIRE(parser.response.body.data() == "hello");
+}
@@ -233,3 +233,97 @@ TEST_CASE("unit: json_streaming_lexer parse payload with missing results", "[uni
     REQUIRE(result.rows.empty());
     REQUIRE(result.meta == chunk);
 }
+
+namespace
+{
+query_result
+lex_query_result(const std::vector<std::string>& chunks)
+{
+    couchbase::core::utils::json::streaming_lexer lexer("/results/^", 4);
+    query_result result{};
+    lexer.on_row([&result](std::string&& row) {
+        result.rows.emplace_back(std::move(row));
+        return couchbase::core::utils::json::stream_control::next_row;
+    });
+    lexer.on_complete([&result](std::error_code ec, std::size_t number_of_rows, std::string&& meta) {
+        result.ec = ec;
+        result.number_of_rows = number_of_rows;
+        result.meta = std::move(meta);
+    });
+    for (const auto& chunk : chunks) {
+        lexer.feed(chunk);
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("unit: json_streaming_lexer locates rows regardless of chunk boundaries", "[unit]")
+{
+    test::utils::init_logger();
+
+    // the rows are longer than the vector registers, and have brackets and escaped quotes inside the strings
+    std::string payload =
+      R"({"requestID":"2640a5b5-2e67-44e7-86ec-31cc388b7427","results": [ )"
+      R"({"name":"21st Amendment Brewery Cafe","text":"closing ]} and \"quoted\" [{ brackets \\","geo":{"lat":37.7825,"lon":-122.393}},)"
+      R"([["nested",["arrays"]],{"deeply":{"nested":{"object":"with a long enough value to span several vector registers"}}}],)"
+      R"("string \" row",-1.5e3 , true,null)"
+      R"(],"status":"success","metrics":{"resultCount":6}})";
+    const std::vector<std::string> expected_rows{
+        R"({"name":"21st Amendment Brewery Cafe","text":"closing ]} and \"quoted\" [{ brackets \\","geo":{"lat":37.7825,"lon":-122.393}})",
+        R"([["nested",["arrays"]],{"deeply":{"nested":{"object":"with a long enough value to span several vector registers"}}}])",
+        R"("string \" row")",
+        R"(-1.5e3)",
+        R"(true)",
+        R"(null)",
+    };
+    const std::string expected_meta =
+      R"({"requestID":"2640a5b5-2e67-44e7-86ec-31cc388b7427","results": [ )"
+      R"(],"status":"success","metrics":{"resultCount":6}})";
+
+    auto result = lex_query_result({ payload });
+    REQUIRE_SUCCESS(result.ec);
+    REQUIRE(result.number_of_rows == expected_rows.size());
+    REQUIRE(result.rows == expected_rows);
+    REQUIRE(result.meta == expected_meta);
+
+    for (std::size_t split = 1; split < payload.size(); ++split) {
+        INFO("split at " << split);
+        result = lex_query_result({ payload.substr(0, split), payload.substr(split) });
+        REQUIRE_SUCCESS(result.ec);
+        REQUIRE(result.rows == expected_rows);
+        REQUIRE(result.meta == expected_meta);
+    }
+
+    std::vector<std::string> bytes{};
+    for (char c : payload) {
+        bytes.emplace_back(1, c);
+    }
+    result = lex_query_result(bytes);
+    REQUIRE_SUCCESS(result.ec);
+    REQUIRE(result.rows == expected_rows);
+    REQUIRE(result.meta == expected_meta);
+}
+
+TEST_CASE("unit: json_streaming_lexer reports malformed rowset", "[unit]")
+{
+    test::utils::init_logger();
+
+    REQUIRE(lex_query_result({ R"({"results":[{"a":[1}],"status":"success"})" }).ec ==
+            couchbase::errc::streaming_json_lexer::bracket_mismatch);
+    REQUIRE(lex_query_result({ R"({"results":[1,],"status":"success"})" }).ec == couchbase::errc::streaming_json_lexer::trailing_comma);
+    REQUIRE(lex_query_result({ R"({"results":[1 2],"status":"success"})" }).ec == couchbase::errc::streaming_json_lexer::cannot_insert);
+    REQUIRE(lex_query_result({ R"({"results":[1,,2],"status":"success"})" }).ec == couchbase::errc::streaming_json_lexer::stray_token);
+    REQUIRE(lex_query_result({ R"({"results":[{"a":1}],"status":"success"]})" }).ec ==
+            couchbase::errc::streaming_json_lexer::bracket_mismatch);
+
+    // the tokens inside the rows are validated too, and the malformed rows are not emitted
+    auto result = lex_query_result({ R"({"results":[{"a":tru}],"status":"success"})" });
+    REQUIRE(result.ec == couchbase::errc::streaming_json_lexer::special_incomplete);
+    REQUIRE(result.rows.empty());
+    result = lex_query_result({ R"({"results":[{"a":1 "b":2},{"c":3}],"status":"success"})" });
+    REQUIRE(result.ec == couchbase::errc::streaming_json_lexer::stray_token);
+    REQUIRE(result.rows.empty());
+    result = lex_query_result({ R"({"results":[1,{"a":1.2.3}],"status":"success"})" });
+    REQUIRE(result.ec == couchbase::errc::streaming_json_lexer::invalid_number);
+    REQUIRE(result.rows == std::vector<std::string>{ "1" });
+}
@@ -19,9 +19,12 @@
 
 #include <catch2/catch_approx.hpp>
 
+#include "core/utils/binary.hxx"
+
 #include <couchbase/codec/default_json_transcoder.hxx>
 
 #include <tao/json.hpp>
+#include <tao/json/contrib/traits.hpp>
 
 using Catch::Approx;
 
@@ -214,3 +217,73 @@ TEST_CASE("unit: default_json_transcoder decodes user data", "[unit]")
     REQUIRE(value.at("full_name").get_string() == "Albert Einstein");
     REQUIRE(value.at("birth_year").get_unsigned() == 1879);
 }
+
+struct bound_profile {
+    std::string username{};
+    std::uint32_t birth_year{};
+};
+
+template<>
+struct tao::json::traits<bound_profile>
+  : tao::json::binding::object<TAO_JSON_BIND_REQUIRED("username", &bound_profile::username),
+                               TAO_JSON_BIND_REQUIRED("birth_year", &bound_profile::birth_year)> {
+};
+
+TEST_CASE("unit: default_json_transcoder streams user data with produce traits", "[unit]")
+{
+    std::vector<bound_profile> profiles{ { "this_guy_again", 1879 }, { "quote \" and \\ backslash", 1955 } };
+
+    auto encoded = couchbase::codec::default_json_transcoder::encode(profiles);
+    REQUIRE(encoded.data == couchbase::core::utils::to_binary(R"([{"username":"this_guy_again","birth_year":1879},)"
+                                                              R"({"username":"quote \" and \\ backslash","birth_year":1955}])"));
+
+    auto decoded = couchbase::codec::default_json_transcoder::decode<std::vector<bound_profile>>(encoded);
+    REQUIRE(decoded.size() == 2);
+    REQUIRE(decoded[1].username == "quote \" and \\ backslash");
+    REQUIRE(decoded[1].birth_year == 1955);
+
+    couchbase::codec::encoded_value truncated{ couchbase::core::utils::to_binary(R"([{"username":"truncated")"),
+                                               couchbase::codec::codec_flags::json_common_flags };
+    REQUIRE_THROWS_AS(couchbase::codec::default_json_transcoder::decode<std::vector<bound_profile>>(truncated), std::system_error);
+}
+
+TEST_CASE("unit: default_json_transcoder handles containers of user data without produce traits", "[unit]")
+{
+    std::vector<profile> profiles{ { "this_guy_again", "Albert Einstein", 1879 } };
+
+    auto encoded = couchbase::codec::default_json_transcoder::encode(profiles);
+    // the traits of profile build tao::json::value, which sorts the members
+    REQUIRE(encoded.data ==
+            couchbase::core::utils::to_binary(R"([{"birth_year":1879,"full_name":"Albert Einstein","username":"this_guy_again"}])"));
+
+    auto decoded = couchbase::codec::default_json_transcoder::decode<std::vector<profile>>(encoded);
+    REQUIRE(decoded.size() == 1);
+    REQUIRE(decoded[0].full_name == "Albert Einstein");
+}
+
+TEST_CASE("unit: default_json_transcoder keeps the last of duplicate keys in user data", "[unit]")
+{
+    couchbase::codec::encoded_value encoded{ couchbase::core::utils::to_binary(
+                                               R"([{"username":"first","birth_year":1879,"username":"last"}])"),
+                                             couchbase::codec::codec_flags::json_common_flags };
+    auto profiles = couchbase::codec::default_json_transcoder::decode<std::vector<bound_profile>>(encoded);
+    REQUIRE(profiles.size() == 1);
+    REQUIRE(profiles[0].username == "last");
+
+    encoded.data = couchbase::core::utils::to_binary(R"({"answer":1,"answer":42})");
+    auto numbers = couchbase::codec::default_json_transcoder::decode<std::map<std::string, int>>(encoded);
+    REQUIRE(numbers.size() == 1);
+    REQUIRE(numbers["answer"] == 42);
+}
+
+TEST_CASE("unit: default_json_transcoder converts nested numbers like tao::json::value", "[unit]")
+{
+    couchbase::codec::encoded_value encoded{ couchbase::core::utils::to_binary(R"([1, 2.0, 3])"),
+                                             couchbase::codec::codec_flags::json_common_flags };
+    REQUIRE(couchbase::codec::default_json_transcoder::decode<std::vector<int>>(encoded) == std::vector<int>{ 1, 2, 3 });
+
+    encoded.data = couchbase::core::utils::to_binary(R"([{"username":"this_guy_again","birth_year":1879.0}])");
+    auto profiles = couchbase::codec::default_json_transcoder::decode<std::vector<bound_profile>>(encoded);
+    REQUIRE(profiles.size() == 1);
+    REQUIRE(profiles[0].birth_year == 1879);
+}
@@ -0,0 +1,203 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_cluster_guard.hxx"
+#include "utils/mock_http_server.hxx"
+#include "utils/wait_until.hxx"
+
+#include "core/operations/document_analytics.hxx"
+#include "core/operations/document_query.hxx"
+#include "core/operations/document_search.hxx"
+#include "core/operations/management/search_index_get_all.hxx"
+
+#include <asio.hpp>
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
+
+TEST_CASE("unit: HTTP stand-in streams rows of query, analytics and search", "[unit]")
+{
+    test::utils::mock_http_server::response_options response{};
+    response.number_of_rows = 25;
+    response.row_size = 64;
+    response.rows_per_chunk = 4;
+    response.chunk_delay = std::chrono::milliseconds{ 1 };
+    test::utils::mock_http_server http(response);
+    test::utils::mock_mcbp_server::options server_options{};
+    server_options.services = http.services();
+    test::utils::mock_cluster_guard guard(server_options);
+
+    SECTION("query")
+    {
+        for (int i = 0; i < 5; ++i) {
+            couchbase::core::operations::query_request req{ "SELECT 1" };
+            auto resp = test::utils::execute(guard.cluster, req);
+            REQUIRE_SUCCESS(resp.ctx.ec);
+            REQUIRE(resp.rows.size() == 25);
+            REQUIRE(resp.rows[0].size() == 64);
+            REQUIRE(resp.meta.metrics.has_value());
+            REQUIRE(resp.meta.metrics->result_count == 25);
+        }
+        // the sessions go back to the pool
+        auto stats = http.statistics();
+        REQUIRE(stats.requests == 5);
+        REQUIRE(stats.connections < stats.requests);
+    }
+
+    SECTION("streaming query")
+    {
+        couchbase::core::operations::query_request req{ "SELECT 1" };
+        std::vector<std::string> rows{};
+        req.row_callback = [&rows](std::string&& row) {
+            rows.emplace_back(std::move(row));
+            return couchbase::core::utils::json::stream_control::next_row;
+        };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec);
+        REQUIRE(rows.size() == 25);
+    }
+
+    SECTION("analytics")
+    {
+        couchbase::core::operations::analytics_request req{};
+        req.statement = "SELECT 1";
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec);
+        REQUIRE(resp.rows.size() == 25);
+        REQUIRE(resp.meta.client_context_id == resp.ctx.client_context_id);
+    }
+
+    SECTION("search")
+    {
+        couchbase::core::operations::search_request req{};
+        req.index_name = "beers";
+        req.query = couchbase::core::json_string{ R"({"match_all":{}})" };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec);
+        REQUIRE(resp.rows.size() == 25);
+        REQUIRE(resp.rows[0].index == "beers");
+        REQUIRE(resp.meta.metrics.total_rows == 25);
+    }
+}
+
+TEST_CASE("unit: timeout of pipelined request does not fail the other requests on the session", "[unit]")
+{
+    test::utils::mock_http_server::response_options response{};
+    response.response_delay = std::chrono::milliseconds{ 200 };
+    test::utils::mock_http_server http(response);
+    test::utils::mock_mcbp_server::options server_options{};
+    server_options.services = http.services();
+    test::utils::mock_cluster_guard guard(server_options,
+                                          [](couchbase::core::cluster_options& options) { options.enable_http_pipelining = true; });
+
+    using couchbase::core::operations::management::search_index_get_all_request;
+    using couchbase::core::operations::management::search_index_get_all_response;
+    auto start_request = [&guard](std::chrono::milliseconds timeout) {
+        search_index_get_all_request req{};
+        req.timeout = timeout;
+        auto barrier = std::make_shared<std::promise<search_index_get_all_response>>();
+        auto f = barrier->get_future();
+        guard.cluster->execute(req, [barrier](search_index_get_all_response&& resp) { barrier->set_value(std::move(resp)); });
+        return f;
+    };
+
+    // the stand-in answers the pipelined requests one after another, so the second response is sent after 400ms
+    auto first = start_request(std::chrono::seconds{ 1 });
+    auto second = start_request(std::chrono::milliseconds{ 100 });
+    REQUIRE(second.get().ctx.ec == couchbase::errc::common::unambiguous_timeout);
+    auto first_resp = first.get();
+    REQUIRE_SUCCESS(first_resp.ctx.ec);
+    REQUIRE(first_resp.status == "ok");
+
+    // the response of the cancelled request is discarded, and the session is reused
+    auto third = start_request(std::chrono::seconds{ 1 }).get();
+    REQUIRE_SUCCESS(third.ctx.ec);
+    auto stats = http.statistics();
+    REQUIRE(stats.requests == 3);
+    REQUIRE(stats.connections == 1);
+}
+
+TEST_CASE("unit: idle HTTP sessions are warmed up and kept alive", "[unit]")
+{
+    test::utils::mock_http_server http;
+    test::utils::mock_mcbp_server::options server_options{};
+    server_options.services = http.services();
+    test::utils::mock_cluster_guard guard(server_options, [](couchbase::core::cluster_options& options) {
+        options.min_idle_http_connections = 2;
+        options.idle_http_connection_timeout = std::chrono::milliseconds{ 300 };
+    });
+
+    // two sessions for each of query, search and analytics, pinged as soon as they are open
+    REQUIRE(test::utils::wait_until(
+      [&http]() {
+          auto stats = http.statistics();
+          return stats.connections >= 6 && stats.pings >= 6;
+      },
+      std::chrono::seconds{ 5 },
+      std::chrono::milliseconds{ 10 }));
+
+    // the sessions are pinged every half of the idle timeout, so they outlive it, and are not replaced
+    REQUIRE(test::utils::wait_until(
+      [&http]() { return http.statistics().pings >= 18; }, std::chrono::seconds{ 5 }, std::chrono::milliseconds{ 10 }));
+    auto stats = http.statistics();
+    REQUIRE(stats.connections == 6);
+    REQUIRE(stats.requests == stats.pings);
+}
+
+TEST_CASE("unit: warm-up backs off from the node, which drops connections", "[unit]")
+{
+    // the service accepts connections and closes them immediately, so every no-op request fails
+    asio::io_context io;
+    asio::ip::tcp::acceptor acceptor(io, asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0));
+    std::atomic_size_t attempts{ 0 };
+    std::function<void()> do_accept = [&acceptor, &attempts, &do_accept]() {
+        acceptor.async_accept([&attempts, &do_accept](std::error_code ec, asio::ip::tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            ++attempts;
+            asio::error_code close_ec{};
+            socket.close(close_ec);
+            do_accept();
+        });
+    };
+    do_accept();
+    std::thread io_thread([&io]() { io.run(); });
+
+    {
+        test::utils::mock_mcbp_server::options server_options{};
+        server_options.services = { { "n1ql", acceptor.local_endpoint().port() } };
+        test::utils::mock_cluster_guard guard(
+          server_options, [](couchbase::core::cluster_options& options) { options.min_idle_http_connections = 1; });
+
+        REQUIRE(test::utils::wait_until(
+          [&attempts]() { return attempts > 0; }, std::chrono::seconds{ 5 }, std::chrono::milliseconds{ 10 }));
+        std::this_thread::sleep_for(std::chrono::seconds{ 1 });
+        // the retries are 100ms, 200ms, 400ms... apart, without the backoff the session would be reconnected in a loop
+        REQUIRE(attempts < 10);
+    }
+
+    asio::post(io, [&acceptor]() {
+        asio::error_code ec{};
+        acceptor.close(ec);
+    });
+    io_thread.join();
+}
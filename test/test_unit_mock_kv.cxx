@@ -0,0 +1,170 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "utils/mock_cluster_guard.hxx"
+
+#include "core/operations/document_get.hxx"
+#include "core/operations/document_lookup_in.hxx"
+#include "core/operations/document_mutate_in.hxx"
+#include "core/operations/document_remove.hxx"
+#include "core/operations/document_upsert.hxx"
+#include "core/utils/binary.hxx"
+
+#include <couchbase/cluster.hxx>
+#include <couchbase/error_codes.hxx>
+#include <couchbase/lookup_in_specs.hxx>
+#include <couchbase/mutate_in_specs.hxx>
+
+#include <tao/json.hpp>
+
+#include <future>
+#include <string>
+#include <vector>
+
+TEST_CASE("unit: KV stand-in executes basic operations", "[unit]")
+{
+    test::utils::mock_cluster_guard guard;
+    couchbase::core::document_id id{ guard.bucket_name(), "_default", "_default", "foo" };
+
+    {
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary(R"({"a":1})") };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE_FALSE(resp.cas.empty());
+    }
+
+    {
+        couchbase::core::operations::mutate_in_request req{ id };
+        req.specs = couchbase::mutate_in_specs{ couchbase::mutate_in_specs::upsert("b.c", 2).create_path() }.specs();
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    {
+        couchbase::core::operations::lookup_in_request req{ id };
+        req.specs =
+          couchbase::lookup_in_specs{ couchbase::lookup_in_specs::get("b.c"), couchbase::lookup_in_specs::exists("missing") }.specs();
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(resp.fields.size() == 2);
+        REQUIRE(resp.fields[0].exists);
+        REQUIRE(couchbase::core::utils::to_binary("2") == resp.fields[0].value);
+        REQUIRE_FALSE(resp.fields[1].exists);
+    }
+
+    {
+        couchbase::core::operations::remove_request req{ id };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    {
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE(resp.ctx.ec() == couchbase::errc::key_value::document_not_found);
+    }
+}
+
+TEST_CASE("unit: KV stand-in injects errors", "[unit]")
+{
+    test::utils::mock_cluster_guard guard;
+    couchbase::core::document_id id{ guard.bucket_name(), "_default", "_default", "foo" };
+
+    {
+        couchbase::core::operations::upsert_request req{ id, couchbase::core::utils::to_binary(R"({"a":1})") };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+    }
+
+    SECTION("temporary failure is retried")
+    {
+        guard.server.inject_error(couchbase::core::protocol::client_opcode::get, couchbase::key_value_status_code::temporary_failure, 2);
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE_SUCCESS(resp.ctx.ec());
+        REQUIRE(resp.ctx.retry_attempts() > 0);
+        REQUIRE(guard.server.requests_received(couchbase::core::protocol::client_opcode::get) == 3);
+    }
+
+    SECTION("error which is not retried")
+    {
+        guard.server.inject_error(couchbase::core::protocol::client_opcode::get, couchbase::key_value_status_code::not_found);
+        couchbase::core::operations::get_request req{ id };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE(resp.ctx.ec() == couchbase::errc::key_value::document_not_found);
+    }
+
+    SECTION("delay causes timeout")
+    {
+        guard.server.inject_delay(couchbase::core::protocol::client_opcode::get, std::chrono::milliseconds{ 500 });
+        couchbase::core::operations::get_request req{ id };
+        req.timeout = std::chrono::milliseconds{ 100 };
+        auto resp = test::utils::execute(guard.cluster, req);
+        REQUIRE(resp.ctx.ec() == couchbase::errc::common::unambiguous_timeout);
+    }
+}
+
+TEST_CASE("unit: legacy durability completes soon after the mutation is persisted", "[unit]")
+{
+    test::utils::mock_mcbp_server::options server_options{};
+    server_options.number_of_replicas = 1;
+    server_options.persistence_delay = std::chrono::milliseconds{ 20 };
+    test::utils::mock_cluster_guard guard(server_options);
+    auto collection = couchbase::cluster(guard.cluster).bucket(guard.bucket_name()).default_collection();
+
+    auto start = std::chrono::steady_clock::now();
+    auto [ctx, result] = collection.upsert("foo",
+                                           tao::json::value{ { "a", 1 } },
+                                           couchbase::upsert_options{}.durability(couchbase::persist_to::one, couchbase::replicate_to::one),
+                                           couchbase::use_blocking);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE_SUCCESS(ctx.ec());
+    REQUIRE_FALSE(result.cas().empty());
+
+    // the first rounds of observe_seqno see the mutation neither persisted nor replicated, but the polling must not wait for
+    // long between the rounds
+    REQUIRE(guard.server.requests_received(couchbase::core::protocol::client_opcode::observe_seqno) > 2);
+    REQUIRE(elapsed < std::chrono::milliseconds{ 250 });
+}
+
+TEST_CASE("unit: legacy durability observes concurrent mutations of the same vbucket together", "[unit]")
+{
+    test::utils::mock_mcbp_server::options server_options{};
+    server_options.number_of_replicas = 1;
+    server_options.number_of_vbuckets = 4;
+    server_options.persistence_delay = std::chrono::milliseconds{ 20 };
+    test::utils::mock_cluster_guard guard(server_options);
+    auto collection = couchbase::cluster(guard.cluster).bucket(guard.bucket_name()).default_collection();
+
+    constexpr std::size_t number_of_mutations = 200;
+    auto options = couchbase::upsert_options{}.durability(couchbase::persist_to::one, couchbase::replicate_to::one);
+    std::vector<std::future<std::pair<couchbase::key_value_error_context, couchbase::mutation_result>>> futures{};
+    futures.reserve(number_of_mutations);
+    for (std::size_t i = 0; i < number_of_mutations; ++i) {
+        futures.emplace_back(collection.upsert("foo-" + std::to_string(i), tao::json::value{ { "a", i } }, options));
+    }
+    for (auto& future : futures) {
+        auto [ctx, result] = future.get();
+        REQUIRE_SUCCESS(ctx.ec());
+    }
+
+    // every mutation needs at least two rounds against the active node and the replica, when polled on its own, but the
+    // shared rounds send at most one request per vbucket and node
+    REQUIRE(guard.server.requests_received(couchbase::core::protocol::client_opcode::observe_seqno) < number_of_mutations);
+}
@@ -55,3 +55,51 @@ TEST_CASE("unit: query options can encode named parameters automatically", "[uni
     REQUIRE(options.named_parameters["user_param"] ==
             couchbase::core::utils::to_binary("{\"birth_year\":1970,\"full_name\":\"John Doe\",\"username\":\"john\"}"));
 }
+
+TEST_CASE("unit: mutation state keeps the highest sequence number for every partition", "[unit]")
+{
+    couchbase::mutation_state state{};
+    for (std::uint64_t sequence_number = 1; sequence_number <= 10'000; ++sequence_number) {
+        auto partition_id = static_cast<std::uint16_t>(sequence_number % 4);
+        state.add(couchbase::mutation_result{ couchbase::cas{ sequence_number },
+                                              couchbase::mutation_token{ 42, sequence_number, partition_id, "travel-sample" } });
+    }
+    state.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 43, 5, 1, "beer-sample" } });
+    state.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 42, 5, 1, "travel-sample" } });
+
+    const auto& tokens = state.tokens();
+    REQUIRE(tokens.size() == 5);
+    REQUIRE(tokens[0].bucket_name() == "beer-sample");
+    REQUIRE(tokens[0].partition_id() == 1);
+    for (std::uint16_t partition_id = 0; partition_id < 4; ++partition_id) {
+        const auto& token = tokens[1 + partition_id];
+        REQUIRE(token.bucket_name() == "travel-sample");
+        REQUIRE(token.partition_id() == partition_id);
+        REQUIRE(token.sequence_number() == 9'996U + (partition_id == 0 ? 4U : partition_id));
+    }
+}
+
+TEST_CASE("unit: mutation states can be merged", "[unit]")
+{
+    couchbase::mutation_state first{};
+    first.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 42, 10, 1, "travel-sample" } });
+    first.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 42, 20, 2, "travel-sample" } });
+
+    couchbase::mutation_state second{};
+    second.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 42, 15, 1, "travel-sample" } });
+    second.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 42, 5, 2, "travel-sample" } });
+    second.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 42, 7, 3, "travel-sample" } });
+    second.add(couchbase::mutation_result{ couchbase::cas{ 1 }, couchbase::mutation_token{ 43, 1, 0, "beer-sample" } });
+
+    first.add(second);
+    const auto& tokens = first.tokens();
+    REQUIRE(tokens.size() == 4);
+    REQUIRE(tokens[0].bucket_name() == "beer-sample");
+    REQUIRE(tokens[1].sequence_number() == 15);
+    REQUIRE(tokens[2].sequence_number() == 20);
+    REQUIRE(tokens[3].sequence_number() == 7);
+
+    couchbase::mutation_state empty{};
+    empty.add(first);
+    REQUIRE(empty.tokens().size() == 4);
+}
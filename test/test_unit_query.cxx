@@ -20,6 +20,11 @@
 #include "utils/move_only_context.hxx"
 
 #include "core/operations/document_query.hxx"
+#include "core/utils/json.hxx"
+
+#include <couchbase/mutation_state.hxx>
+
+#include <tao/json.hpp>
 
 couchbase::core::http_context
 make_http_context(couchbase::core::topology::configuration& config)
@@ -73,3 +78,174 @@ TEST_CASE("unit: query with read from replica", "[unit]")
         REQUIRE_FALSE(body.get_object().count("use_replica"));
     }
 }
+
+TEST_CASE("unit: query with at_plus consistency", "[unit]")
+{
+    couchbase::core::topology::configuration config{};
+    auto ctx = make_http_context(config);
+
+    couchbase::mutation_state state{};
+    for (std::uint64_t sequence_number = 1; sequence_number <= 4096; ++sequence_number) {
+        state.add(couchbase::mutation_result{
+          couchbase::cas{ sequence_number },
+          couchbase::mutation_token{ 42, sequence_number, static_cast<std::uint16_t>(sequence_number % 1024), "travel-sample" } });
+    }
+    REQUIRE(state.tokens().size() == 1024);
+
+    couchbase::core::io::http_request http_req;
+    couchbase::core::operations::query_request req{};
+    req.mutation_state = state.tokens();
+    auto ec = req.encode_to(http_req, ctx);
+    REQUIRE_SUCCESS(ec);
+    auto body = couchbase::core::utils::json::parse(http_req.body);
+    REQUIRE(body.at("scan_consistency").get_string() == "at_plus");
+    const auto& vectors = body.at("scan_vectors").at("travel-sample").get_object();
+    REQUIRE(vectors.size() == 1024);
+    REQUIRE(vectors.at("0").get_array().at(0).get_unsigned() == 4096);
+    REQUIRE(vectors.at("1").get_array().at(0).get_unsigned() == 3073);
+    REQUIRE(vectors.at("1").get_array().at(1).get_string() == "42");
+}
+
+TEST_CASE("unit: query with body template", "[unit]")
+{
+    couchbase::core::topology::configuration config{};
+    config.cluster_capabilities.insert(couchbase::core::cluster_capability::n1ql_read_from_replica);
+    auto ctx = make_http_context(config);
+
+    auto make_request = [](std::string parameter) {
+        couchbase::core::operations::query_request req{ "SELECT * FROM `travel-sample` WHERE type = $1" };
+        req.use_replica = true;
+        req.readonly = true;
+        req.profile = couchbase::query_profile::timings;
+        req.scan_consistency = couchbase::query_scan_consistency::request_plus;
+        req.scan_wait = std::chrono::milliseconds{ 100 };
+        req.query_context = "default:`travel-sample`.`inventory`";
+        req.raw["numatrs"] = couchbase::core::json_string{ "1" };
+        req.positional_parameters.emplace_back(couchbase::core::utils::json::generate(tao::json::value{ std::move(parameter) }));
+        return req;
+    };
+    auto encode = [&ctx](couchbase::core::operations::query_request& req) {
+        couchbase::core::io::http_request http_req;
+        http_req.client_context_id = "42";
+        http_req.timeout = std::chrono::milliseconds{ 2'000 };
+        auto ec = req.encode_to(http_req, ctx);
+        REQUIRE_SUCCESS(ec);
+        return couchbase::core::utils::json::parse(http_req.body);
+    };
+
+    auto body_template = std::make_shared<couchbase::core::operations::query_body_template>();
+    for (const auto* parameter : { "airline", "hotel", "route" }) {
+        auto expected_req = make_request(parameter);
+        auto expected = encode(expected_req);
+
+        auto req = make_request(parameter);
+        req.body_template = body_template;
+        REQUIRE(encode(req) == expected);
+        REQUIRE(expected.at("args").get_array().at(0).get_string() == parameter);
+    }
+
+    SECTION("another statement does not use the template")
+    {
+        couchbase::core::operations::query_request req{ "SELECT 1" };
+        req.body_template = body_template;
+        auto body = encode(req);
+        REQUIRE(body.at("statement").get_string() == "SELECT 1");
+        REQUIRE_FALSE(body.get_object().count("query_context"));
+        REQUIRE_FALSE(body.get_object().count("profile"));
+    }
+
+    SECTION("same statement with other options does not use the cached options")
+    {
+        auto expected_req = make_request("airline");
+        expected_req.profile = couchbase::query_profile::phases;
+        expected_req.readonly = false;
+        expected_req.query_context = "default:`travel-sample`.`tenant_agent_00`";
+        auto expected = encode(expected_req);
+
+        auto req = make_request("airline");
+        req.profile = couchbase::query_profile::phases;
+        req.readonly = false;
+        req.query_context = "default:`travel-sample`.`tenant_agent_00`";
+        req.body_template = body_template;
+        auto body = encode(req);
+        REQUIRE(body == expected);
+        REQUIRE(body.at("profile").get_string() == "phases");
+        REQUIRE_FALSE(body.get_object().count("readonly"));
+
+        auto first = make_request("airline");
+        first.body_template = body_template;
+        REQUIRE(encode(first) != body);
+    }
+
+    SECTION("scan consistency is encoded for every request")
+    {
+        auto req = make_request("airline");
+        req.scan_consistency.reset();
+        req.mutation_state = { couchbase::mutation_token{ 42, 1, 115, "travel-sample" } };
+        req.body_template = body_template;
+        couchbase::core::io::http_request http_req;
+        http_req.client_context_id = "42";
+        REQUIRE_SUCCESS(req.encode_to(http_req, ctx));
+        REQUIRE(http_req.body.find(R"("scan_consistency")") == http_req.body.rfind(R"("scan_consistency")"));
+        auto body = couchbase::core::utils::json::parse(http_req.body);
+        REQUIRE(body.at("scan_consistency").get_string() == "at_plus");
+        REQUIRE_FALSE(body.get_object().count("scan_wait"));
+        REQUIRE(body.at("profile").get_string() == "timings");
+    }
+
+    SECTION("support of read from replica is checked for every request")
+    {
+        couchbase::core::topology::configuration old_config{};
+        auto old_ctx = make_http_context(old_config);
+        auto req = make_request("airline");
+        req.body_template = body_template;
+        couchbase::core::io::http_request http_req;
+        REQUIRE(req.encode_to(http_req, old_ctx) == couchbase::errc::common::feature_not_available);
+    }
+
+    SECTION("raw option that overrides parameters disables the template")
+    {
+        auto other_template = std::make_shared<couchbase::core::operations::query_body_template>();
+        for (const auto* timeout : { "10s", "20s" }) {
+            auto req = make_request("airline");
+            req.raw["timeout"] = couchbase::core::json_string{ couchbase::core::utils::json::generate(tao::json::value{ timeout }) };
+            req.body_template = other_template;
+            auto body = encode(req);
+            REQUIRE(body.at("timeout").get_string() == timeout);
+            REQUIRE(body.at("profile").get_string() == "timings");
+        }
+    }
+}
+
+TEST_CASE("unit: query cache evicts least recently used statements", "[unit]")
+{
+    couchbase::core::query_cache cache{ couchbase::core::query_cache::number_of_shards };
+
+    // with one entry per shard, a statement is evicted by any newer statement that lands in the same shard
+    cache.put("SELECT 1", "p1");
+    REQUIRE(cache.get("SELECT 1").has_value());
+    for (int i = 0; i < 100; ++i) {
+        cache.put("SELECT " + std::to_string(i + 2), "p" + std::to_string(i + 2));
+    }
+    auto stats = cache.statistics();
+    REQUIRE(stats.size <= couchbase::core::query_cache::number_of_shards);
+    REQUIRE(stats.evictions == 101 - stats.size);
+
+    // the most recent statement always survives
+    auto entry = cache.get("SELECT 101");
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->name == "p101");
+    REQUIRE_FALSE(entry->plan.has_value());
+
+    cache.erase("SELECT 101");
+    REQUIRE_FALSE(cache.get("SELECT 101").has_value());
+
+    stats = cache.statistics();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.hit_ratio() > 0.6);
+
+    cache.put("SELECT 1", "p1", "plan");
+    cache.clear();
+    REQUIRE(cache.statistics().size == 0);
+}
@@ -0,0 +1,176 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/platform/uuid.h"
+
+#include "core/io/streams.hxx"
+#include "core/io/tls_session_cache.hxx"
+
+#include <asio.hpp>
+#include <asio/ssl.hpp>
+
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <future>
+#include <thread>
+
+namespace
+{
+// self-signed certificate of the TLS server stand-in
+class test_certificate
+{
+  public:
+    test_certificate()
+    {
+        EVP_PKEY_CTX* key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        EVP_PKEY_keygen_init(key_ctx);
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1);
+        EVP_PKEY_keygen(key_ctx, &key_);
+        EVP_PKEY_CTX_free(key_ctx);
+
+        certificate_ = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(certificate_), 1);
+        X509_gmtime_adj(X509_getm_notBefore(certificate_), 0);
+        X509_gmtime_adj(X509_getm_notAfter(certificate_), 3600);
+        X509_set_pubkey(certificate_, key_);
+        X509_NAME* name = X509_get_subject_name(certificate_);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(certificate_, name);
+        X509_sign(certificate_, key_, EVP_sha256());
+    }
+
+    test_certificate(const test_certificate&) = delete;
+    test_certificate& operator=(const test_certificate&) = delete;
+
+    ~test_certificate()
+    {
+        X509_free(certificate_);
+        EVP_PKEY_free(key_);
+    }
+
+    void use_in(asio::ssl::context& tls) const
+    {
+        SSL_CTX_use_certificate(tls.native_handle(), certificate_);
+        SSL_CTX_use_PrivateKey(tls.native_handle(), key_);
+    }
+
+  private:
+    EVP_PKEY* key_{ nullptr };
+    X509* certificate_{ nullptr };
+};
+
+// accepts TLS connections on the loopback interface, and sends a single byte after the handshake
+class tls_server
+{
+  public:
+    tls_server(asio::io_context& ctx, const test_certificate& certificate)
+      : acceptor_(ctx, asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0))
+    {
+        certificate.use_in(tls_);
+        do_accept();
+    }
+
+    [[nodiscard]] asio::ip::tcp::endpoint endpoint() const
+    {
+        return acceptor_.local_endpoint();
+    }
+
+    void stop()
+    {
+        asio::error_code ec{};
+        acceptor_.close(ec);
+    }
+
+  private:
+    void do_accept()
+    {
+        acceptor_.async_accept([this](std::error_code ec, asio::ip::tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            auto stream = std::make_shared<asio::ssl::stream<asio::ip::tcp::socket>>(std::move(socket), tls_);
+            stream->async_handshake(asio::ssl::stream_base::server, [stream](std::error_code ec_handshake) {
+                if (ec_handshake) {
+                    return;
+                }
+                static const char greeting{ '!' };
+                asio::async_write(*stream, asio::buffer(&greeting, 1), [stream](std::error_code /* ec */, std::size_t /* bytes */) {});
+            });
+            do_accept();
+        });
+    }
+
+    asio::ssl::context tls_{ asio::ssl::context::tls_server };
+    asio::ip::tcp::acceptor acceptor_;
+};
+
+void
+connect_and_read_greeting(asio::io_context& ctx, asio::ssl::context& tls, const asio::ip::tcp::endpoint& endpoint)
+{
+    couchbase::core::io::tls_stream_impl stream(ctx, tls);
+
+    std::promise<std::error_code> connected;
+    stream.async_connect(endpoint, [&connected](std::error_code ec) { connected.set_value(ec); });
+    REQUIRE_FALSE(connected.get_future().get());
+
+    // TLS 1.3 tickets are delivered after the handshake, so read something to receive them
+    char greeting{};
+    std::promise<std::error_code> received;
+    stream.async_read_some(asio::buffer(&greeting, 1),
+                           [&received](std::error_code ec, std::size_t /* bytes */) { received.set_value(ec); });
+    REQUIRE_FALSE(received.get_future().get());
+    REQUIRE(greeting == '!');
+
+    std::promise<void> closed;
+    stream.close([&closed](std::error_code /* ec */) { closed.set_value(); });
+    closed.get_future().get();
+}
+} // namespace
+
+TEST_CASE("unit: tls session cache resumes sessions with the same peer", "[unit]")
+{
+    asio::io_context io;
+    auto guard = asio::make_work_guard(io);
+    test_certificate certificate;
+    tls_server server(io, certificate);
+    std::thread io_thread([&io]() { io.run(); });
+
+    asio::ssl::context tls{ asio::ssl::context::tls_client };
+    tls.set_verify_mode(asio::ssl::verify_none);
+    couchbase::core::io::tls_session_cache cache;
+    cache.attach(tls.native_handle());
+
+    connect_and_read_greeting(io, tls, server.endpoint());
+    auto stats = cache.statistics();
+    CHECK(stats.hits == 0);
+    CHECK(stats.misses == 1);
+    CHECK(stats.size == 1);
+
+    connect_and_read_greeting(io, tls, server.endpoint());
+    stats = cache.statistics();
+    CHECK(stats.hits == 1);
+    CHECK(stats.misses == 1);
+    CHECK(stats.size == 1);
+
+    asio::post(io, [&server]() { server.stop(); });
+    guard.reset();
+    io_thread.join();
+}
@@ -0,0 +1,136 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "test_helper.hxx"
+
+#include "core/tracing/constants.hxx"
+#include "core/tracing/threshold_logging_span.hxx"
+#include "core/tracing/threshold_logging_tracer.hxx"
+
+#include <asio/io_context.hpp>
+
+namespace
+{
+std::shared_ptr<couchbase::core::tracing::threshold_logging_span>
+start_span(const std::shared_ptr<couchbase::core::tracing::threshold_logging_tracer>& tracer, std::string name)
+{
+    auto span = std::dynamic_pointer_cast<couchbase::core::tracing::threshold_logging_span>(tracer->start_span(std::move(name), {}));
+    REQUIRE(span);
+    return span;
+}
+} // namespace
+
+TEST_CASE("unit: threshold logging span knows the service of the command from its name", "[unit]")
+{
+    using couchbase::core::service_type;
+    namespace tracing = couchbase::core::tracing;
+
+    asio::io_context io;
+    auto tracer = std::make_shared<tracing::threshold_logging_tracer>(io, tracing::threshold_logging_options{});
+
+    REQUIRE(start_span(tracer, tracing::operation::mcbp_get)->service() == service_type::key_value);
+    REQUIRE(start_span(tracer, tracing::operation::mcbp_mutate_in)->is_key_value());
+    REQUIRE(start_span(tracer, tracing::operation::http_query)->service() == service_type::query);
+    REQUIRE(start_span(tracer, tracing::operation::http_analytics)->service() == service_type::analytics);
+    REQUIRE(start_span(tracer, tracing::operation::http_search)->service() == service_type::search);
+    REQUIRE(start_span(tracer, tracing::operation::http_views)->service() == service_type::view);
+    REQUIRE(start_span(tracer, tracing::operation::http_manager)->service() == service_type::management);
+    REQUIRE(start_span(tracer, tracing::operation::http_manager_buckets)->service() == service_type::management);
+
+    SECTION("the service tag does not override the service of the command")
+    {
+        auto span = start_span(tracer, tracing::operation::mcbp_get);
+        span->add_tag(tracing::attributes::service, tracing::service::query);
+        REQUIRE(span->service() == service_type::key_value);
+    }
+
+    SECTION("the service tag is used for other spans")
+    {
+        auto span = start_span(tracer, "custom");
+        REQUIRE_FALSE(span->service().has_value());
+        span->add_tag(tracing::attributes::service, tracing::service::search);
+        REQUIRE(span->service() == service_type::search);
+    }
+}
+
+TEST_CASE("unit: threshold logging span keeps reported attributes in slots", "[unit]")
+{
+    namespace tracing = couchbase::core::tracing;
+
+    asio::io_context io;
+    auto tracer = std::make_shared<tracing::threshold_logging_tracer>(io, tracing::threshold_logging_options{});
+    auto span = start_span(tracer, tracing::operation::mcbp_upsert);
+
+    SECTION("operation identifier of KV command is stored as a number")
+    {
+        span->add_tag(tracing::attributes::operation_id, std::uint64_t{ 42 });
+        REQUIRE(span->numeric_operation_id() == 42);
+        REQUIRE(span->attribute(tracing::span_attribute::operation_id).empty());
+
+        span->add_tag(tracing::attributes::operation_id, std::uint64_t{ 43 });
+        REQUIRE(span->numeric_operation_id() == 42);
+        span->add_tag(tracing::attributes::operation_id, "0x2b");
+        REQUIRE(span->attribute(tracing::span_attribute::operation_id).empty());
+    }
+
+    SECTION("other operation identifiers are stored as strings")
+    {
+        span->add_tag(tracing::attributes::operation_id, "query-context-id");
+        REQUIRE_FALSE(span->numeric_operation_id().has_value());
+        REQUIRE(span->attribute(tracing::span_attribute::operation_id) == "query-context-id");
+
+        span->add_tag(tracing::attributes::operation_id, std::uint64_t{ 42 });
+        REQUIRE_FALSE(span->numeric_operation_id().has_value());
+        REQUIRE(span->attribute(tracing::span_attribute::operation_id) == "query-context-id");
+    }
+
+    SECTION("the first value of the attribute wins")
+    {
+        span->add_tag(tracing::attributes::local_id, "first-local-id");
+        span->add_tag(tracing::attributes::local_id, "second-local-id");
+        span->add_tag(tracing::attributes::local_socket, "127.0.0.1:51234");
+        span->add_tag(tracing::attributes::remote_socket, "127.0.0.1:11210");
+        REQUIRE(span->attribute(tracing::span_attribute::local_id) == "first-local-id");
+        REQUIRE(span->attribute(tracing::span_attribute::local_socket) == "127.0.0.1:51234");
+        REQUIRE(span->attribute(tracing::span_attribute::remote_socket) == "127.0.0.1:11210");
+    }
+
+    SECTION("server durations are accumulated")
+    {
+        span->add_tag(tracing::attributes::server_duration, std::uint64_t{ 10 });
+        span->add_tag(tracing::attributes::server_duration, std::uint64_t{ 32 });
+        REQUIRE(span->last_server_duration_us() == 32);
+        REQUIRE(span->total_server_duration_us() == 42);
+    }
+
+    SECTION("orphan marker and unknown tags")
+    {
+        span->add_tag(tracing::attributes::system, "couchbase");
+        REQUIRE_FALSE(span->orphan());
+        span->add_tag(tracing::attributes::orphan, "aggregate");
+        REQUIRE(span->orphan());
+        for (auto attribute : { tracing::span_attribute::operation_id,
+                                tracing::span_attribute::local_id,
+                                tracing::span_attribute::local_socket,
+                                tracing::span_attribute::remote_socket }) {
+            REQUIRE(span->attribute(attribute).empty());
+        }
+    }
+
+    span->end();
+    REQUIRE(span->duration() >= std::chrono::microseconds::zero());
+}
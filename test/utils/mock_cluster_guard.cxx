@@ -0,0 +1,51 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "mock_cluster_guard.hxx"
+#include "logger.hxx"
+
+namespace test::utils
+{
+mock_cluster_guard::mock_cluster_guard()
+  : mock_cluster_guard(mock_mcbp_server::options{})
+{
+}
+
+mock_cluster_guard::mock_cluster_guard(mock_mcbp_server::options server_options)
+  : mock_cluster_guard(std::move(server_options), [](couchbase::core::cluster_options& /* options */) {})
+{
+}
+
+mock_cluster_guard::mock_cluster_guard(mock_mcbp_server::options server_options,
+                                       const std::function<void(couchbase::core::cluster_options&)>& configure)
+  : server(std::move(server_options))
+  , cluster(couchbase::core::cluster::create(io))
+{
+    init_logger();
+    io_thread_ = std::thread([this]() { io.run(); });
+    auto origin = server.origin();
+    configure(origin.options());
+    open_cluster(cluster, origin);
+    open_bucket(cluster, server.server_options().bucket_name);
+}
+
+mock_cluster_guard::~mock_cluster_guard()
+{
+    close_cluster(cluster);
+    io_thread_.join();
+}
+} // namespace test::utils
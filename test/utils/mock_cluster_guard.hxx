@@ -0,0 +1,58 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "integration_shortcuts.hxx"
+#include "mock_mcbp_server.hxx"
+
+#include <asio/io_context.hpp>
+
+#include <functional>
+#include <thread>
+
+namespace test::utils
+{
+/**
+ * Cluster connected to the KV stand-in, with the bucket of the stand-in open.
+ */
+class mock_cluster_guard
+{
+  public:
+    mock_cluster_guard();
+    explicit mock_cluster_guard(mock_mcbp_server::options server_options);
+    /**
+     * @param configure adjusts the options parsed from the connection string of the stand-in
+     */
+    mock_cluster_guard(mock_mcbp_server::options server_options, const std::function<void(couchbase::core::cluster_options&)>& configure);
+    mock_cluster_guard(const mock_cluster_guard&) = delete;
+    mock_cluster_guard& operator=(const mock_cluster_guard&) = delete;
+    ~mock_cluster_guard();
+
+    [[nodiscard]] const std::string& bucket_name() const
+    {
+        return server.server_options().bucket_name;
+    }
+
+    mock_mcbp_server server;
+    asio::io_context io{};
+    std::shared_ptr<couchbase::core::cluster> cluster;
+
+  private:
+    std::thread io_thread_{};
+};
+} // namespace test::utils
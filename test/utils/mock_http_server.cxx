@@ -0,0 +1,442 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "mock_http_server.hxx"
+
+#include <asio.hpp>
+#include <fmt/core.h>
+#include <tao/json.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace test::utils
+{
+namespace
+{
+struct http_request {
+    std::string method{};
+    std::string path{};
+    std::string body{};
+};
+
+// the parts of the response body around the rows
+struct response_layout {
+    std::string prefix{};
+    std::string suffix{};
+    bool search{ false };
+};
+
+std::string
+client_context_id_of(const std::string& body)
+{
+    try {
+        auto payload = tao::json::from_string(body);
+        if (const auto* id = payload.find("client_context_id"); id != nullptr && id->is_string()) {
+            return id->get_string();
+        }
+    } catch (const tao::pegtl::parse_error&) {
+        // the identifier is optional
+    }
+    return {};
+}
+
+response_layout
+query_layout(const http_request& request, std::size_t number_of_rows, std::size_t result_size)
+{
+    tao::json::value client_context_id = client_context_id_of(request.body);
+    return {
+        fmt::format(R"({{"requestID":"00000000-0000-0000-0000-000000000000","clientContextID":{},"signature":{{"*":"*"}},"results":[)",
+                    tao::json::to_string(client_context_id)),
+        fmt::format(R"(],"status":"success","metrics":{{"elapsedTime":"1ms","executionTime":"1ms","resultCount":{},)"
+                    R"("resultSize":{},"processedObjects":{}}}}})",
+                    number_of_rows,
+                    result_size,
+                    number_of_rows),
+    };
+}
+
+response_layout
+search_layout(std::size_t number_of_rows)
+{
+    return {
+        R"({"status":{"total":1,"failed":0,"successful":1},"request":{},"hits":[)",
+        fmt::format(R"(],"total_hits":{},"max_score":1.0,"took":1000000,"facets":{{}}}})", number_of_rows),
+        true,
+    };
+}
+
+std::string
+make_row(const response_layout& layout, const std::string& index_name, std::size_t index, std::size_t row_size)
+{
+    auto id = fmt::format("row-{:08}", index);
+    std::string row{};
+    if (layout.search) {
+        row = fmt::format(
+          R"({{"index":{},"id":"{}","score":1.0,"fields":{{"payload":")", tao::json::to_string(tao::json::value(index_name)), id);
+    } else {
+        row = fmt::format(R"({{"id":"{}","payload":")", id);
+    }
+    const std::size_t closing_size = layout.search ? 3 : 2;
+    if (row.size() + closing_size < row_size) {
+        row.append(row_size - row.size() - closing_size, 'x');
+    }
+    row.append(layout.search ? "\"}}" : "\"}");
+    return row;
+}
+
+// bodies of the GET endpoints, which are answered in one piece
+std::optional<std::string>
+static_response_body(const std::string& path)
+{
+    if (path == "/admin/ping" || path == "/api/ping") {
+        return std::string{};
+    }
+    if (path == "/api/index") {
+        return R"({"status":"ok","indexDefs":{"implVersion":"5.5.0","indexDefs":{}}})";
+    }
+    return {};
+}
+
+bool
+is_ping(const http_request& request)
+{
+    return request.method == "GET" && (request.path == "/admin/ping" || request.path == "/api/ping");
+}
+
+std::string
+chunk(const std::string& data)
+{
+    return fmt::format("{:x}\r\n{}\r\n", data.size(), data);
+}
+} // namespace
+
+class mock_http_server::impl : public std::enable_shared_from_this<mock_http_server::impl>
+{
+  public:
+    explicit impl(mock_http_server::response_options options)
+      : options_(options)
+    {
+    }
+
+    void start()
+    {
+        do_accept();
+        io_thread_ = std::thread([self = shared_from_this()]() { self->ctx_.run(); });
+    }
+
+    void stop()
+    {
+        if (!io_thread_.joinable()) {
+            return;
+        }
+        asio::post(ctx_, [self = shared_from_this()]() {
+            asio::error_code ec{};
+            self->acceptor_.close(ec);
+            for (const auto& weak_connection : self->connections_) {
+                if (auto conn = weak_connection.lock(); conn) {
+                    conn->close();
+                }
+            }
+            self->connections_.clear();
+        });
+        guard_.reset();
+        io_thread_.join();
+    }
+
+    [[nodiscard]] std::uint16_t port() const
+    {
+        return port_;
+    }
+
+    void set_response_options(mock_http_server::response_options options)
+    {
+        std::scoped_lock lock(mutex_);
+        options_ = options;
+    }
+
+    [[nodiscard]] mock_http_server::stats statistics() const
+    {
+        std::scoped_lock lock(mutex_);
+        return stats_;
+    }
+
+  private:
+    class connection : public std::enable_shared_from_this<connection>
+    {
+      public:
+        connection(std::shared_ptr<impl> server, asio::ip::tcp::socket socket)
+          : server_(std::move(server))
+          , socket_(std::move(socket))
+          , timer_(server_->ctx_)
+        {
+        }
+
+        void start()
+        {
+            asio::error_code ec{};
+            socket_.set_option(asio::ip::tcp::no_delay{ true }, ec);
+            do_read_headers();
+        }
+
+        void close()
+        {
+            asio::error_code ec{};
+            timer_.cancel();
+            socket_.close(ec);
+        }
+
+      private:
+        void do_read_headers()
+        {
+            asio::async_read_until(
+              socket_, asio::dynamic_buffer(input_), "\r\n\r\n", [self = shared_from_this()](std::error_code ec, std::size_t headers_size) {
+                  if (ec) {
+                      return;
+                  }
+                  self->parse_headers(headers_size);
+              });
+        }
+
+        void parse_headers(std::size_t headers_size)
+        {
+            std::string headers = input_.substr(0, headers_size);
+            input_.erase(0, headers_size);
+
+            request_ = {};
+            auto method_end = headers.find(' ');
+            auto path_end = headers.find(' ', method_end + 1);
+            if (method_end == std::string::npos || path_end == std::string::npos) {
+                return close();
+            }
+            request_.method = headers.substr(0, method_end);
+            request_.path = headers.substr(method_end + 1, path_end - method_end - 1);
+
+            std::size_t content_length{ 0 };
+            std::transform(
+              headers.begin(), headers.end(), headers.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            static const std::string content_length_header{ "\r\ncontent-length:" };
+            if (auto header = headers.find(content_length_header); header != std::string::npos) {
+                content_length = std::stoul(headers.substr(header + content_length_header.size()));
+            }
+            if (input_.size() >= content_length) {
+                return handle_request(content_length);
+            }
+            asio::async_read(socket_,
+                             asio::dynamic_buffer(input_),
+                             asio::transfer_exactly(content_length - input_.size()),
+                             [self = shared_from_this(), content_length](std::error_code ec, std::size_t /* bytes */) {
+                                 if (ec) {
+                                     return;
+                                 }
+                                 self->handle_request(content_length);
+                             });
+        }
+
+        void handle_request(std::size_t content_length)
+        {
+            request_.body = input_.substr(0, content_length);
+            input_.erase(0, content_length);
+
+            auto options = server_->request_received(is_ping(request_));
+            if (request_.method == "GET") {
+                if (auto body = static_response_body(request_.path); body) {
+                    output_.emplace_back(fmt::format(
+                      "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: {}\r\n\r\n{}", body->size(), body.value()));
+                    return schedule_write(options.response_delay);
+                }
+            }
+            static const std::string search_prefix{ "/api/index/" };
+            static const std::string search_suffix{ "/query" };
+            std::optional<response_layout> layout{};
+            std::string index_name{};
+            std::size_t result_size = options.number_of_rows * options.row_size;
+            if (request_.method == "POST" && request_.path == "/query/service") {
+                layout = query_layout(request_, options.number_of_rows, result_size);
+            } else if (request_.method == "POST" && request_.path.rfind(search_prefix, 0) == 0 &&
+                       request_.path.size() > search_prefix.size() + search_suffix.size() &&
+                       request_.path.compare(request_.path.size() - search_suffix.size(), search_suffix.size(), search_suffix) == 0) {
+                index_name = request_.path.substr(search_prefix.size(), request_.path.size() - search_prefix.size() - search_suffix.size());
+                layout = search_layout(options.number_of_rows);
+            }
+
+            if (!layout) {
+                output_.emplace_back("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+                return schedule_write(std::chrono::milliseconds{ 0 });
+            }
+
+            output_.emplace_back("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nTransfer-Encoding: chunked\r\n\r\n" +
+                                 chunk(layout->prefix));
+            std::string rows{};
+            for (std::size_t index = 0; index < options.number_of_rows; ++index) {
+                if (index > 0) {
+                    rows.push_back(',');
+                }
+                rows.append(make_row(layout.value(), index_name, index, options.row_size));
+                if ((index + 1) % std::max<std::size_t>(options.rows_per_chunk, 1) == 0) {
+                    output_.emplace_back(chunk(rows));
+                    rows.clear();
+                }
+            }
+            output_.emplace_back(chunk(rows + layout->suffix) + chunk({}));
+            chunk_delay_ = options.chunk_delay;
+            schedule_write(options.response_delay);
+        }
+
+        void schedule_write(std::chrono::milliseconds delay)
+        {
+            if (delay.count() == 0) {
+                return do_write();
+            }
+            timer_.expires_after(delay);
+            timer_.async_wait([self = shared_from_this()](std::error_code ec) {
+                if (ec == asio::error::operation_aborted) {
+                    return;
+                }
+                self->do_write();
+            });
+        }
+
+        void do_write()
+        {
+            if (output_.empty()) {
+                // the response is complete, the client is free to send the next request on this connection
+                return do_read_headers();
+            }
+            writing_buffer_ = std::move(output_.front());
+            output_.pop_front();
+            asio::async_write(
+              socket_, asio::buffer(writing_buffer_), [self = shared_from_this()](std::error_code ec, std::size_t bytes_transferred) {
+                  if (ec) {
+                      return;
+                  }
+                  self->server_->bytes_sent(bytes_transferred);
+                  self->schedule_write(self->output_.empty() ? std::chrono::milliseconds{ 0 } : self->chunk_delay_);
+              });
+        }
+
+        std::shared_ptr<impl> server_;
+        asio::ip::tcp::socket socket_;
+        asio::steady_timer timer_;
+        std::string input_{};
+        http_request request_{};
+        std::deque<std::string> output_{};
+        std::string writing_buffer_{};
+        std::chrono::milliseconds chunk_delay_{ 0 };
+    };
+
+    void do_accept()
+    {
+        acceptor_.async_accept([self = shared_from_this()](std::error_code ec, asio::ip::tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            {
+                std::scoped_lock lock(self->mutex_);
+                ++self->stats_.connections;
+            }
+            auto conn = std::make_shared<connection>(self, std::move(socket));
+            self->connections_.emplace_back(conn);
+            conn->start();
+            self->do_accept();
+        });
+    }
+
+    mock_http_server::response_options request_received(bool ping)
+    {
+        std::scoped_lock lock(mutex_);
+        ++stats_.requests;
+        if (ping) {
+            ++stats_.pings;
+        }
+        return options_;
+    }
+
+    void bytes_sent(std::size_t bytes)
+    {
+        std::scoped_lock lock(mutex_);
+        stats_.bytes_sent += bytes;
+    }
+
+    asio::io_context ctx_{};
+    asio::executor_work_guard<asio::io_context::executor_type> guard_{ asio::make_work_guard(ctx_) };
+    asio::ip::tcp::acceptor acceptor_{ ctx_, asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0) };
+    std::uint16_t port_{ acceptor_.local_endpoint().port() };
+    std::vector<std::weak_ptr<connection>> connections_{};
+    std::thread io_thread_{};
+
+    // the requests are served on the IO thread, but the tests change the responses and read statistics from their own threads
+    mutable std::mutex mutex_{};
+    mock_http_server::response_options options_;
+    mock_http_server::stats stats_{};
+};
+
+mock_http_server::mock_http_server()
+  : mock_http_server(response_options{})
+{
+}
+
+mock_http_server::mock_http_server(response_options options)
+  : impl_(std::make_shared<impl>(options))
+{
+    impl_->start();
+}
+
+mock_http_server::~mock_http_server()
+{
+    impl_->stop();
+}
+
+std::uint16_t
+mock_http_server::port() const
+{
+    return impl_->port();
+}
+
+std::map<std::string, std::uint16_t>
+mock_http_server::services() const
+{
+    return {
+        { "n1ql", impl_->port() },
+        { "cbas", impl_->port() },
+        { "fts", impl_->port() },
+    };
+}
+
+void
+mock_http_server::set_response_options(response_options options)
+{
+    impl_->set_response_options(options);
+}
+
+mock_http_server::stats
+mock_http_server::statistics() const
+{
+    return impl_->statistics();
+}
+
+void
+mock_http_server::stop()
+{
+    impl_->stop();
+}
+} // namespace test::utils
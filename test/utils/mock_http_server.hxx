@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace test::utils
+{
+/**
+ * Stand-in for the query, analytics and search services, which listens on the loopback interface and runs on its own
+ * thread.
+ *
+ * Answers "POST /query/service" (query and analytics use the same endpoint on their own ports) and
+ * "POST /api/index/{name}/query" with canned successful responses, which are streamed with chunked encoding. The pings
+ * ("GET /admin/ping" and "GET /api/ping") and "GET /api/index" get short responses after the same response delay.
+ * Everything else gets "404 Not Found". The connections are kept alive, so the pooling of the HTTP sessions is observable in the
+ * statistics.
+ */
+class mock_http_server
+{
+  public:
+    struct response_options {
+        std::size_t number_of_rows{ 100 };
+        /** approximate size of every row in bytes */
+        std::size_t row_size{ 128 };
+        std::size_t rows_per_chunk{ 16 };
+        /** delay before the response headers */
+        std::chrono::milliseconds response_delay{ 0 };
+        /** delay before every chunk of rows */
+        std::chrono::milliseconds chunk_delay{ 0 };
+    };
+
+    struct stats {
+        std::size_t connections{};
+        std::size_t requests{};
+        /** included in requests */
+        std::size_t pings{};
+        std::size_t bytes_sent{};
+    };
+
+    mock_http_server();
+    explicit mock_http_server(response_options options);
+    mock_http_server(const mock_http_server&) = delete;
+    mock_http_server& operator=(const mock_http_server&) = delete;
+    ~mock_http_server();
+
+    [[nodiscard]] std::uint16_t port() const;
+
+    /**
+     * Services of the cluster node to announce in the configuration, e.g. as mock_mcbp_server::options::services.
+     */
+    [[nodiscard]] std::map<std::string, std::uint16_t> services() const;
+
+    /**
+     * Applies to the requests received after the call.
+     */
+    void set_response_options(response_options options);
+
+    [[nodiscard]] stats statistics() const;
+
+    /**
+     * Closes all connections and the listening socket, and joins the IO thread.
+     */
+    void stop();
+
+  private:
+    class impl;
+    std::shared_ptr<impl> impl_;
+};
+} // namespace test::utils
@@ -0,0 +1,947 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#include "mock_mcbp_server.hxx"
+
+#include "core/protocol/hello_feature.hxx"
+#include "core/utils/connection_string.hxx"
+#include "core/utils/join_strings.hxx"
+
+#include <asio.hpp>
+#include <fmt/core.h>
+#include <tao/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace test::utils
+{
+namespace
+{
+using couchbase::key_value_status_code;
+using couchbase::core::protocol::client_opcode;
+using couchbase::core::protocol::hello_feature;
+using couchbase::core::protocol::subdoc_opcode;
+
+constexpr std::size_t header_size{ 24 };
+constexpr std::uint8_t magic_alt_client_request{ 0x08 };
+constexpr std::uint8_t magic_client_response{ 0x81 };
+constexpr std::uint8_t datatype_json{ 0x01 };
+
+constexpr std::uint8_t subdoc_doc_flag_mkdoc{ 0x01 };
+constexpr std::uint8_t subdoc_doc_flag_add{ 0x02 };
+constexpr std::uint8_t subdoc_path_flag_create_parents{ 0x01 };
+constexpr std::uint8_t subdoc_path_flag_xattr{ 0x04 };
+
+// features acknowledged in HELLO, if the client asks for them
+constexpr std::array supported_features{
+    hello_feature::tcp_nodelay, hello_feature::mutation_seqno, hello_feature::xerror,
+    hello_feature::select_bucket, hello_feature::json, hello_feature::unordered_execution,
+};
+
+std::uint16_t
+read_uint16(const std::uint8_t* ptr)
+{
+    return static_cast<std::uint16_t>((ptr[0] << 8U) | ptr[1]);
+}
+
+std::uint32_t
+read_uint32(const std::uint8_t* ptr)
+{
+    return (static_cast<std::uint32_t>(read_uint16(ptr)) << 16U) | read_uint16(ptr + 2);
+}
+
+std::uint64_t
+read_uint64(const std::uint8_t* ptr)
+{
+    return (static_cast<std::uint64_t>(read_uint32(ptr)) << 32U) | read_uint32(ptr + 4);
+}
+
+template<typename Integer>
+void
+append_integer(std::string& out, Integer value)
+{
+    for (std::size_t i = sizeof(Integer); i > 0; --i) {
+        out.push_back(static_cast<char>((value >> ((i - 1) * 8U)) & 0xffU));
+    }
+}
+
+template<typename Integer>
+void
+append_integer(std::vector<std::uint8_t>& out, Integer value)
+{
+    for (std::size_t i = sizeof(Integer); i > 0; --i) {
+        out.push_back(static_cast<std::uint8_t>((value >> ((i - 1) * 8U)) & 0xffU));
+    }
+}
+
+struct request {
+    std::uint8_t opcode{};
+    std::uint8_t datatype{};
+    std::uint16_t vbucket{};
+    std::array<std::uint8_t, 4> opaque{};
+    std::uint64_t cas{};
+    std::string extras{};
+    std::string key{};
+    std::string value{};
+};
+
+struct response {
+    key_value_status_code status{ key_value_status_code::success };
+    std::uint8_t datatype{};
+    std::uint64_t cas{};
+    std::string extras{};
+    std::string value{};
+};
+
+struct document {
+    std::string value{};
+    std::uint32_t flags{};
+    std::uint8_t datatype{};
+    std::uint64_t cas{};
+};
+
+// mutations of the vbucket, which are not persisted and replicated yet
+struct partition_state {
+    std::uint64_t current_seqno{ 0 };
+    std::uint64_t persisted_seqno{ 0 };
+    std::deque<std::pair<std::uint64_t, std::chrono::steady_clock::time_point>> pending{};
+};
+
+// per-connection state of the handshake
+struct connection_state {
+    bool authenticated{ false };
+    std::optional<std::string> bucket{};
+    bool mutation_seqno{ false };
+};
+
+std::vector<std::string>
+split_path(const std::string& path)
+{
+    std::vector<std::string> components{};
+    std::size_t start = 0;
+    while (true) {
+        auto end = path.find('.', start);
+        components.emplace_back(path.substr(start, end - start));
+        if (end == std::string::npos) {
+            return components;
+        }
+        start = end + 1;
+    }
+}
+
+tao::json::value*
+find_path(tao::json::value& root, const std::vector<std::string>& components)
+{
+    tao::json::value* current = &root;
+    for (const auto& component : components) {
+        if (!current->is_object()) {
+            return nullptr;
+        }
+        current = current->find(component);
+        if (current == nullptr) {
+            return nullptr;
+        }
+    }
+    return current;
+}
+
+key_value_status_code
+lookup_path(tao::json::value& root, std::uint8_t opcode, const std::string& path, std::string& value)
+{
+    auto* entry = find_path(root, split_path(path));
+    if (entry == nullptr) {
+        return key_value_status_code::subdoc_path_not_found;
+    }
+    switch (static_cast<subdoc_opcode>(opcode)) {
+        case subdoc_opcode::get:
+            value = tao::json::to_string(*entry);
+            return key_value_status_code::success;
+        case subdoc_opcode::exists:
+            return key_value_status_code::success;
+        case subdoc_opcode::get_count:
+            if (entry->is_array()) {
+                value = std::to_string(entry->get_array().size());
+            } else if (entry->is_object()) {
+                value = std::to_string(entry->get_object().size());
+            } else {
+                return key_value_status_code::subdoc_path_mismatch;
+            }
+            return key_value_status_code::success;
+        default:
+            break;
+    }
+    return key_value_status_code::subdoc_invalid_combo;
+}
+
+key_value_status_code
+mutate_path(tao::json::value& root, std::uint8_t opcode, std::uint8_t flags, const std::string& path, const std::string& value)
+{
+    auto components = split_path(path);
+    auto field = components.back();
+    components.pop_back();
+
+    tao::json::value* parent = &root;
+    for (const auto& component : components) {
+        if (!parent->is_object()) {
+            return key_value_status_code::subdoc_path_mismatch;
+        }
+        auto* next = parent->find(component);
+        if (next == nullptr) {
+            if ((flags & subdoc_path_flag_create_parents) == 0) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            next = &parent->get_object().try_emplace(component, tao::json::empty_object).first->second;
+        }
+        parent = next;
+    }
+    if (!parent->is_object()) {
+        return key_value_status_code::subdoc_path_mismatch;
+    }
+    auto* existing = parent->find(field);
+
+    auto opcode_value = static_cast<subdoc_opcode>(opcode);
+    if (opcode_value == subdoc_opcode::remove) {
+        if (existing == nullptr) {
+            return key_value_status_code::subdoc_path_not_found;
+        }
+        parent->get_object().erase(field);
+        return key_value_status_code::success;
+    }
+
+    tao::json::value parsed{};
+    try {
+        parsed = tao::json::from_string(value);
+    } catch (const tao::pegtl::parse_error&) {
+        return key_value_status_code::subdoc_value_cannot_insert;
+    }
+    switch (opcode_value) {
+        case subdoc_opcode::dict_add:
+            if (existing != nullptr) {
+                return key_value_status_code::subdoc_path_exists;
+            }
+            break;
+        case subdoc_opcode::replace:
+            if (existing == nullptr) {
+                return key_value_status_code::subdoc_path_not_found;
+            }
+            break;
+        case subdoc_opcode::dict_upsert:
+            break;
+        default:
+            return key_value_status_code::subdoc_invalid_combo;
+    }
+    parent->get_object()[field] = std::move(parsed);
+    return key_value_status_code::success;
+}
+} // namespace
+
+class mock_mcbp_server::impl : public std::enable_shared_from_this<mock_mcbp_server::impl>
+{
+  public:
+    explicit impl(mock_mcbp_server::options opts)
+      : options_(std::move(opts))
+    {
+    }
+
+    void start()
+    {
+        for (std::size_t node_index = 0; node_index < options_.number_of_nodes; ++node_index) {
+            auto& acceptor = acceptors_.emplace_back(ctx_, asio::ip::tcp::endpoint(asio::ip::make_address("127.0.0.1"), 0));
+            ports_.push_back(acceptor.local_endpoint().port());
+        }
+        for (std::size_t node_index = 0; node_index < acceptors_.size(); ++node_index) {
+            do_accept(node_index);
+        }
+        io_thread_ = std::thread([self = shared_from_this()]() { self->ctx_.run(); });
+    }
+
+    void stop()
+    {
+        if (!io_thread_.joinable()) {
+            return;
+        }
+        asio::post(ctx_, [self = shared_from_this()]() {
+            for (auto& acceptor : self->acceptors_) {
+                asio::error_code ec{};
+                acceptor.close(ec);
+            }
+            for (const auto& weak_connection : self->connections_) {
+                if (auto conn = weak_connection.lock(); conn) {
+                    conn->close();
+                }
+            }
+            self->connections_.clear();
+        });
+        guard_.reset();
+        io_thread_.join();
+    }
+
+    [[nodiscard]] const mock_mcbp_server::options& server_options() const
+    {
+        return options_;
+    }
+
+    [[nodiscard]] const std::vector<std::uint16_t>& ports() const
+    {
+        return ports_;
+    }
+
+    void inject_error(client_opcode opcode, key_value_status_code status, std::size_t count)
+    {
+        std::scoped_lock lock(mutex_);
+        injected_errors_[static_cast<std::uint8_t>(opcode)] = { status, count };
+    }
+
+    void inject_delay(client_opcode opcode, std::chrono::milliseconds delay)
+    {
+        std::scoped_lock lock(mutex_);
+        if (delay.count() == 0) {
+            injected_delays_.erase(static_cast<std::uint8_t>(opcode));
+        } else {
+            injected_delays_[static_cast<std::uint8_t>(opcode)] = delay;
+        }
+    }
+
+    [[nodiscard]] std::size_t requests_received(client_opcode opcode) const
+    {
+        std::scoped_lock lock(mutex_);
+        if (auto it = requests_received_.find(static_cast<std::uint8_t>(opcode)); it != requests_received_.end()) {
+            return it->second;
+        }
+        return 0;
+    }
+
+  private:
+    class connection : public std::enable_shared_from_this<connection>
+    {
+      public:
+        connection(std::shared_ptr<impl> server, std::size_t node_index, asio::ip::tcp::socket socket)
+          : server_(std::move(server))
+          , node_index_(node_index)
+          , socket_(std::move(socket))
+        {
+        }
+
+        void start()
+        {
+            asio::error_code ec{};
+            socket_.set_option(asio::ip::tcp::no_delay{ true }, ec);
+            do_read_header();
+        }
+
+        void close()
+        {
+            asio::error_code ec{};
+            socket_.close(ec);
+        }
+
+      private:
+        void do_read_header()
+        {
+            asio::async_read(socket_, asio::buffer(header_), [self = shared_from_this()](std::error_code ec, std::size_t /* bytes */) {
+                if (ec) {
+                    return;
+                }
+                self->body_.resize(read_uint32(self->header_.data() + 8));
+                if (self->body_.empty()) {
+                    self->dispatch();
+                    return self->do_read_header();
+                }
+                self->do_read_body();
+            });
+        }
+
+        void do_read_body()
+        {
+            asio::async_read(socket_, asio::buffer(body_), [self = shared_from_this()](std::error_code ec, std::size_t /* bytes */) {
+                if (ec) {
+                    return;
+                }
+                self->dispatch();
+                self->do_read_header();
+            });
+        }
+
+        void dispatch()
+        {
+            request req{};
+            req.opcode = header_[1];
+            std::size_t framing_extras_size{ 0 };
+            std::size_t key_size{ read_uint16(header_.data() + 2) };
+            if (header_[0] == magic_alt_client_request) {
+                framing_extras_size = header_[2];
+                key_size = header_[3];
+            }
+            std::size_t extras_size = header_[4];
+            req.datatype = header_[5];
+            req.vbucket = read_uint16(header_.data() + 6);
+            std::copy_n(header_.begin() + 12, req.opaque.size(), req.opaque.begin());
+            req.cas = read_uint64(header_.data() + 16);
+            if (framing_extras_size + extras_size + key_size > body_.size()) {
+                return close();
+            }
+            const auto* body = reinterpret_cast<const char*>(body_.data()) + framing_extras_size;
+            req.extras.assign(body, extras_size);
+            req.key.assign(body + extras_size, key_size);
+            req.value.assign(body + extras_size + key_size, body_.size() - framing_extras_size - extras_size - key_size);
+
+            auto [resp, delay] = server_->execute(node_index_, state_, req);
+            if (delay.count() == 0) {
+                return write(req, resp);
+            }
+            auto timer = std::make_shared<asio::steady_timer>(server_->ctx_, delay);
+            timer->async_wait([self = shared_from_this(), timer, req = std::move(req), resp = std::move(resp)](std::error_code ec) {
+                if (ec == asio::error::operation_aborted) {
+                    return;
+                }
+                self->write(req, resp);
+            });
+        }
+
+        void write(const request& req, const response& resp)
+        {
+            output_.push_back(magic_client_response);
+            output_.push_back(req.opcode);
+            append_integer(output_, std::uint16_t{ 0 }); // key length
+            output_.push_back(static_cast<std::uint8_t>(resp.extras.size()));
+            output_.push_back(resp.datatype);
+            append_integer(output_, static_cast<std::uint16_t>(resp.status));
+            append_integer(output_, static_cast<std::uint32_t>(resp.extras.size() + resp.value.size()));
+            output_.insert(output_.end(), req.opaque.begin(), req.opaque.end());
+            append_integer(output_, resp.cas);
+            output_.insert(output_.end(), resp.extras.begin(), resp.extras.end());
+            output_.insert(output_.end(), resp.value.begin(), resp.value.end());
+            if (!writing_) {
+                do_write();
+            }
+        }
+
+        void do_write()
+        {
+            if (output_.empty()) {
+                return;
+            }
+            writing_ = true;
+            std::swap(writing_buffer_, output_);
+            output_.clear();
+            asio::async_write(
+              socket_, asio::buffer(writing_buffer_), [self = shared_from_this()](std::error_code ec, std::size_t /* bytes */) {
+                  self->writing_ = false;
+                  if (ec) {
+                      return;
+                  }
+                  self->do_write();
+              });
+        }
+
+        std::shared_ptr<impl> server_;
+        std::size_t node_index_;
+        asio::ip::tcp::socket socket_;
+        connection_state state_{};
+        std::array<std::uint8_t, header_size> header_{};
+        std::vector<std::uint8_t> body_{};
+        std::vector<std::uint8_t> output_{};
+        std::vector<std::uint8_t> writing_buffer_{};
+        bool writing_{ false };
+    };
+
+    void do_accept(std::size_t node_index)
+    {
+        acceptors_[node_index].async_accept([self = shared_from_this(), node_index](std::error_code ec, asio::ip::tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            auto conn = std::make_shared<connection>(self, node_index, std::move(socket));
+            self->connections_.emplace_back(conn);
+            conn->start();
+            self->do_accept(node_index);
+        });
+    }
+
+    std::pair<response, std::chrono::milliseconds> execute(std::size_t node_index, connection_state& state, const request& req)
+    {
+        std::scoped_lock lock(mutex_);
+        ++requests_received_[req.opcode];
+        std::chrono::milliseconds delay{ 0 };
+        if (auto it = injected_delays_.find(req.opcode); it != injected_delays_.end()) {
+            delay = it->second;
+        }
+        if (auto it = injected_errors_.find(req.opcode); it != injected_errors_.end() && it->second.second > 0) {
+            response resp{};
+            resp.status = it->second.first;
+            if (--it->second.second == 0) {
+                injected_errors_.erase(it);
+            }
+            return { resp, delay };
+        }
+        return { execute_locked(node_index, state, req), delay };
+    }
+
+    response execute_locked(std::size_t node_index, connection_state& state, const request& req)
+    {
+        response resp{};
+        switch (static_cast<client_opcode>(req.opcode)) {
+            case client_opcode::hello: {
+                const auto* features = reinterpret_cast<const std::uint8_t*>(req.value.data());
+                for (std::size_t offset = 0; offset + 1 < req.value.size(); offset += 2) {
+                    auto feature = static_cast<hello_feature>(read_uint16(features + offset));
+                    if (std::find(supported_features.begin(), supported_features.end(), feature) != supported_features.end()) {
+                        append_integer(resp.value, static_cast<std::uint16_t>(feature));
+                        if (feature == hello_feature::mutation_seqno) {
+                            state.mutation_seqno = true;
+                        }
+                    }
+                }
+                return resp;
+            }
+
+            case client_opcode::get_error_map:
+                resp.datatype = datatype_json;
+                resp.value = R"({"version":2,"revision":1,"errors":{}})";
+                return resp;
+
+            case client_opcode::sasl_list_mechs:
+                resp.value = "PLAIN";
+                return resp;
+
+            case client_opcode::sasl_auth:
+                // PLAIN payload is "authzid\0username\0password"
+                if (req.key != "PLAIN" || req.value != std::string(1, '\0') + options_.username + '\0' + options_.password) {
+                    resp.status = key_value_status_code::auth_error;
+                    return resp;
+                }
+                state.authenticated = true;
+                return resp;
+
+            case client_opcode::select_bucket:
+                if (!state.authenticated || req.key != options_.bucket_name) {
+                    resp.status = key_value_status_code::no_access;
+                    return resp;
+                }
+                state.bucket = req.key;
+                return resp;
+
+            case client_opcode::get_cluster_config:
+                if (!state.authenticated) {
+                    resp.status = key_value_status_code::no_access;
+                    return resp;
+                }
+                resp.datatype = datatype_json;
+                resp.value = configuration(node_index, state.bucket.has_value());
+                return resp;
+
+            case client_opcode::noop:
+                return resp;
+
+            default:
+                break;
+        }
+
+        if (!state.bucket) {
+            resp.status = key_value_status_code::no_bucket;
+            return resp;
+        }
+        switch (static_cast<client_opcode>(req.opcode)) {
+            case client_opcode::get:
+                return get(req);
+            case client_opcode::upsert:
+            case client_opcode::insert:
+            case client_opcode::replace:
+                return store(state, req);
+            case client_opcode::remove:
+                return remove(state, req);
+            case client_opcode::subdoc_multi_lookup:
+                return lookup_in(req);
+            case client_opcode::subdoc_multi_mutation:
+                return mutate_in(state, req);
+            case client_opcode::observe_seqno:
+                return observe_seqno(node_index, req);
+            default:
+                break;
+        }
+        resp.status = key_value_status_code::unknown_command;
+        return resp;
+    }
+
+    response get(const request& req)
+    {
+        response resp{};
+        auto it = documents_.find(req.key);
+        if (it == documents_.end()) {
+            resp.status = key_value_status_code::not_found;
+            return resp;
+        }
+        append_integer(resp.extras, it->second.flags);
+        resp.value = it->second.value;
+        resp.datatype = it->second.datatype;
+        resp.cas = it->second.cas;
+        return resp;
+    }
+
+    response store(const connection_state& state, const request& req)
+    {
+        response resp{};
+        auto opcode = static_cast<client_opcode>(req.opcode);
+        auto it = documents_.find(req.key);
+        if (it == documents_.end()) {
+            if (opcode == client_opcode::replace || req.cas != 0) {
+                resp.status = key_value_status_code::not_found;
+                return resp;
+            }
+        } else if (opcode == client_opcode::insert || (req.cas != 0 && req.cas != it->second.cas)) {
+            resp.status = key_value_status_code::exists;
+            return resp;
+        }
+        document doc{};
+        doc.value = req.value;
+        doc.datatype = req.datatype;
+        if (req.extras.size() >= 4) {
+            doc.flags = read_uint32(reinterpret_cast<const std::uint8_t*>(req.extras.data()));
+        }
+        doc.cas = ++last_cas_;
+        documents_[req.key] = std::move(doc);
+        return mutated(state, req, last_cas_);
+    }
+
+    response remove(const connection_state& state, const request& req)
+    {
+        auto it = documents_.find(req.key);
+        if (it == documents_.end()) {
+            response resp{};
+            resp.status = key_value_status_code::not_found;
+            return resp;
+        }
+        if (req.cas != 0 && req.cas != it->second.cas) {
+            response resp{};
+            resp.status = key_value_status_code::exists;
+            return resp;
+        }
+        documents_.erase(it);
+        return mutated(state, req, ++last_cas_);
+    }
+
+    response lookup_in(const request& req)
+    {
+        response resp{};
+        auto it = documents_.find(req.key);
+        if (it == documents_.end()) {
+            resp.status = key_value_status_code::not_found;
+            return resp;
+        }
+        resp.cas = it->second.cas;
+
+        std::optional<tao::json::value> root{};
+        try {
+            root = tao::json::from_string(it->second.value);
+        } catch (const tao::pegtl::parse_error&) {
+            // only full document reads are possible
+        }
+
+        const auto* specs = reinterpret_cast<const std::uint8_t*>(req.value.data());
+        std::size_t offset = 0;
+        while (offset + 4 <= req.value.size()) {
+            auto opcode = specs[offset];
+            auto flags = specs[offset + 1];
+            std::size_t path_size = read_uint16(specs + offset + 2);
+            std::string path = req.value.substr(offset + 4, path_size);
+            offset += 4 + path_size;
+
+            auto status = key_value_status_code::success;
+            std::string value{};
+            if ((flags & subdoc_path_flag_xattr) != 0) {
+                status = key_value_status_code::subdoc_path_not_found;
+            } else if (static_cast<subdoc_opcode>(opcode) == subdoc_opcode::get_doc) {
+                value = it->second.value;
+            } else if (!root) {
+                status = key_value_status_code::subdoc_doc_not_json;
+            } else {
+                status = lookup_path(root.value(), opcode, path, value);
+            }
+            if (status != key_value_status_code::success) {
+                resp.status = key_value_status_code::subdoc_multi_path_failure;
+            }
+            append_integer(resp.value, static_cast<std::uint16_t>(status));
+            append_integer(resp.value, static_cast<std::uint32_t>(value.size()));
+            resp.value.append(value);
+        }
+        return resp;
+    }
+
+    response mutate_in(const connection_state& state, const request& req)
+    {
+        response resp{};
+        std::uint8_t doc_flags{ 0 };
+        if (req.extras.size() == 1 || req.extras.size() == 5) {
+            doc_flags = static_cast<std::uint8_t>(req.extras.back());
+        }
+
+        document doc{};
+        doc.datatype = datatype_json;
+        bool remove_document{ false };
+        if (auto it = documents_.find(req.key); it != documents_.end()) {
+            if ((doc_flags & subdoc_doc_flag_add) != 0 || (req.cas != 0 && req.cas != it->second.cas)) {
+                resp.status = key_value_status_code::exists;
+                return resp;
+            }
+            doc = it->second;
+        } else if ((doc_flags & (subdoc_doc_flag_mkdoc | subdoc_doc_flag_add)) == 0) {
+            resp.status = key_value_status_code::not_found;
+            return resp;
+        } else {
+            doc.value = "{}";
+        }
+
+        std::optional<tao::json::value> root{};
+        try {
+            root = tao::json::from_string(doc.value);
+        } catch (const tao::pegtl::parse_error&) {
+            // only full document writes are possible
+        }
+
+        const auto* specs = reinterpret_cast<const std::uint8_t*>(req.value.data());
+        std::size_t offset = 0;
+        std::uint8_t index = 0;
+        while (offset + 8 <= req.value.size()) {
+            auto opcode = specs[offset];
+            auto flags = specs[offset + 1];
+            std::size_t path_size = read_uint16(specs + offset + 2);
+            std::size_t value_size = read_uint32(specs + offset + 4);
+            std::string path = req.value.substr(offset + 8, path_size);
+            std::string value = req.value.substr(offset + 8 + path_size, value_size);
+            offset += 8 + path_size + value_size;
+
+            auto status = key_value_status_code::success;
+            if ((flags & subdoc_path_flag_xattr) != 0) {
+                status = key_value_status_code::subdoc_xattr_invalid_key_combo;
+            } else if (static_cast<subdoc_opcode>(opcode) == subdoc_opcode::set_doc) {
+                try {
+                    root = tao::json::from_string(value);
+                } catch (const tao::pegtl::parse_error&) {
+                    root.reset();
+                    doc.value = value;
+                    doc.datatype = 0;
+                }
+            } else if (static_cast<subdoc_opcode>(opcode) == subdoc_opcode::remove_doc) {
+                remove_document = true;
+            } else if (!root) {
+                status = key_value_status_code::subdoc_doc_not_json;
+            } else {
+                status = mutate_path(root.value(), opcode, flags, path, value);
+            }
+            if (status != key_value_status_code::success) {
+                resp.status = key_value_status_code::subdoc_multi_path_failure;
+                resp.value.push_back(static_cast<char>(index));
+                append_integer(resp.value, static_cast<std::uint16_t>(status));
+                return resp;
+            }
+            ++index;
+        }
+
+        if (remove_document) {
+            documents_.erase(req.key);
+            return mutated(state, req, ++last_cas_);
+        }
+        if (root) {
+            doc.value = tao::json::to_string(root.value());
+        }
+        doc.cas = ++last_cas_;
+        documents_[req.key] = std::move(doc);
+        return mutated(state, req, last_cas_);
+    }
+
+    response mutated(const connection_state& state, const request& req, std::uint64_t cas)
+    {
+        response resp{};
+        resp.cas = cas;
+        auto seqno = ++last_seqno_;
+        auto& partition = partitions_[req.vbucket];
+        partition.current_seqno = seqno;
+        partition.pending.emplace_back(seqno, std::chrono::steady_clock::now() + options_.persistence_delay);
+        if (state.mutation_seqno) {
+            append_integer(resp.extras, partition_uuid(req.vbucket));
+            append_integer(resp.extras, seqno);
+        }
+        return resp;
+    }
+
+    response observe_seqno(std::size_t node_index, const request& req)
+    {
+        response resp{};
+        auto& partition = partitions_[req.vbucket];
+        auto now = std::chrono::steady_clock::now();
+        while (!partition.pending.empty() && partition.pending.front().second <= now) {
+            partition.persisted_seqno = partition.pending.front().first;
+            partition.pending.pop_front();
+        }
+        bool active = node_index == req.vbucket % ports_.size();
+        resp.value.push_back('\0'); // no failover
+        append_integer(resp.value, req.vbucket);
+        append_integer(resp.value, partition_uuid(req.vbucket));
+        append_integer(resp.value, partition.persisted_seqno);
+        append_integer(resp.value, active ? partition.current_seqno : partition.persisted_seqno);
+        return resp;
+    }
+
+    static std::uint64_t partition_uuid(std::uint16_t vbucket)
+    {
+        return 0xc0ffee0000000000ULL | vbucket;
+    }
+
+    [[nodiscard]] std::string configuration(std::size_t this_node, bool with_bucket) const
+    {
+        tao::json::value nodes_ext = tao::json::empty_array;
+        tao::json::value server_list = tao::json::empty_array;
+        for (std::size_t node_index = 0; node_index < ports_.size(); ++node_index) {
+            tao::json::value services = { { "kv", ports_[node_index] } };
+            for (const auto& [service, port] : options_.services) {
+                services[service] = port;
+            }
+            tao::json::value node = {
+                { "hostname", "127.0.0.1" },
+                { "services", services },
+            };
+            if (node_index == this_node) {
+                node["thisNode"] = true;
+            }
+            nodes_ext.get_array().emplace_back(std::move(node));
+            server_list.get_array().emplace_back(fmt::format("127.0.0.1:{}", ports_[node_index]));
+        }
+        tao::json::value config = {
+            { "rev", 1 },
+            { "nodesExt", nodes_ext },
+        };
+        if (with_bucket) {
+            tao::json::value vbucket_map = tao::json::empty_array;
+            for (std::size_t vbucket = 0; vbucket < options_.number_of_vbuckets; ++vbucket) {
+                tao::json::value nodes = tao::json::empty_array;
+                for (std::size_t copy = 0; copy <= options_.number_of_replicas; ++copy) {
+                    nodes.get_array().emplace_back(static_cast<std::int64_t>((vbucket + copy) % ports_.size()));
+                }
+                vbucket_map.get_array().emplace_back(std::move(nodes));
+            }
+            config["name"] = options_.bucket_name;
+            config["uuid"] = "0123456789abcdef0123456789abcdef";
+            config["nodeLocator"] = "vbucket";
+            config["bucketCapabilities"] = tao::json::value::array({ "cccp", "nodesExt" });
+            config["vBucketServerMap"] = {
+                { "hashAlgorithm", "CRC" },
+                { "numReplicas", options_.number_of_replicas },
+                { "serverList", server_list },
+                { "vBucketMap", vbucket_map },
+            };
+        }
+        return tao::json::to_string(config);
+    }
+
+    mock_mcbp_server::options options_;
+    asio::io_context ctx_{};
+    asio::executor_work_guard<asio::io_context::executor_type> guard_{ asio::make_work_guard(ctx_) };
+    std::vector<asio::ip::tcp::acceptor> acceptors_{};
+    std::vector<std::uint16_t> ports_{};
+    std::vector<std::weak_ptr<connection>> connections_{};
+    std::thread io_thread_{};
+
+    // the requests are executed on the IO thread, but the tests inject errors and read counters from their own threads
+    mutable std::mutex mutex_{};
+    std::map<std::string, document> documents_{};
+    std::uint64_t last_cas_{ 0 };
+    std::uint64_t last_seqno_{ 0 };
+    std::map<std::uint16_t, partition_state> partitions_{};
+    std::map<std::uint8_t, std::pair<key_value_status_code, std::size_t>> injected_errors_{};
+    std::map<std::uint8_t, std::chrono::milliseconds> injected_delays_{};
+    std::map<std::uint8_t, std::size_t> requests_received_{};
+};
+
+mock_mcbp_server::mock_mcbp_server()
+  : mock_mcbp_server(options{})
+{
+}
+
+mock_mcbp_server::mock_mcbp_server(options opts)
+  : impl_(std::make_shared<impl>(std::move(opts)))
+{
+    impl_->start();
+}
+
+mock_mcbp_server::~mock_mcbp_server()
+{
+    impl_->stop();
+}
+
+const mock_mcbp_server::options&
+mock_mcbp_server::server_options() const
+{
+    return impl_->server_options();
+}
+
+std::vector<std::uint16_t>
+mock_mcbp_server::ports() const
+{
+    return impl_->ports();
+}
+
+std::string
+mock_mcbp_server::connection_string() const
+{
+    std::vector<std::string> nodes{};
+    for (const auto port : impl_->ports()) {
+        nodes.emplace_back(fmt::format("127.0.0.1:{}=mcd", port));
+    }
+    return fmt::format("couchbase://{}", couchbase::core::utils::join_strings(nodes, ","));
+}
+
+couchbase::core::origin
+mock_mcbp_server::origin() const
+{
+    couchbase::core::cluster_credentials credentials{};
+    credentials.username = impl_->server_options().username;
+    credentials.password = impl_->server_options().password;
+    credentials.allowed_sasl_mechanisms = { { "PLAIN" } };
+    return couchbase::core::origin{ credentials, couchbase::core::utils::parse_connection_string(connection_string()) };
+}
+
+void
+mock_mcbp_server::inject_error(couchbase::core::protocol::client_opcode opcode, couchbase::key_value_status_code status, std::size_t count)
+{
+    impl_->inject_error(opcode, status, count);
+}
+
+void
+mock_mcbp_server::inject_delay(couchbase::core::protocol::client_opcode opcode, std::chrono::milliseconds delay)
+{
+    impl_->inject_delay(opcode, delay);
+}
+
+std::size_t
+mock_mcbp_server::requests_received(couchbase::core::protocol::client_opcode opcode) const
+{
+    return impl_->requests_received(opcode);
+}
+
+void
+mock_mcbp_server::stop()
+{
+    impl_->stop();
+}
+} // namespace test::utils
@@ -0,0 +1,107 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *   Copyright 2023 Couchbase, Inc.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+#pragma once
+
+#include "core/origin.hxx"
+#include "core/protocol/client_opcode.hxx"
+
+#include <couchbase/key_value_status_code.hxx>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace test::utils
+{
+/**
+ * Stand-in for the KV service of a Couchbase cluster, which listens on the loopback interface and runs on its own thread.
+ *
+ * Every node of the synthetic cluster has its own port, and all of them share the same document store, so the requests
+ * never fail with "not my vbucket". Only the subset of the protocol needed to bootstrap core::cluster and run basic
+ * operations on the default collection is implemented: HELLO, GET_ERROR_MAP, SASL PLAIN, SELECT_BUCKET, GET_CLUSTER_CONFIG,
+ * NOOP, GET, UPSERT, INSERT, REPLACE, REMOVE, OBSERVE_SEQNO, and subdocument lookups and mutations of simple dotted paths.
+ * Everything else is answered with "unknown command".
+ *
+ * The replicas of every vbucket live on the nodes following the active one. A mutation becomes persisted on all nodes and
+ * visible on the replicas once options::persistence_delay has passed, which is what OBSERVE_SEQNO reports.
+ */
+class mock_mcbp_server
+{
+  public:
+    struct options {
+        std::size_t number_of_nodes{ 3 };
+        std::string bucket_name{ "default" };
+        std::string username{ "Administrator" };
+        std::string password{ "password" };
+        std::size_t number_of_vbuckets{ 64 };
+        /** must be less than number_of_nodes */
+        std::size_t number_of_replicas{ 0 };
+        /** time until a mutation is persisted and replicated */
+        std::chrono::milliseconds persistence_delay{ 0 };
+        /** other services of every node, announced in the configuration, e.g. { "n1ql", 8093 } */
+        std::map<std::string, std::uint16_t> services{};
+    };
+
+    mock_mcbp_server();
+    explicit mock_mcbp_server(options opts);
+    mock_mcbp_server(const mock_mcbp_server&) = delete;
+    mock_mcbp_server& operator=(const mock_mcbp_server&) = delete;
+    ~mock_mcbp_server();
+
+    [[nodiscard]] const options& server_options() const;
+
+    [[nodiscard]] std::vector<std::uint16_t> ports() const;
+
+    /**
+     * Connection string listing every node of the synthetic cluster, with KV bootstrap.
+     */
+    [[nodiscard]] std::string connection_string() const;
+
+    /**
+     * Origin with the credentials of the server, only PLAIN authentication is allowed.
+     */
+    [[nodiscard]] couchbase::core::origin origin() const;
+
+    /**
+     * Answers next @p count requests with @p opcode with @p status instead of executing them.
+     */
+    void inject_error(couchbase::core::protocol::client_opcode opcode, couchbase::key_value_status_code status, std::size_t count = 1);
+
+    /**
+     * Delays responses to all requests with @p opcode. Zero delay removes the rule.
+     */
+    void inject_delay(couchbase::core::protocol::client_opcode opcode, std::chrono::milliseconds delay);
+
+    /**
+     * Number of requests with @p opcode received by all nodes.
+     */
+    [[nodiscard]] std::size_t requests_received(couchbase::core::protocol::client_opcode opcode) const;
+
+    /**
+     * Closes all connections and listening sockets, and joins the IO thread.
+     */
+    void stop();
+
+  private:
+    class impl;
+    std::shared_ptr<impl> impl_;
+};
+} // namespace test::utils